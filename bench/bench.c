@@ -0,0 +1,60 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      bench.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include "bench.h"
+#include <stdio.h>
+#include <time.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+volatile uint64_t bench_sink = 0;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t 
+bench_now( void ){
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+bench_report( const char * name, const char * label, const uint64_t iterations, const uint64_t ns, const uint64_t bytes ){
+  double per_op = iterations ? (double) ns / (double) iterations : 0.0;
+  double rate = ns ? (double) bytes * (double) iterations * 1e9 / (double) ns : 0.0;
+  printf( "bench=%s case=%s iterations=%llu ns/op=%.2f bytes/s=%.0f\n", name, label, (unsigned long long) iterations, per_op, rate );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
@@ -0,0 +1,69 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      bench.h
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_BENCH_H
+#define E22900T22S_BENCH_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <stdint.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+extern volatile uint64_t bench_sink;        // Results are folded into it, so the compiler cannot drop the measured calls
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Reads the monotonic clock.
+ * 
+ * @return The time in nanoseconds.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t bench_now( void );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Prints one result as a single line of key=value pairs, so it can be collected and compared across releases: \n
+ *        bench=<name> case=<label> iterations=<n> ns/op=<ns> bytes/s=<rate>
+ *  
+ * @param[in] name The benchmark name.
+ * @param[in] label The case measured, e.g., the input file or the segment size.
+ * @param[in] iterations The number of operations timed.
+ * @param[in] ns The total time (ns).
+ * @param[in] bytes The bytes processed per operation, 0 if it does not apply.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void bench_report( const char * name, const char * label, const uint64_t iterations, const uint64_t ns, const uint64_t bytes );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
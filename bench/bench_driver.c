@@ -0,0 +1,366 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      bench_driver.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include "bench.h"
+#include <e22900t22s/core.h>
+#include <e22900t22s/metrics.h>
+#include <e22900t22s/mixip.h>
+#include <e22900t22s/crc.h>
+#include <e22900t22s/codec.h>
+#include <e22900t22s/fec.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define BENCH_BUFFER      65536             // Bytes scanned per `e22900t22s_identify_segments` call
+#define BENCH_SCANS       2000
+#define BENCH_CALLS       10000000          // Calls of the functions that take a few nanoseconds
+#define BENCH_IMAGES      2000000           // Register images packed and unpacked
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+// Internal to the driver, declared in e22900t22s.c
+uint8_t lookup_table_baudrate_2bin( const baudRate_t baud_code );
+baudRate_t lookup_table_baudrate_2code( const uint8_t baud_bin );
+baudRate_t lookup_table_baudrate_fromtext_2code( const char * baud_text );
+uint8_t lookup_table_parity_2bin( const parity_t parity_code );
+parity_t lookup_table_parity_2code( const uint8_t parity_bin );
+baudRate_t lookup_table_airrate_2code( const uint8_t baud_bin );
+const char * lookup_table_airrate_2text( const baudRate_t baud_code );
+e22900t22s_packet_size_t lookup_table_packet_fromtext( const char * size_text );
+e22900t22s_wor_cycle_t lookup_table_worcycle_fromtext( const char * cycle_text );
+void pack_registers( const e22900t22s_eeprom_t * cfg, uint8_t * reg );
+void unpack_registers( const uint8_t * reg, e22900t22s_eeprom_t * cfg );
+
+void bench_segments( const size_t segment );
+void bench_rssi( void );
+void bench_lookup( void );
+void bench_registers( void );
+void bench_crc( const size_t segment );
+void bench_codec( const size_t segment );
+void bench_fec( const size_t segment );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+bench_segments( const size_t segment ){
+  uint8_t * data = (uint8_t *) malloc( BENCH_BUFFER );
+  if( !data ){
+    perror("malloc");
+    return;
+  }
+
+  // Payload bytes are never 0, each segment is closed by a pair of limiters
+  for( size_t i = 0 ; i < BENCH_BUFFER ; ++i )
+    data[i] = (uint8_t) ( 1 + i % 251 );
+  for( size_t i = segment ; i + 1 < BENCH_BUFFER ; i += segment + 2 )
+    data[i] = data[i + 1] = 0x00;
+
+  e22900t22s_mixip_segments_t st;
+  memset( &st, 0, sizeof(st) );
+  e22900t22s_identify_segments( data, BENCH_BUFFER, &st );
+
+  uint64_t start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_SCANS ; ++i ){
+    st.count = 0;
+    e22900t22s_identify_segments( data, BENCH_BUFFER, &st );
+    bench_sink += st.length;
+  }
+  uint64_t ns = bench_now( ) - start;
+
+  char label[32];
+  snprintf( label, sizeof(label), "segment=%zu", segment );
+  bench_report( "identify_segments", label, BENCH_SCANS, ns, BENCH_BUFFER );
+
+  e22900t22s_free_segments( &st );
+  free( data );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+bench_rssi( void ){
+  float sum = 0;
+  uint64_t start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_CALLS ; ++i )
+    sum += e22900t22s_get_signal_rssi( (uint8_t) i );
+  uint64_t ns = bench_now( ) - start;
+  bench_sink += (uint64_t) -sum;
+  bench_report( "get_signal_rssi", "all", BENCH_CALLS, ns, 1 );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+bench_lookup( void ){
+  static const baudRate_t bauds[8] = { B1200, B2400, B4800, B9600, B19200, B38400, B57600, B115200 };
+  static const baudRate_t airs[8] = { B300, B1200, B2400, B4800, B9600, B19200, B38400, B62500 };
+  static const parity_t parities[3] = { BPARITY_NONE, BPARITY_ODD, BPARITY_EVEN };
+  static const char * packets[4] = { "240", "128", "64", "32" };
+  static const char * cycles[8] = { "500", "1000", "1500", "2000", "2500", "3000", "3500", "4000" };
+  uint64_t start, sum = 0;
+
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_CALLS ; ++i )
+    sum += lookup_table_baudrate_2bin( bauds[ i & 7 ] );
+  bench_report( "lookup_table", "baudrate_2bin", BENCH_CALLS, bench_now( ) - start, 0 );
+
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_CALLS ; ++i )
+    sum += (uint64_t) lookup_table_baudrate_2code( (uint8_t) ( i & 7 ) );
+  bench_report( "lookup_table", "baudrate_2code", BENCH_CALLS, bench_now( ) - start, 0 );
+
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_CALLS ; ++i )
+    sum += lookup_table_parity_2bin( parities[ i % 3 ] );
+  bench_report( "lookup_table", "parity_2bin", BENCH_CALLS, bench_now( ) - start, 0 );
+
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_CALLS ; ++i )
+    sum += (uint64_t) lookup_table_parity_2code( (uint8_t) ( i % 3 ) );
+  bench_report( "lookup_table", "parity_2code", BENCH_CALLS, bench_now( ) - start, 0 );
+
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_CALLS ; ++i )
+    sum += lookup_table_airrate_2bin( airs[ i & 7 ] );
+  bench_report( "lookup_table", "airrate_2bin", BENCH_CALLS, bench_now( ) - start, 0 );
+
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_CALLS ; ++i )
+    sum += (uint64_t) lookup_table_airrate_2code( (uint8_t) ( i & 7 ) );
+  bench_report( "lookup_table", "airrate_2code", BENCH_CALLS, bench_now( ) - start, 0 );
+
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_CALLS ; ++i )
+    sum += (uint64_t) lookup_table_airrate_2text( airs[ i & 7 ] )[0];
+  bench_report( "lookup_table", "airrate_2text", BENCH_CALLS, bench_now( ) - start, 0 );
+
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_CALLS ; ++i )
+    sum += (uint64_t) lookup_table_baudrate_fromtext_2code( "115200" );
+  bench_report( "lookup_table", "baudrate_fromtext", BENCH_CALLS, bench_now( ) - start, 0 );
+
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_CALLS ; ++i )
+    sum += (uint64_t) lookup_table_packet_fromtext( packets[ i & 3 ] );
+  bench_report( "lookup_table", "packet_fromtext", BENCH_CALLS, bench_now( ) - start, 0 );
+
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_CALLS ; ++i )
+    sum += (uint64_t) lookup_table_worcycle_fromtext( cycles[ i & 7 ] );
+  bench_report( "lookup_table", "worcycle_fromtext", BENCH_CALLS, bench_now( ) - start, 0 );
+
+  bench_sink += sum;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+bench_registers( void ){
+  e22900t22s_eeprom_t cfg;
+  uint8_t reg[ E22900T22S_REG_BLOCK ];
+
+  memset( &cfg, 0, sizeof(cfg) );
+  cfg.baudrate = B9600;
+  cfg.airrate = B2400;
+  cfg.parity = BPARITY_NONE;
+  cfg.packet_size = E22900T22S_PACKET_240;
+  cfg.transmit_power = E22900T22S_DBM_22;
+  cfg.wor_cycle = E22900T22S_WOR_2000;
+
+  // The image built by `e22900t22s_update_eeprom` and decoded by `e22900t22s_get_config`
+  uint64_t start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_IMAGES ; ++i ){
+    cfg.channel = (uint8_t) i;
+    pack_registers( &cfg, reg );
+    bench_sink += reg[ E22900T22S_MEM_REG2 ];
+  }
+  bench_report( "registers", "pack", BENCH_IMAGES, bench_now( ) - start, E22900T22S_REG_BLOCK );
+
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_IMAGES ; ++i ){
+    reg[ E22900T22S_MEM_REG2 ] = (uint8_t) i;
+    unpack_registers( reg, &cfg );
+    bench_sink += cfg.channel;
+  }
+  bench_report( "registers", "unpack", BENCH_IMAGES, bench_now( ) - start, E22900T22S_REG_BLOCK );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+bench_crc( const size_t segment ){
+  uint8_t * data = (uint8_t *) malloc( BENCH_BUFFER );
+  uint8_t * sealed = (uint8_t *) malloc( BENCH_BUFFER * 4 );
+  if( !data || !sealed ){
+    perror("malloc");
+    free( data );
+    return;
+  }
+
+  for( size_t i = 0 ; i < BENCH_BUFFER ; ++i )
+    data[i] = (uint8_t) ( 1 + i % 251 );
+  for( size_t i = segment ; i + 1 < BENCH_BUFFER ; i += segment + 2 )
+    data[i] = data[i + 1] = 0x00;
+
+  char label[32];
+  snprintf( label, sizeof(label), "segment=%zu", segment );
+
+  uint64_t start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_SCANS ; ++i )
+    bench_sink += e22900t22s_crc32c( data, segment );
+  bench_report( "crc32c", label, BENCH_SCANS, bench_now( ) - start, segment );
+
+  size_t length = 0;
+  e22900t22s_crc_state_t state;
+  memset( &state, 0, sizeof(state) );
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_SCANS ; ++i ){
+    length = e22900t22s_crc_seal( &state, data, BENCH_BUFFER, sealed, BENCH_BUFFER * 2 );
+    bench_sink += length;
+  }
+  bench_report( "crc_seal", label, BENCH_SCANS, bench_now( ) - start, BENCH_BUFFER );
+
+  // Each pass starts without the segment the previous one left open
+  uint64_t ns = 0;
+  for( uint32_t i = 0 ; i < BENCH_SCANS ; ++i ){
+    memset( &state.reader, 0, sizeof(state.reader) );
+    start = bench_now( );
+    bench_sink += e22900t22s_crc_verify( &state, sealed, length, 0, &sealed[ BENCH_BUFFER * 2 ], BENCH_BUFFER * 2 );
+    ns += bench_now( ) - start;
+  }
+  bench_report( "crc_verify", label, BENCH_SCANS, ns, length );
+
+  free( sealed );
+  free( data );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+bench_codec( const size_t segment ){
+  e22900t22s_codec_t * codec = (e22900t22s_codec_t *) malloc( sizeof(e22900t22s_codec_t) );
+  if( !codec ){
+    perror("malloc");
+    return;
+  }
+  e22900t22s_codec_init( codec );
+
+  // Text like payload behind a repeated header, the coder finds matches inside the segment
+  uint8_t body[ E22900T22S_CODEC_SEGMENT ];
+  const char * text = "node=17;temp=21.5;hum=40;";
+  for( size_t i = 0 ; i < segment ; ++i )
+    body[i] = (uint8_t) text[ i % strlen( text ) ];
+
+  char label[32];
+  snprintf( label, sizeof(label), "segment=%zu", segment );
+
+  uint8_t coded[ E22900T22S_CODEC_SEGMENT + E22900T22S_CODEC_HEADER ];
+  size_t length = 0;
+  uint64_t start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_SCANS ; ++i ){
+    length = e22900t22s_codec_compress( codec, body, segment, coded );
+    bench_sink += length;
+  }
+  bench_report( "codec_compress", label, BENCH_SCANS, bench_now( ) - start, segment );
+
+  uint8_t out[ E22900T22S_CODEC_SEGMENT ];
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_SCANS ; ++i )
+    bench_sink += (uint64_t) e22900t22s_codec_expand( codec, coded, length, out, sizeof(out) );
+  bench_report( "codec_expand", label, BENCH_SCANS, bench_now( ) - start, segment );
+
+  printf("codec segment=%zu ratio=%.3f\n", segment, (double) length / (double) segment );
+  free( codec );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+bench_fec( const size_t segment ){
+  e22900t22s_fec_t * fec = (e22900t22s_fec_t *) malloc( sizeof(e22900t22s_fec_t) );
+  uint8_t * data = (uint8_t *) malloc( BENCH_BUFFER );
+  uint8_t * coded = NULL;
+  if( !fec || !data || -1 == e22900t22s_fec_init( fec, 8, 2 ) || !( coded = (uint8_t *) malloc( 2 * e22900t22s_fec_pack_bound( fec, BENCH_BUFFER ) ) ) ){
+    perror("bench_fec");
+    free( fec );
+    free( data );
+    return;
+  }
+
+  for( size_t i = 0 ; i < BENCH_BUFFER ; ++i )
+    data[i] = (uint8_t) ( 1 + i % 251 );
+  for( size_t i = segment ; i + 1 < BENCH_BUFFER ; i += segment + 2 )
+    data[i] = data[i + 1] = 0x00;
+
+  char label[32];
+  snprintf( label, sizeof(label), "segment=%zu", segment );
+
+  uint8_t repair[ E22900T22S_FEC_SYMBOL ] = { 0 };
+  uint64_t start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_SCANS ; ++i )
+    e22900t22s_fec_mul_add( repair, &data[1], (uint8_t) ( i | 1 ), segment );
+  bench_sink += repair[0];
+  bench_report( "fec_mul_add", label, BENCH_SCANS, bench_now( ) - start, segment );
+
+  // Blocks of 8 sources and 2 repairs, the buffer is taken as one write under load, the open block and the held source add to later passes
+  size_t size = 2 * e22900t22s_fec_pack_bound( fec, BENCH_BUFFER );
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_SCANS ; ++i )
+    bench_sink += e22900t22s_fec_pack( fec, data, BENCH_BUFFER, 0, coded, size );
+  bench_report( "fec_pack", label, BENCH_SCANS, bench_now( ) - start, BENCH_BUFFER );
+
+  free( coded );
+  free( data );
+  free( fec );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int 
+main( void ){
+  const size_t segments[] = { 16, 64, 240 };
+  for( size_t i = 0 ; i < sizeof(segments) / sizeof(segments[0]) ; ++i )
+    bench_segments( segments[i] );
+
+  bench_rssi( );
+  bench_lookup( );
+  bench_registers( );
+  for( size_t i = 0 ; i < sizeof(segments) / sizeof(segments[0]) ; ++i )
+    bench_crc( segments[i] );
+  for( size_t i = 0 ; i < sizeof(segments) / sizeof(segments[0]) ; ++i )
+    bench_codec( segments[i] );
+  for( size_t i = 0 ; i < sizeof(segments) / sizeof(segments[0]) ; ++i )
+    bench_fec( segments[i] );
+  return EXIT_SUCCESS;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
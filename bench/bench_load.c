@@ -0,0 +1,107 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      bench_load.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include "bench.h"
+#include <e22900t22s/config.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define BENCH_ITERATIONS 2000               // Loads timed per configuration file
+#define BENCH_WARMUP     50                 // Loads discarded before timing, they fill the parser dictionaries and the page cache
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+int8_t bench_file( const char * filename );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t 
+bench_file( const char * filename ){
+  e22900t22s_config_t config;
+  e22900t22s_eeprom_t eeprom;
+  e22900t22s_pinmode_t pinout;
+  e22900t22s_mixip_t translator;
+
+  for( uint32_t i = 0 ; i < BENCH_WARMUP ; ++i ){
+    if( -1 == e22900t22s_load( filename, &config ) )
+      return -1;
+  }
+
+  // Single pass, the startup path of dsetup
+  uint64_t start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_ITERATIONS ; ++i ){
+    if( -1 == e22900t22s_load( filename, &config ) )
+      return -1;
+  }
+  uint64_t single = bench_now( ) - start;
+
+  // Driver and translator loaded apart, each one parsing the whole file as the previous startup did
+  start = bench_now( );
+  for( uint32_t i = 0 ; i < BENCH_ITERATIONS ; ++i ){
+    if( -1 == e22900t22s_load_config( filename, &eeprom, &pinout ) )
+      return -1;
+    if( -1 == e22900t22s_load_mixip_config( filename, &translator ) )
+      return -1;
+  }
+  uint64_t split = bench_now( ) - start;
+
+  bench_sink += config.eeprom.channel + translator.tmp.size_sls;
+  bench_report( "load", filename, BENCH_ITERATIONS, single, 0 );
+  bench_report( "load_split", filename, BENCH_ITERATIONS, split, 0 );
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int 
+main( int argc, char ** argv ){
+  if( 2 > argc ){
+    fprintf( stderr, "Usage: %s <config.xml> [config.xml ...]\n", argv[0] );
+    return EXIT_FAILURE;
+  }
+
+  for( int i = 1 ; i < argc ; ++i ){
+    if( -1 == bench_file( argv[i] ) ){
+      perror( argv[i] );
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
@@ -0,0 +1,779 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s_emulator.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Usage
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+// Two emulated modules are exposed as pseudo-terminals and linked by a simulated RF channel:
+//
+//   ./build/e22900t22s_emulator -a /tmp/e22a -b /tmp/e22b -g -l 0.05 -d 20 -r -70 -s 4 -n -105
+//
+// -a/-b   Symlinks created to each module pty, the MIXIP serial port of each side points to them
+// -g      Creates the M0, M1 and AUX lines with gpio-sim (configfs), the chip and offsets to use in <pin> are printed
+// -m      Mode of both modules when -g is not given (0 normal, 1 WOR, 2 config, 3 sleep)
+// -N      Starts with the ambient noise enabled in REG1, so the RSSI command is answered without a register write first
+// -M      Without -g, each module follows the mode written as one digit to <link>.mode, for the tests that fake the M0 and M1 lines
+// -l      Packet loss probability, -d extra latency (ms), -r/-s RSSI mean/deviation (dBm), -n noise floor (dBm), -S seed
+// -v      Prints every register command and packet
+//
+// The driver needs no change, the serial port is the pty and the pins are gpio-sim lines driven by libgpiod.
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define _GNU_SOURCE
+#include <e22900t22s/core.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define EMU_MODULES       2                 // Modules linked by the channel
+#define EMU_BUFFER        1000              // Module serial buffer (bytes), as the E22 datasheet
+#define EMU_FLIGHT        64                // Packets on the air at the same time
+#define EMU_OVERHEAD      13                // Preamble, header and CRC sent with each packet (bytes)
+#define EMU_SWITCH_US     2000              // AUX low after a mode switch (us)
+#define EMU_WRITE_US      5000              // AUX low after a persistent register write (us)
+#define EMU_STALE_US      100000            // Incomplete register commands are discarded after this idle time (us)
+#define EMU_GPIO_SIM      "/sys/kernel/config/gpio-sim"
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef enum{
+  EMU_LINE_AUX = 0,
+  EMU_LINE_M0  = 1,
+  EMU_LINE_M1  = 2,
+  EMU_LINES    = 3,
+} emu_line_t;
+
+typedef struct{
+  double   loss;                            // Probability of a packet being lost
+  double   latency_us;                      // Propagation and processing delay added to the airtime
+  double   rssi_mean;                       // Received power (dBm)
+  double   rssi_std;
+  double   noise_mean;                      // Ambient noise (dBm)
+  double   noise_std;
+  uint64_t seed;                            // Random generator state
+} emu_channel_t;
+
+typedef struct{
+  int      enabled;
+  char     chip[NAME_MAX];                  // gpiochipN, used in the <pin><chip> of the configuration
+  int      value[EMU_LINES];                // sim_gpioN/value, M0 and M1 as driven by the driver
+  int      pull[EMU_LINES];                 // sim_gpioN/pull, drives AUX
+} emu_gpio_t;
+
+typedef struct{
+  char       name;
+  int        master;                        // Pty master, the emulated module side
+  int        slave;                         // Kept open so the master never hangs up between driver runs
+  char       path[PATH_MAX];
+  const char * link;
+  emu_gpio_t gpio;
+  int        follow;                        // <link>.mode with -M, -1 otherwise
+
+  uint8_t    eeprom[ E22900T22S_REG_BLOCK ];
+  uint8_t    running[ E22900T22S_REG_BLOCK ];
+  uint8_t    mode;                          // `e22900t22s_mode_t`
+  uint8_t    aux;                           // Level driven on AUX
+
+  uint8_t    rx[ EMU_BUFFER ];              // Bytes written by the driver and not handled yet
+  size_t     rx_len;
+  uint64_t   rx_last;                       // When the last byte arrived (ns)
+  uint64_t   busy_until;                    // AUX is low until then (ns)
+  uint64_t   tx_free;                       // When the radio finishes the packets queued (ns)
+  uint8_t    last_rssi;                     // RSSI code of the last packet received
+
+  uint32_t   sent;
+  uint32_t   received;
+  uint32_t   lost;
+  uint32_t   commands;
+} emu_module_t;
+
+typedef struct{
+  uint64_t due;                             // When the packet reaches the receivers (ns)
+  uint8_t  from;
+  uint8_t  fixed;                           // The first 3 bytes are the destination address and channel
+  uint8_t  data[ E22900T22S_REG_BLOCK + 256 ];
+  size_t   len;
+} emu_frame_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+uint64_t emu_now( void );
+double emu_random( emu_channel_t * ch );
+double emu_gaussian( emu_channel_t * ch, const double mean, const double std );
+uint8_t emu_rssi_code( const double dbm );
+
+int emu_pty_open( emu_module_t * m );
+int emu_gpio_create( emu_module_t * mods, const size_t n );
+void emu_gpio_destroy( emu_module_t * mods, const size_t n );
+int emu_write_file( const char * path, const char * text );
+int emu_read_file( const char * path, char * text, const size_t size );
+
+uint32_t emu_uart_bps( const emu_module_t * m );
+uint32_t emu_air_bps( const emu_module_t * m );
+size_t emu_packet_size( const emu_module_t * m );
+uint64_t emu_airtime( const emu_module_t * m, const size_t len );
+
+void emu_mode( emu_module_t * m, const uint64_t now );
+void emu_aux( emu_module_t * m, const uint64_t now );
+void emu_reply( emu_module_t * m, const uint8_t * data, const size_t len );
+void emu_config( emu_module_t * m, const uint64_t now );
+void emu_normal( emu_module_t * m, const uint64_t now );
+void emu_transmit( emu_module_t * m, const uint8_t * data, const size_t len, const uint8_t fixed, const uint64_t now );
+void emu_deliver( emu_frame_t * f, const uint64_t now );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+static emu_module_t  modules[ EMU_MODULES ];
+static emu_frame_t   flight[ EMU_FLIGHT ];
+static emu_channel_t channel = { 0.0, 0.0, -70.0, 3.0, -105.0, 1.0, 0x9E3779B97F4A7C15ULL };
+static volatile sig_atomic_t running = 1;
+static int verbose = 0;
+static uint32_t dropped = 0;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t 
+emu_now( void ){
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+double 
+emu_random( emu_channel_t * ch ){
+  // xorshift64*, reproducible for a given seed
+  ch->seed ^= ch->seed >> 12;
+  ch->seed ^= ch->seed << 25;
+  ch->seed ^= ch->seed >> 27;
+  return (double) ( ( ch->seed * 0x2545F4914F6CDD1DULL ) >> 11 ) / 9007199254740992.0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+double 
+emu_gaussian( emu_channel_t * ch, const double mean, const double std ){
+  double u = emu_random( ch ), v = emu_random( ch );
+  if( u < 1e-12 )
+    u = 1e-12;
+  return mean + std * sqrt( -2.0 * log( u ) ) * cos( 2.0 * M_PI * v );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t 
+emu_rssi_code( const double dbm ){
+  // Inverse of convertRSSI_frombin_2dbm, 0.5 dBm per step
+  double code = -2.0 * dbm;
+  if( 0.0 > code )
+    return 0;
+  if( 255.0 < code )
+    return 255;
+  return (uint8_t) lround( code );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int 
+emu_pty_open( emu_module_t * m ){
+  m->master = posix_openpt( O_RDWR | O_NOCTTY );
+  if( -1 == m->master || -1 == grantpt( m->master ) || -1 == unlockpt( m->master ) ){
+    perror("posix_openpt");
+    return -1;
+  }
+  if( 0 != ptsname_r( m->master, m->path, sizeof(m->path) ) ){
+    perror("ptsname_r");
+    return -1;
+  }
+  fcntl( m->master, F_SETFL, fcntl( m->master, F_GETFL ) | O_NONBLOCK );
+
+  // Raw until the driver programs the line, so nothing is echoed back into the module
+  m->slave = open( m->path, O_RDWR | O_NOCTTY );
+  if( -1 == m->slave ){
+    perror("open");
+    return -1;
+  }
+  struct termios tio;
+  if( 0 == tcgetattr( m->slave, &tio ) ){
+    cfmakeraw( &tio );
+    tcsetattr( m->slave, TCSANOW, &tio );
+  }
+
+  if( m->link ){
+    unlink( m->link );
+    if( -1 == symlink( m->path, m->link ) ){
+      perror("symlink");
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int 
+emu_write_file( const char * path, const char * text ){
+  int fd = open( path, O_WRONLY );
+  if( -1 == fd )
+    return -1;
+  ssize_t len = write( fd, text, strlen( text ) );
+  close( fd );
+  return (ssize_t) strlen( text ) == len ? 0 : -1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int 
+emu_read_file( const char * path, char * text, const size_t size ){
+  int fd = open( path, O_RDONLY );
+  if( -1 == fd )
+    return -1;
+  ssize_t len = read( fd, text, size - 1 );
+  close( fd );
+  if( 0 >= len )
+    return -1;
+  text[ len ] = '\0';
+  text[ strcspn( text, "\n" ) ] = '\0';
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int 
+emu_gpio_create( emu_module_t * mods, const size_t n ){
+  static const char * names[ EMU_LINES ] = { "aux", "m0", "m1" };
+  char dev[NAME_MAX], path[PATH_MAX], name[NAME_MAX];
+
+  // One gpio-sim device, one bank (chip) per module, lines AUX, M0 and M1 at offsets 0, 1 and 2
+  snprintf( dev, sizeof(dev), EMU_GPIO_SIM "/e22900t22s-%d", getpid( ) );
+  if( -1 == mkdir( dev, 0755 ) ){
+    perror("mkdir " EMU_GPIO_SIM " (is gpio-sim loaded and configfs mounted?)");
+    return -1;
+  }
+  for( size_t i = 0 ; i < n ; ++i ){
+    snprintf( path, sizeof(path), "%s/bank%zu", dev, i );
+    if( -1 == mkdir( path, 0755 ) )
+      return -1;
+    snprintf( path, sizeof(path), "%s/bank%zu/num_lines", dev, i );
+    if( -1 == emu_write_file( path, "3" ) )
+      return -1;
+    for( int l = 0 ; l < EMU_LINES ; ++l ){
+      snprintf( path, sizeof(path), "%s/bank%zu/line%d", dev, i, l );
+      if( -1 == mkdir( path, 0755 ) )
+        return -1;
+      snprintf( path, sizeof(path), "%s/bank%zu/line%d/name", dev, i, l );
+      if( -1 == emu_write_file( path, names[l] ) )
+        return -1;
+    }
+  }
+  snprintf( path, sizeof(path), "%s/live", dev );
+  if( -1 == emu_write_file( path, "1" ) ){
+    perror("gpio-sim live");
+    return -1;
+  }
+  snprintf( path, sizeof(path), "%s/dev_name", dev );
+  if( -1 == emu_read_file( path, name, sizeof(name) ) )
+    return -1;
+
+  for( size_t i = 0 ; i < n ; ++i ){
+    emu_gpio_t * g = &mods[i].gpio;
+    snprintf( path, sizeof(path), "%s/bank%zu/chip_name", dev, i );
+    if( -1 == emu_read_file( path, g->chip, sizeof(g->chip) ) )
+      return -1;
+    for( int l = 0 ; l < EMU_LINES ; ++l ){
+      snprintf( path, sizeof(path), "/sys/devices/platform/%s/%s/sim_gpio%d/value", name, g->chip, l );
+      g->value[l] = open( path, O_RDONLY );
+      snprintf( path, sizeof(path), "/sys/devices/platform/%s/%s/sim_gpio%d/pull", name, g->chip, l );
+      g->pull[l] = open( path, O_WRONLY );
+      if( -1 == g->value[l] || -1 == g->pull[l] ){
+        perror("open sim_gpio");
+        return -1;
+      }
+    }
+    g->enabled = 1;
+    mods[i].aux = 0;
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+emu_gpio_destroy( emu_module_t * mods, const size_t n ){
+  char dev[NAME_MAX], path[PATH_MAX];
+  snprintf( dev, sizeof(dev), EMU_GPIO_SIM "/e22900t22s-%d", getpid( ) );
+
+  for( size_t i = 0 ; i < n ; ++i ){
+    for( int l = 0 ; l < EMU_LINES ; ++l ){
+      if( mods[i].gpio.enabled ){
+        close( mods[i].gpio.value[l] );
+        close( mods[i].gpio.pull[l] );
+      }
+    }
+    mods[i].gpio.enabled = 0;
+  }
+
+  snprintf( path, sizeof(path), "%s/live", dev );
+  emu_write_file( path, "0" );
+  for( size_t i = 0 ; i < n ; ++i ){
+    for( int l = 0 ; l < EMU_LINES ; ++l ){
+      snprintf( path, sizeof(path), "%s/bank%zu/line%d", dev, i, l );
+      rmdir( path );
+    }
+    snprintf( path, sizeof(path), "%s/bank%zu", dev, i );
+    rmdir( path );
+  }
+  rmdir( dev );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t 
+emu_uart_bps( const emu_module_t * m ){
+  // The configuration mode always runs at 9600 8N1
+  if( E22900T22S_MODE_CONFIG == m->mode || E22900T22S_MODE_SLEEP == m->mode )
+    return 9600;
+  return (uint32_t) atoi( lut_baudrate[ ( m->running[ E22900T22S_MEM_REG0 ] >> E22900T22S_SHF_UART ) & ( E22900T22S_LUT_SIZE_UART - 1 ) ].text );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t 
+emu_air_bps( const emu_module_t * m ){
+  return (uint32_t) atoi( lut_airrate[ ( m->running[ E22900T22S_MEM_REG0 ] >> E22900T22S_SHF_AIRDATA ) & ( E22900T22S_LUT_SIZE_AIRRATE - 1 ) ].text );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t 
+emu_packet_size( const emu_module_t * m ){
+  return (size_t) atoi( lut_packetsize[ ( m->running[ E22900T22S_MEM_REG1 ] >> E22900T22S_SHF_PKTSZ ) & ( E22900T22S_LUT_SIZE_PACKET - 1 ) ].text );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t 
+emu_airtime( const emu_module_t * m, const size_t len ){
+  uint64_t ns = (uint64_t) ( len + EMU_OVERHEAD ) * 8ULL * 1000000000ULL / emu_air_bps( m );
+
+  // A WOR transmitter stretches the preamble over the whole wake up cycle of the receivers
+  if( E22900T22S_MODE_WOR == m->mode && ( m->running[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_WOR & 1 ) )
+    ns += (uint64_t) atoi( lut_worcycle[ m->running[ E22900T22S_MEM_REG3 ] & ( E22900T22S_LUT_SIZE_WORCYCLE - 1 ) ].text ) * (uint64_t) 1000000;
+  return ns;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+emu_mode( emu_module_t * m, const uint64_t now ){
+  char v[4];
+  uint8_t mode;
+  if( m->gpio.enabled ){
+    uint8_t level[ EMU_LINES ] = { 0 };
+    for( int l = EMU_LINE_M0 ; l <= EMU_LINE_M1 ; ++l ){
+      ssize_t len = pread( m->gpio.value[l], v, sizeof(v), 0 );
+      level[l] = ( 0 < len && '1' == v[0] );
+    }
+
+    // M0 is the low bit and M1 the high bit of `e22900t22s_mode_t`
+    mode = (uint8_t) ( level[ EMU_LINE_M1 ] << 1 | level[ EMU_LINE_M0 ] );
+  }
+  else if( -1 != m->follow ){
+    if( 1 != pread( m->follow, v, 1, 0 ) || '0' > v[0] || '3' < v[0] )
+      return;
+    mode = (uint8_t) ( v[0] - '0' );
+  }
+  else
+    return;
+
+  if( mode == m->mode )
+    return;
+
+  if( verbose )
+    printf("[%c] Mode %u -> %u\n", m->name, m->mode, mode );
+  m->mode = mode;
+  m->rx_len = 0;
+  if( m->busy_until < now + EMU_SWITCH_US * 1000ULL )
+    m->busy_until = now + EMU_SWITCH_US * 1000ULL;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+emu_aux( emu_module_t * m, const uint64_t now ){
+  uint8_t level = m->busy_until <= now;
+  if( level == m->aux )
+    return;
+  m->aux = level;
+  if( m->gpio.enabled ){
+    const char * pull = level ? "pull-up" : "pull-down";
+    if( -1 == pwrite( m->gpio.pull[ EMU_LINE_AUX ], pull, strlen( pull ), 0 ) )
+      perror("pwrite pull");
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+emu_reply( emu_module_t * m, const uint8_t * data, const size_t len ){
+  ssize_t ret = write( m->master, data, len );
+  if( (ssize_t) len != ret )
+    dropped += (uint32_t) len;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+emu_config( emu_module_t * m, const uint64_t now ){
+  const uint8_t overhead = 3;
+
+  while( m->rx_len >= overhead ){
+    uint8_t command = m->rx[0], address = m->rx[1], length = m->rx[2];
+    uint8_t write = E22900T22S_SET_REG == command || E22900T22S_SET_TMP_REG == command;
+    size_t need = (size_t) overhead + ( write ? length : 0U );
+
+    uint8_t valid = ( write || E22900T22S_READ_REG == command ) && 0 < length &&
+                    ( ( E22900T22S_REG_BLOCK >= address + length ) ||
+                      ( E22900T22S_MEM_PID <= address && E22900T22S_MEM_PID + E22900T22S_PID_SIZE >= address + length && !write ) );
+    if( !valid ){
+      const uint8_t error[3] = { 0xFF, 0xFF, 0xFF };
+      emu_reply( m, error, sizeof(error) );
+      m->rx_len = 0;
+      return;
+    }
+    if( m->rx_len < need )
+      return;
+
+    uint8_t ret[ 3 + 256 ] = { E22900T22S_READ_REG, address, length };
+    for( uint8_t i = 0 ; i < length ; ++i ){
+      uint8_t reg = (uint8_t) ( address + i );
+      if( write ){
+        m->running[ reg ] = m->rx[ overhead + i ];
+        if( E22900T22S_SET_REG == command )
+          m->eeprom[ reg ] = m->rx[ overhead + i ];
+        ret[ overhead + i ] = m->rx[ overhead + i ];
+      }
+      else if( E22900T22S_MEM_PID <= reg )
+        ret[ overhead + i ] = (uint8_t) ( 0x10 + reg - E22900T22S_MEM_PID );
+      else
+        ret[ overhead + i ] = E22900T22S_MEM_CRYPTH <= reg ? 0 : m->running[ reg ];
+    }
+    emu_reply( m, ret, (size_t) ( overhead + length ) );
+    m->commands ++;
+
+    if( E22900T22S_SET_REG == command && m->busy_until < now + EMU_WRITE_US * 1000ULL )
+      m->busy_until = now + EMU_WRITE_US * 1000ULL;
+    if( verbose )
+      printf("[%c] Command %02X address %02X length %u\n", m->name, command, address, length );
+
+    memmove( m->rx, m->rx + need, m->rx_len - need );
+    m->rx_len -= need;
+  }
+
+  if( m->rx_len && now - m->rx_last > EMU_STALE_US * 1000ULL )
+    m->rx_len = 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+emu_normal( emu_module_t * m, const uint64_t now ){
+  // RSSI read, only answered when the ambient noise is enabled
+  const uint8_t rssi_cmd[4] = { 0xC0, 0xC1, 0xC2, 0xC3 };
+  if( ( m->running[ E22900T22S_MEM_REG1 ] >> E22900T22S_SHF_AMBNS & 1 ) && 6 <= m->rx_len && !memcmp( m->rx, rssi_cmd, sizeof(rssi_cmd) ) ){
+    uint8_t address = m->rx[4], length = m->rx[5];
+    if( E22900T22S_PAST_RSSI + 1 >= address + length ){
+      uint8_t value[2] = { emu_rssi_code( emu_gaussian( &channel, channel.noise_mean, channel.noise_std ) ), m->last_rssi };
+      uint8_t ret[5] = { E22900T22S_READ_REG, address, length };
+      memcpy( &ret[3], &value[ address ], length );
+      emu_reply( m, ret, (size_t) ( 3 + length ) );
+    }
+    memmove( m->rx, m->rx + 6, m->rx_len - 6 );
+    m->rx_len -= 6;
+    return;
+  }
+
+  // The packet is sent once the UART stays idle for 3 bytes, or once it fills a packet
+  uint64_t gap = 3ULL * 10ULL * 1000000000ULL / emu_uart_bps( m );
+  size_t size = emu_packet_size( m );
+  uint8_t fixed = m->running[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_FIXED & 1;
+
+  while( m->rx_len && ( m->rx_len >= size || now - m->rx_last >= gap ) ){
+    size_t len = m->rx_len < size ? m->rx_len : size;
+    emu_transmit( m, m->rx, len, fixed, now );
+    memmove( m->rx, m->rx + len, m->rx_len - len );
+    m->rx_len -= len;
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+emu_transmit( emu_module_t * m, const uint8_t * data, const size_t len, const uint8_t fixed, const uint64_t now ){
+  uint64_t start = m->tx_free > now ? m->tx_free : now;
+  m->tx_free = start + emu_airtime( m, len );
+  m->busy_until = m->tx_free;
+  m->sent ++;
+
+  if( emu_random( &channel ) < channel.loss ){
+    m->lost ++;
+    return;
+  }
+
+  for( size_t i = 0 ; i < EMU_FLIGHT ; ++i ){
+    if( !flight[i].due ){
+      flight[i].due = m->tx_free + (uint64_t) channel.latency_us * 1000ULL;
+      flight[i].from = (uint8_t) ( m - modules );
+      flight[i].fixed = fixed;
+      memcpy( flight[i].data, data, len );
+      flight[i].len = len;
+      if( verbose )
+        printf("[%c] Sent %zu bytes, airtime %llu us\n", m->name, len, (unsigned long long) ( ( m->tx_free - start ) / 1000ULL ) );
+      return;
+    }
+  }
+  m->lost ++;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+emu_deliver( emu_frame_t * f, const uint64_t now ){
+  const emu_module_t * tx = &modules[ f->from ];
+  uint16_t address = (uint16_t) ( tx->running[ E22900T22S_MEM_ADDH ] << 8 | tx->running[ E22900T22S_MEM_ADDL ] );
+  uint8_t chan = tx->running[ E22900T22S_MEM_REG2 ];
+  const uint8_t * data = f->data;
+  size_t len = f->len;
+
+  // Fixed transmission, the destination address and channel lead the packet and are not delivered
+  if( f->fixed && 3 <= len ){
+    address = (uint16_t) ( data[0] << 8 | data[1] );
+    chan = data[2];
+    data += 3;
+    len -= 3;
+  }
+
+  for( size_t i = 0 ; i < EMU_MODULES ; ++i ){
+    emu_module_t * rx = &modules[i];
+    if( i == f->from || ( E22900T22S_MODE_NORMAL != rx->mode && E22900T22S_MODE_WOR != rx->mode ) )
+      continue;
+
+    uint16_t own = (uint16_t) ( rx->running[ E22900T22S_MEM_ADDH ] << 8 | rx->running[ E22900T22S_MEM_ADDL ] );
+    uint8_t air = E22900T22S_SHF_AIRDATA + E22900T22S_LUT_SIZE_AIRRATE - 1;
+    if( rx->running[ E22900T22S_MEM_REG2 ] != chan || rx->running[ E22900T22S_MEM_NETID ] != tx->running[ E22900T22S_MEM_NETID ] ||
+        ( rx->running[ E22900T22S_MEM_REG0 ] & air ) != ( tx->running[ E22900T22S_MEM_REG0 ] & air ) )
+      continue;
+    if( own != address && 0xFFFF != address && 0xFFFF != own )
+      continue;
+
+    uint8_t out[ sizeof(f->data) + 1 ];
+    memcpy( out, data, len );
+    rx->last_rssi = emu_rssi_code( emu_gaussian( &channel, channel.rssi_mean, channel.rssi_std ) );
+    size_t n = len;
+    if( rx->running[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_RSSI & 1 )
+      out[ n ++ ] = rx->last_rssi;
+
+    // AUX is low while the packet is written to the UART
+    uint64_t uart = (uint64_t) n * 10ULL * 1000000000ULL / emu_uart_bps( rx );
+    if( rx->busy_until < now + uart )
+      rx->busy_until = now + uart;
+    emu_reply( rx, out, n );
+    rx->received ++;
+    if( verbose )
+      printf("[%c] Received %zu bytes, RSSI code %u\n", rx->name, len, rx->last_rssi );
+  }
+  f->due = 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+static void 
+emu_stop( int sig ){
+  (void) sig;
+  running = 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int 
+main( int argc, char ** argv ){
+  int opt, gpio = 0, mode = E22900T22S_MODE_NORMAL, ambient = 0, follow = 0;
+  const char * links[ EMU_MODULES ] = { NULL, NULL };
+
+  while( -1 != ( opt = getopt( argc, argv, "a:b:gm:NMl:d:r:s:n:S:v" ) ) ){
+    switch( opt ){
+      case 'a': links[0] = optarg; break;
+      case 'b': links[1] = optarg; break;
+      case 'g': gpio = 1; break;
+      case 'm': mode = atoi( optarg ) & 3; break;
+      case 'N': ambient = 1; break;
+      case 'M': follow = 1; break;
+      case 'l': channel.loss = atof( optarg ); break;
+      case 'd': channel.latency_us = atof( optarg ) * 1000.0; break;
+      case 'r': channel.rssi_mean = atof( optarg ); break;
+      case 's': channel.rssi_std = atof( optarg ); break;
+      case 'n': channel.noise_mean = atof( optarg ); break;
+      case 'S': channel.seed = strtoull( optarg, NULL, 0 ) | 1; break;
+      case 'v': verbose = 1; break;
+      default:
+        fprintf( stderr, "Usage: %s [-a link] [-b link] [-g] [-m mode] [-N] [-M] [-l loss] [-d ms] [-r dBm] [-s dB] [-n dBm] [-S seed] [-v]\n", argv[0] );
+        return EXIT_FAILURE;
+    }
+  }
+
+  signal( SIGINT, emu_stop );
+  signal( SIGTERM, emu_stop );
+  setvbuf( stdout, NULL, _IOLBF, 0 );
+
+  // Manufacturer defaults: 9600 8N1, 2.4k air rate, 240 bytes, 22 dBm, channel 0x32
+  const uint8_t defaults[ E22900T22S_REG_BLOCK ] = { 0x00, 0x00, 0x00, 0x62, 0x00, 0x32, 0x03, 0x00, 0x00 };
+  for( size_t i = 0 ; i < EMU_MODULES ; ++i ){
+    emu_module_t * m = &modules[i];
+    m->name = (char) ( 'a' + i );
+    m->link = links[i];
+    m->mode = (uint8_t) mode;
+    m->aux = 1;
+    m->follow = -1;
+    memcpy( m->eeprom, defaults, sizeof(defaults) );
+    memcpy( m->running, defaults, sizeof(defaults) );
+    if( ambient ){
+      m->eeprom[ E22900T22S_MEM_REG1 ] |= 1 << E22900T22S_SHF_AMBNS;
+      m->running[ E22900T22S_MEM_REG1 ] |= 1 << E22900T22S_SHF_AMBNS;
+    }
+    if( -1 == emu_pty_open( m ) )
+      return EXIT_FAILURE;
+
+    // The file starts at the mode of -m, the driver writes it before the bytes meant for the new mode
+    if( follow && m->link && !gpio ){
+      char path[PATH_MAX], digit = (char) ( '0' + mode );
+      snprintf( path, sizeof(path), "%s.mode", m->link );
+      m->follow = open( path, O_RDWR | O_CREAT | O_TRUNC, 0644 );
+      if( -1 == m->follow || 1 != write( m->follow, &digit, 1 ) ){
+        perror("open mode");
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  if( gpio && -1 == emu_gpio_create( modules, EMU_MODULES ) ){
+    emu_gpio_destroy( modules, EMU_MODULES );
+    return EXIT_FAILURE;
+  }
+
+  for( size_t i = 0 ; i < EMU_MODULES ; ++i ){
+    emu_module_t * m = &modules[i];
+    printf("[%c] Serial: %s%s%s\n", m->name, m->path, m->link ? " -> " : "", m->link ? m->link : "" );
+    if( m->gpio.enabled )
+      printf("[%c] Pins: <chip>%s</chip> <aux>%d</aux> <m0>%d</m0> <m1>%d</m1>\n", m->name, m->gpio.chip, EMU_LINE_AUX, EMU_LINE_M0, EMU_LINE_M1 );
+    emu_aux( m, emu_now( ) );
+  }
+
+  while( running ){
+    uint64_t now = emu_now( );
+    uint64_t next = now + ( gpio ? 1000000ULL : 100000000ULL );
+
+    for( size_t i = 0 ; i < EMU_FLIGHT ; ++i ){
+      if( flight[i].due && flight[i].due <= now )
+        emu_deliver( &flight[i], now );
+      else if( flight[i].due && flight[i].due < next )
+        next = flight[i].due;
+    }
+
+    struct pollfd fds[ EMU_MODULES ];
+    for( size_t i = 0 ; i < EMU_MODULES ; ++i ){
+      emu_module_t * m = &modules[i];
+      emu_mode( m, now );
+      if( E22900T22S_MODE_CONFIG == m->mode )
+        emu_config( m, now );
+      else if( E22900T22S_MODE_SLEEP != m->mode )
+        emu_normal( m, now );
+      else
+        m->rx_len = 0;
+      emu_aux( m, now );
+
+      if( m->busy_until > now && m->busy_until < next )
+        next = m->busy_until;
+      if( m->rx_len ){
+        uint64_t idle = m->rx_last + 3ULL * 10ULL * 1000000000ULL / emu_uart_bps( m );
+        if( idle < next )
+          next = idle > now ? idle : now + 100000ULL;
+      }
+      fds[i].fd = m->master;
+      fds[i].events = POLLIN;
+      fds[i].revents = 0;
+    }
+
+    int timeout = (int) ( ( next - now + 999999ULL ) / 1000000ULL );
+    if( 0 > poll( fds, EMU_MODULES, timeout ) && EINTR != errno ){
+      perror("poll");
+      break;
+    }
+
+    now = emu_now( );
+    for( size_t i = 0 ; i < EMU_MODULES ; ++i ){
+      emu_module_t * m = &modules[i];
+      if( !( fds[i].revents & POLLIN ) || EMU_BUFFER <= m->rx_len )
+        continue;
+
+      // A switch is seen before the bytes written after it, they belong to the new mode
+      emu_mode( m, now );
+      ssize_t len = read( m->master, m->rx + m->rx_len, EMU_BUFFER - m->rx_len );
+      if( 0 < len ){
+        m->rx_len += (size_t) len;
+        m->rx_last = now;
+        if( m->busy_until < now + 1000ULL && E22900T22S_MODE_CONFIG != m->mode )
+          m->busy_until = now + 1000ULL;
+      }
+    }
+  }
+
+  for( size_t i = 0 ; i < EMU_MODULES ; ++i ){
+    emu_module_t * m = &modules[i];
+    printf("[%c] Sent: %u, Received: %u, Lost: %u, Commands: %u\n", m->name, m->sent, m->received, m->lost, m->commands );
+    if( m->link )
+      unlink( m->link );
+    if( -1 != m->follow ){
+      char path[PATH_MAX];
+      snprintf( path, sizeof(path), "%s.mode", m->link );
+      unlink( path );
+      close( m->follow );
+    }
+    close( m->slave );
+    close( m->master );
+  }
+  if( dropped )
+    printf("Bytes dropped on full ptys: %u\n", dropped );
+  if( gpio )
+    emu_gpio_destroy( modules, EMU_MODULES );
+  return EXIT_SUCCESS;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
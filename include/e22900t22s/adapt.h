@@ -0,0 +1,216 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s/adapt.h
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_ADAPT_H
+#define E22900T22S_ADAPT_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/core.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define E22900T22S_ADAPT_MAGIC "E22"                // First bytes of a control frame body
+#define E22900T22S_ADAPT_GAIN  1.25f                // Goodput ratio a setting must reach over the current one to be proposed
+#define E22900T22S_ADAPT_SLOPE 1.5f                 // SNR (dB) per e-fold of the odds of a 32 B packet being received
+#define E22900T22S_ADAPT_ALPHA 0.125f               // Weight of the newest packet in the SNR average
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef enum{
+  E22900T22S_ADAPT_TICK     = 1,                    // Period of the controller (s)
+  E22900T22S_ADAPT_HOLD     = 3,                    // Evaluations in a row a better setting must win before it is proposed
+  E22900T22S_ADAPT_DWELL    = 10,                   // Time after a switch, or a failed one, before the next proposal (s)
+  E22900T22S_ADAPT_SAMPLES  = 8,                    // Packets received on the current setting before deciding
+  E22900T22S_ADAPT_RETRIES  = 3,                    // Proposals sent before giving up
+  E22900T22S_ADAPT_WAIT     = 2,                    // Time for the peer to answer a proposal (s)
+  E22900T22S_ADAPT_CONFIRM  = 6,                    // Time to hear the peer on the new setting before reverting (s)
+  E22900T22S_ADAPT_SILENCE  = 30,                   // Time the proposer of a setting waits without receiving anything before trying the previous one (s)
+  E22900T22S_ADAPT_OVERHEAD = 16,                   // Air time of the preamble and header of a packet, in payload bytes
+  E22900T22S_ADAPT_BODY     = 8,                    // Control frame body: magic, type, epoch, air rate, packet size, check
+  E22900T22S_ADAPT_FRAME    = 10,                   // Control frame on the serial, the body between two limiters
+} e22900t22s_adapt_default_t;
+
+typedef enum{
+  E22900T22S_ADAPT_IDLE = 0,
+  E22900T22S_ADAPT_PROPOSED,                        // Waiting for the peer to accept the proposal
+  E22900T22S_ADAPT_CONFIRMING,                      // Switched, waiting to hear the peer on the new setting
+} e22900t22s_adapt_state_t;
+
+typedef enum{
+  E22900T22S_ADAPT_PROPOSE = 'P',                   // Sent on the current setting, asks the peer to switch
+  E22900T22S_ADAPT_ACCEPT  = 'A',                   // Sent on the current setting, the peer switches right after
+  E22900T22S_ADAPT_ACK     = 'C',                   // Sent on the new setting, confirms both ends switched
+} e22900t22s_adapt_type_t;
+
+typedef enum{
+  E22900T22S_ADAPT_SEND  = 1,                       // Send the control frame, before anything else
+  E22900T22S_ADAPT_APPLY = 2,                       // Apply `airrate` and `packet` to the module, after the frame left
+} e22900t22s_adapt_action_t;
+
+typedef struct{
+  uint8_t type;                                     // e22900t22s_adapt_type_t
+  uint8_t epoch;                                    // Proposal number, never 0
+  uint8_t airrate;                                  // Air rate register value, index of `lut_airrate`
+  uint8_t packet;                                   // e22900t22s_packet_size_t
+} e22900t22s_adapt_msg_t;
+
+typedef struct{
+  // Written by the reader process
+  float    snr;                                     // Average SNR of the packets received on the current setting (dB)
+  uint32_t samples;                                 // Packets received on the current setting, reset by the loop process on a switch
+  uint32_t inbox;                                   // Last control message received packed, 0 if none, taken by the loop process
+
+  // Written by the loop process once the module runs the setting, read by the writer and the reader processes
+  uint32_t applied;                                 // Changes so far, air rate and packet size, 16, 8 and 8 bits
+
+  // Owned by the loop process
+  uint8_t  state;                                   // e22900t22s_adapt_state_t
+  uint8_t  initiator;                               // 1 if this end proposed the setting being confirmed
+  uint8_t  epoch;                                   // Last proposal sent or accepted
+  uint8_t  airrate;                                 // Setting the module runs
+  uint8_t  packet;
+  uint8_t  target_airrate;                          // Setting proposed
+  uint8_t  target_packet;
+  uint8_t  previous_airrate;                        // Setting restored if the switch is not confirmed, or if the link falls silent
+  uint8_t  previous_packet;
+  uint8_t  wins;                                    // Evaluations in a row the target won
+  uint8_t  tries;                                   // Control frames sent in the current state
+  uint32_t deadline;                                // When the current state times out (s)
+  uint32_t dwell;                                   // No proposals before this time (s)
+  uint32_t silence;                                 // Next check for packets received since the previous one (s)
+  uint32_t heard;                                   // `samples` at the previous check
+} e22900t22s_adapt_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Starts the rate controller on the setting the module was configured with.
+ *  
+ * @param[out] adapt The controller, shared by the reader and the loop processes.
+ * @param[in] cfg The configuration applied to the module.
+ * 
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error, EINVAL if the air rate is not in `lut_airrate`.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_adapt_init( e22900t22s_adapt_t * adapt, const e22900t22s_eeprom_t * cfg );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Adds the SNR of a packet received, called by the reader process.
+ *  
+ * @param[in,out] adapt The controller.
+ * @param[in] SNR The packet SNR (dB).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_adapt_sample( e22900t22s_adapt_t * adapt, const float SNR );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Hands a control message received to the loop process, a message not yet taken is replaced.
+ *  
+ * @param[in,out] adapt The controller.
+ * @param[in] msg The control message.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_adapt_post( e22900t22s_adapt_t * adapt, const e22900t22s_adapt_msg_t * msg );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Expected goodput of a setting, the air rate scaled by the payload share of the air time and the packet success probability. \n
+ *        The success is a logistic of the margin over the SNR the demodulator needs at that air rate, compounded over the packet size.
+ *  
+ * @param[in] airrate The air rate register value.
+ * @param[in] packet The packet size.
+ * @param[in] snr The link SNR (dB).
+ * 
+ * @return Returns the goodput (bps).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+float e22900t22s_adapt_goodput( const uint8_t airrate, const e22900t22s_packet_size_t packet, const float snr );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Advances the controller, called every `E22900T22S_ADAPT_TICK` by the loop process. \n
+ *        It handles the control message posted, times the handshake out, and proposes the setting with the best expected goodput. \n
+ *        Both ends switch together: PROPOSE and ACCEPT are sent on the current setting, the peer switches after ACCEPT and the proposer once it is received, \n
+ *        then the proposer sends ACK on the new setting every tick until one is answered. After `E22900T22S_ADAPT_CONFIRM` an end that received nothing on the \n
+ *        new setting reverts, and the proposer swaps back to the previous setting whenever it hears nothing for `E22900T22S_ADAPT_SILENCE`. \n
+ *        Crossing proposals are resolved by both ends keeping the most robust one.
+ *  
+ * @param[in,out] adapt The controller.
+ * @param[in] now Monotonic time (s).
+ * @param[out] msg The control message to send, if E22900T22S_ADAPT_SEND is returned.
+ * 
+ * @return Returns the e22900t22s_adapt_action_t flags to carry out, 0 if there is nothing to do.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t e22900t22s_adapt_step( e22900t22s_adapt_t * adapt, const uint32_t now, e22900t22s_adapt_msg_t * msg );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Tells the other processes the module runs `airrate` and `packet` now, called by the loop process once they are applied.
+ *  
+ * @param[in,out] adapt The controller.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_adapt_publish( e22900t22s_adapt_t * adapt );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Brings the configuration of a process in line with the setting the loop process applied last. \n
+ *        Every process keeps its own copy of the configuration, the air time, the pipeline and the FEC follow it.
+ *  
+ * @param[in] adapt The controller.
+ * @param[in,out] seen The last change the process took, 0 before the first one.
+ * @param[in,out] cfg The configuration of the process.
+ * 
+ * @return Returns 1 if `cfg` changed, 0 otherwise.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t e22900t22s_adapt_refresh( const e22900t22s_adapt_t * adapt, uint32_t * seen, e22900t22s_eeprom_t * cfg );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Builds the control frame sent to the module, a body with no zero bytes between the segment limiters.
+ *  
+ * @param[in] msg The control message.
+ * @param[out] frame The frame, `E22900T22S_ADAPT_FRAME` bytes.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_adapt_frame( const e22900t22s_adapt_msg_t * msg, uint8_t * frame );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Recognizes a control frame in a segment received.
+ *  
+ * @param[in] data The segment, from its first limiter up to the one closing it.
+ * @param[in] len The `data` length.
+ * @param[out] msg The control message.
+ * 
+ * @return Returns 1 if `data` is a valid control frame and `msg` was filled, 0 otherwise.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_adapt_parse( const uint8_t * data, const size_t len, e22900t22s_adapt_msg_t * msg );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
@@ -0,0 +1,145 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s/airtime.h
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_AIRTIME_H
+#define E22900T22S_AIRTIME_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/core.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define E22900T22S_BASE_KHZ    850125               // Carrier of channel 0, every channel adds 1 MHz (kHz)
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef enum{
+  E22900T22S_AIRTIME_OVERHEAD = 16,                 // Preamble and header of every RF packet, in payload bytes at the air rate
+  E22900T22S_AIRTIME_LBT      = 5000,               // Channel assessment before every RF packet with LBT, the module is busy but not transmitting (us)
+  E22900T22S_DUTY_WINDOW      = 3600,               // Observation period of the duty cycle limits, the bucket holds this much of the budget (s)
+  E22900T22S_DUTY_FULL        = 10000,              // Duty cycle unit, 1 % is 100
+  E22900T22S_SUBBANDS         = 7,                  // Sub-bands with a limit, and the last one for the channels without limit
+} e22900t22s_airtime_default_t;
+
+typedef struct{
+  const char * name;                                // ETSI EN 300 220 sub-band
+  uint32_t     low;                                 // Lowest carrier (kHz)
+  uint32_t     high;                                // Highest carrier (kHz)
+  uint16_t     duty;                                // Transmission share allowed (1/E22900T22S_DUTY_FULL)
+} e22900t22s_subband_t;
+
+typedef struct{
+  int64_t  tokens;                                  // Air time that can be spent right away, negative while a wait is owed (us)
+  uint64_t last;                                    // When the tokens were last refilled, monotonic (ns)
+} e22900t22s_bucket_t;
+
+typedef struct{
+  e22900t22s_bucket_t bucket[ E22900T22S_SUBBANDS ];
+  uint64_t            airtime;                      // Air time spent (us)
+  uint64_t            delayed;                      // Wait imposed by the duty cycle (us)
+  uint32_t            held;                         // Transmissions that had to wait
+} e22900t22s_duty_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Estimates the time the module needs to send `len` bytes with the configuration `cfg`. \n
+ *        The bytes are split in RF packets of the configured size, each one carries `E22900T22S_AIRTIME_OVERHEAD`, the fixed transmission header is already part of `len`. \n
+ *        A WOR transmitter stretches the preamble of every packet to the wake up cycle, it is counted whenever the WOR role is transmitter, the safe side for the duty cycle.
+ *  
+ * @param[in] cfg The configuration the module runs.
+ * @param[in] len The number of bytes written to the module.
+ * @param[out] busy If not NULL, the time the module is busy, the air time plus the LBT channel assessment (us).
+ * 
+ * @return Returns the air time (us), 0 if the air rate or the packet size are not valid.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t e22900t22s_airtime( const e22900t22s_eeprom_t * cfg, const size_t len, uint64_t * busy );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Finds the sub-band of a channel.
+ *  
+ * @param[in] channel The channel, 0 to 80.
+ * 
+ * @return Returns the index of the sub-band, `E22900T22S_SUBBANDS - 1` if the carrier has no duty cycle limit.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t e22900t22s_subband( const uint8_t channel );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Returns the description of a sub-band.
+ *  
+ * @param[in] band The index of the sub-band.
+ * 
+ * @return Returns the sub-band, NULL if `band` is not valid.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+const e22900t22s_subband_t * e22900t22s_subband_info( const uint8_t band );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Starts the duty cycle scheduler with every bucket full.
+ *  
+ * @param[out] duty The scheduler.
+ * @param[in] now Monotonic time (ns).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_duty_init( e22900t22s_duty_t * duty, const uint64_t now );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Takes `airtime` from the bucket of the sub-band, which refills at the sub-band duty cycle. \n
+ *        The air time is always taken, when the bucket is short the returned wait pays the difference back before the transmission.
+ *  
+ * @param[in,out] duty The scheduler.
+ * @param[in] band The index of the sub-band.
+ * @param[in] airtime The air time of the transmission (us).
+ * @param[in] now Monotonic time (ns).
+ * 
+ * @return Returns how long the transmission has to wait to respect the duty cycle (us), 0 if it can go now.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t e22900t22s_duty_reserve( e22900t22s_duty_t * duty, const uint8_t band, const uint64_t airtime, const uint64_t now );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Returns the air time that can still be spent right away in a sub-band.
+ *  
+ * @param[in,out] duty The scheduler, the bucket is refilled up to `now`.
+ * @param[in] band The index of the sub-band.
+ * @param[in] now Monotonic time (ns).
+ * 
+ * @return Returns the budget (us), 0 while a wait is owed, UINT64_MAX if the sub-band has no limit.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t e22900t22s_duty_budget( e22900t22s_duty_t * duty, const uint8_t band, const uint64_t now );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
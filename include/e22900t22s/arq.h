@@ -0,0 +1,223 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s/arq.h
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_ARQ_H
+#define E22900T22S_ARQ_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/core.h>
+#include <e22900t22s/segment.h>
+#include <pthread.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef enum{
+  E22900T22S_ARQ_HEADER     = 2,                    // Sequence number in front of every segment, 7 bits per byte with the top bit set (B)
+  E22900T22S_ARQ_WINDOW     = 64,                   // Most segments in flight, and the reorder window of the receiver
+  E22900T22S_ARQ_WINDOW_MIN = 4,
+  E22900T22S_ARQ_SEQUENCES  = 8192,                 // Sequence numbers, 6 bits in the first header byte and 7 in the second
+  E22900T22S_ARQ_SEGMENT    = 258,                  // Header and the longest segment body, the translator segment size is a byte (B)
+  E22900T22S_ARQ_RETRIES    = 4,                    // Transmissions of a segment before it is given up
+  E22900T22S_ARQ_BACKOFF    = 3,                    // The timeout doubles on every retransmission, up to 2^3 times
+  E22900T22S_ARQ_ACK        = 0x06,                 // First byte of an acknowledgement frame
+  E22900T22S_ARQ_PLAIN      = 0xC0,                 // Both header bytes of a segment without sequence number, the window had no room for it
+  E22900T22S_ARQ_FRAME      = 14,                   // Acknowledgement frame on the serial: limiters, type, cumulative ack and 9 bytes of SACK bitmap (B)
+  E22900T22S_ARQ_TICK       = 20,                   // Shortest period of the loop process that sends the acknowledgements and the retransmissions (ms)
+  E22900T22S_ARQ_TURNAROUND = 100,                  // Time the peer takes from a segment to an answer on the air, serial and mode switches (ms)
+  E22900T22S_ARQ_RTO_MAX    = 60,                   // Longest retransmission timeout (s)
+} e22900t22s_arq_default_t;
+
+typedef struct{
+  uint8_t  used;
+  uint8_t  acked;                                   // Acknowledged, or given up
+  uint8_t  lost;                                    // A later segment was acknowledged before it, sent again without waiting for the timeout
+  uint8_t  tries;                                   // Transmissions so far
+  uint16_t length;                                  // Header and body (B)
+  uint64_t sent;                                    // Last transmission (ns)
+  uint8_t  data[ E22900T22S_ARQ_SEGMENT ];          // Header and body, the limiters are added on every transmission
+} e22900t22s_arq_slot_t;
+
+typedef struct{
+  pthread_mutex_t lock;                             // Shared by the writer, the reader and the loop processes, robust
+  uint64_t now;                                     // Time of the write or the read holding the lock (ns)
+
+  // Sender, the writer fills the window, the reader acknowledges, the loop sends again
+  uint16_t next;                                    // Sequence number of the next segment
+  uint16_t base;                                    // Oldest segment not acknowledged
+  uint8_t  window;                                  // Segments in flight allowed, from the packet size
+  uint16_t capacity;                                // Serial buffer of the module (B)
+  uint64_t floor;                                   // Shortest round trip the air rate allows, a segment, the spaced acknowledgement and the turnaround (ns)
+  uint64_t srtt;                                    // Smoothed round trip time, 0 before the first sample (ns)
+  uint64_t rttvar;                                  // Round trip time variation (ns)
+  uint64_t rto;                                     // Retransmission timeout (ns)
+  e22900t22s_arq_slot_t slot[ E22900T22S_ARQ_WINDOW ];
+  e22900t22s_segment_walker_t writer;               // Segment to send still open at the end of the previous write
+
+  // Receiver, the reader delivers in order and asks the loop to acknowledge
+  uint16_t expected;                                // Next sequence number handed to the translator
+  uint64_t held;                                    // Bit i set if segment `expected + i` waits for the ones before it
+  uint64_t gap;                                     // When the oldest segment waiting arrived (ns)
+  uint8_t  pending;                                 // An acknowledgement is due
+  uint64_t spacing;                                 // Shortest time between two acknowledgements, the air time of a packet (ns)
+  uint64_t acknowledged;                            // When the last acknowledgement was sent (ns)
+  uint8_t  held_rssi[ E22900T22S_ARQ_WINDOW ];
+  uint16_t held_length[ E22900T22S_ARQ_WINDOW ];
+  uint8_t  held_data[ E22900T22S_ARQ_WINDOW ][ E22900T22S_ARQ_SEGMENT ];
+  e22900t22s_segment_walker_t reader;               // Received segment still open at the end of the previous buffer
+  size_t   released_length;
+  uint8_t  released[ E22900T22S_ARQ_WINDOW * ( E22900T22S_ARQ_SEGMENT + 3 ) ];  // Segments the loop process let go past an expired gap, handed with the next read
+
+  uint32_t sent;                                    // Segments sent with a sequence number
+  uint32_t resent;                                  // Retransmissions
+  uint32_t acked;                                   // Segments acknowledged
+  uint32_t abandoned;                               // Segments given up by the sender after `E22900T22S_ARQ_RETRIES`
+  uint32_t delivered;                               // Segments handed to the translator in order
+  uint32_t skipped;                                 // Segments the receiver stopped waiting for
+  uint32_t duplicates;                              // Segments received again, they are acknowledged and dropped
+  uint32_t acks;                                    // Acknowledgement frames sent
+} e22900t22s_arq_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Starts the selective repeat state, with the window and the timeout of the configuration the module runs.
+ *  
+ * @param[out] arq The state, in memory shared by the writer, the reader and the loop processes.
+ * @param[in] cfg The configuration the module runs.
+ * @param[in] capacity The serial buffer of the module (B).
+ * 
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_arq_init( e22900t22s_arq_t * arq, const e22900t22s_eeprom_t * cfg, const uint16_t capacity );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Aligns the window and the timeout with a new configuration of the module. \n
+ *        The window holds twice the RF packets the module buffers, one buffer on the air and one waiting for its acknowledgement. \n
+ *        The timeout is never shorter than one packet, the acknowledgement and the turnaround at the air rate, it starts at that plus a full module buffer.
+ *  
+ * @param[in,out] arq The state.
+ * @param[in] cfg The configuration the module runs.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_arq_tune( e22900t22s_arq_t * arq, const e22900t22s_eeprom_t * cfg );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Tells how long the writer waits before the segments of `data` fit in the window.
+ *  
+ * @param[in] arq The state.
+ * @param[in] data The segments to write, framed by 0x00 limiters.
+ * @param[in] len The number of bytes in `data`.
+ * 
+ * @return Returns 0 if they fit, otherwise the time to wait before asking again (ns).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t e22900t22s_arq_wait( e22900t22s_arq_t * arq, const uint8_t * data, const size_t len );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Puts the sequence number in front of every segment of a buffer to write, and keeps a copy until it is acknowledged. \n
+ *        A segment that does not fit in the window goes without sequence number, one still open at the end of `data` is held until the next write closes it.
+ *  
+ * @param[in,out] arq The state.
+ * @param[in] data The segments, framed by 0x00 limiters.
+ * @param[in] len The number of bytes in `data`.
+ * @param[in] now The time of the write (ns).
+ * @param[out] out The segments with their headers.
+ * @param[in] size The capacity of `out`, `len` plus `E22900T22S_ARQ_HEADER` per segment, and the held segment, is always enough.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, 0 is returned and `errno` is set to indicate the error, ENOBUFS if `out` is too small.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_arq_pack( e22900t22s_arq_t * arq, const uint8_t * data, const size_t len, const uint64_t now, uint8_t * out, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Hands the received segments in order, and takes the acknowledgements of the peer. \n
+ *        A segment after a gap waits until the gap arrives, the sender moves past it, or the sender would have given it up. \n
+ *        The segments `e22900t22s_arq_expire` let go come first, ahead of the ones in `data`. \n
+ *        Every segment keeps its RSSI byte, the acknowledgement frames are removed.
+ *  
+ * @param[in,out] arq The state.
+ * @param[in] data The received bytes.
+ * @param[in] len The number of bytes in `data`.
+ * @param[in] rssi The module appends an RSSI byte after every EOF limiter.
+ * @param[in] now The time of the read (ns).
+ * @param[out] out The segments, framed by 0x00 limiters.
+ * @param[in] size The capacity of `out`, `e22900t22s_arq_bound` bytes are enough.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, 0 is returned and `errno` is set to indicate the error, ENOBUFS if `out` is too small.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_arq_unpack( e22900t22s_arq_t * arq, const uint8_t * data, const size_t len, const uint8_t rssi, const uint64_t now, uint8_t * out, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Returns the capacity `e22900t22s_arq_unpack` needs for `len` received bytes, every waiting segment handed over with them.
+ *  
+ * @param[in] arq The state.
+ * @param[in] len The number of bytes received.
+ * 
+ * @return Returns the capacity (B).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_arq_bound( const e22900t22s_arq_t * arq, const size_t len );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Gathers what the loop process writes: the acknowledgement if one is due and a packet air time passed since the last one, \n
+ *        then the segments whose timeout expired or that a later acknowledgement showed lost, oldest first. \n
+ *        A segment sent `E22900T22S_ARQ_RETRIES` times is given up instead.
+ *  
+ * @param[in,out] arq The state.
+ * @param[in] now The current time (ns).
+ * @param[out] out The frames and segments, framed by 0x00 limiters.
+ * @param[in] size The capacity of `out`, segments that do not fit wait for the next call.
+ * @param[out] abandoned If not NULL, the segments given up in this call.
+ * 
+ * @return Returns the number of bytes in `out`.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_arq_poll( e22900t22s_arq_t * arq, const uint64_t now, uint8_t * out, const size_t size, uint32_t * abandoned );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Gives up the oldest gap once it was held longer than the sender keeps trying, from the loop process, so no new read is needed for it. \n
+ *        The segments after the gap are kept for the reader, the next `e22900t22s_arq_unpack` hands them over. \n
+ *        Nothing is done while the reader still has to take the segments of an earlier call.
+ *  
+ * @param[in,out] arq The state.
+ * @param[in] rssi The module appends an RSSI byte after every EOF limiter.
+ * @param[in] now The current time (ns).
+ * 
+ * @return Returns the number of segments let go.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t e22900t22s_arq_expire( e22900t22s_arq_t * arq, const uint8_t rssi, const uint64_t now );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
@@ -0,0 +1,168 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s/codec.h
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_CODEC_H
+#define E22900T22S_CODEC_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/segment.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef enum{
+  E22900T22S_CODEC_RAW  = 0x01,                     // The segment follows as it is
+  E22900T22S_CODEC_LZ   = 0x02,                     // LZ77 on the segment alone
+  E22900T22S_CODEC_DICT = 0x03,                     // LZ77 with the static dictionary in front of the segment
+} e22900t22s_codec_id_t;
+
+typedef enum{
+  E22900T22S_CODEC_HEADER     = 1,                  // Codec byte in front of every segment (B)
+  E22900T22S_CODEC_SEGMENT    = 256,                // Longest segment body, the translator segment size is a byte (B)
+  E22900T22S_CODEC_DICTIONARY = 2048,               // Longest static dictionary, the last bytes of a longer file are kept (B)
+  E22900T22S_CODEC_HASH_BITS  = 11,
+  E22900T22S_CODEC_DEPTH      = 16,                 // Candidates tried per position
+  E22900T22S_CODEC_ESCAPE     = 0xFF,               // Starts a match, or a literal 0xFF when followed by 0x01
+  E22900T22S_CODEC_MIN_MATCH  = 5,                  // A match takes 4 bytes, the escape, the length and 2 of distance
+  E22900T22S_CODEC_MAX_MATCH  = 258,
+} e22900t22s_codec_default_t;
+
+typedef struct{
+  uint8_t  window[ E22900T22S_CODEC_DICTIONARY + E22900T22S_CODEC_SEGMENT ];   // Dictionary followed by the segment being coded
+  uint16_t dictionary;                              // Bytes of dictionary at the start of `window`
+  uint16_t head[ 1 << E22900T22S_CODEC_HASH_BITS ]; // Last position of every hash in the dictionary, plus 1, 0 if none
+  uint16_t prev[ E22900T22S_CODEC_DICTIONARY ];     // Previous position with the same hash, plus 1
+  e22900t22s_segment_walker_t writer;               // Segment to code still open at the end of the previous write
+  e22900t22s_segment_walker_t reader;               // Received segment still open at the end of the previous buffer
+  uint64_t raw;                                     // Segment bytes before coding
+  uint64_t coded;                                   // Segment bytes after coding, with the codec byte
+  uint32_t segments;
+  uint32_t stored;                                  // Segments sent raw, coding did not make them shorter
+  uint32_t errors;                                  // Received segments that could not be expanded, they are dropped
+  uint64_t cpu_ns;                                  // Processor time spent coding and expanding (ns)
+} e22900t22s_codec_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Starts a codec without dictionary.
+ *  
+ * @param[out] codec The codec.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_codec_init( e22900t22s_codec_t * codec );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Loads the static dictionary, a file with bytes typical of the traffic, e.g., segments captured from the link. \n
+ *        Both ends must load the same file, the strings most likely to repeat are best placed at its end.
+ *  
+ * @param[in,out] codec The codec.
+ * @param[in] filename The dictionary file.
+ * 
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_codec_dictionary( e22900t22s_codec_t * codec, const char * filename );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Codes one segment body, it is sent raw when coding does not make it shorter. \n
+ *        The body must not hold 0x00, the segment limiter, and neither does the coded body.
+ *  
+ * @param[in,out] codec The codec.
+ * @param[in] body The segment body, without limiters.
+ * @param[in] len The number of bytes in `body`.
+ * @param[out] out The coded body, it takes at most `len + E22900T22S_CODEC_HEADER` bytes.
+ * 
+ * @return Returns the number of bytes in `out`.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_codec_compress( e22900t22s_codec_t * codec, const uint8_t * body, const size_t len, uint8_t * out );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Expands one coded segment body.
+ *  
+ * @param[in] codec The codec.
+ * @param[in] body The coded body, without limiters.
+ * @param[in] len The number of bytes in `body`.
+ * @param[out] out The segment body, `E22900T22S_CODEC_SEGMENT` bytes are enough.
+ * @param[in] size The capacity of `out`.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, -1 is returned, the body is malformed or needs a dictionary that is not loaded.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int e22900t22s_codec_expand( const e22900t22s_codec_t * codec, const uint8_t * body, const size_t len, uint8_t * out, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Codes every segment of a buffer to write, a segment open at the end is held until the next write closes it. \n
+ *        The bytes outside the segments are dropped.
+ *  
+ * @param[in,out] codec The codec.
+ * @param[in] data The segments, framed by 0x00 limiters.
+ * @param[in] len The number of bytes in `data`.
+ * @param[out] out The coded segments.
+ * @param[in] size The capacity of `out`, `len` plus `E22900T22S_CODEC_HEADER` per segment, and the held segment, is always enough.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, 0 is returned and `errno` is set to indicate the error, ENOBUFS if `out` is too small.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_codec_pack( e22900t22s_codec_t * codec, const uint8_t * data, const size_t len, uint8_t * out, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Expands every segment of a received buffer, a segment open at the end is held until the next buffer closes it. \n
+ *        A segment that does not expand is dropped with its RSSI byte, the bytes outside the segments are dropped.
+ *  
+ * @param[in,out] codec The codec.
+ * @param[in] data The received bytes.
+ * @param[in] len The number of bytes in `data`.
+ * @param[in] rssi An RSSI byte follows every EOF limiter, it is kept after the expanded segment.
+ * @param[out] out The expanded segments.
+ * @param[in] size The capacity of `out`, `e22900t22s_codec_bound` bytes are enough.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, 0 is returned and `errno` is set to indicate the error, ENOBUFS if `out` is too small.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_codec_unpack( e22900t22s_codec_t * codec, const uint8_t * data, const size_t len, const uint8_t rssi, uint8_t * out, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Returns the capacity `e22900t22s_codec_unpack` needs for `len` received bytes, every segment expanding to the longest body.
+ *  
+ * @param[in] codec The codec.
+ * @param[in] len The number of bytes received.
+ * 
+ * @return Returns the capacity (B).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_codec_bound( const e22900t22s_codec_t * codec, const size_t len );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
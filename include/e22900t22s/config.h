@@ -0,0 +1,94 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s/config.h
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_CONFIG_H
+#define E22900T22S_CONFIG_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/core.h>
+#include <e22900t22s/mixip.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define E22900T22S_CONFIG_PATH 64           // Longest element path handled by the loader, example: "rf/modes/wor/cycle"
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data Structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef enum{
+  E22900T22S_FIELD_U8 = 0,
+  E22900T22S_FIELD_U16,
+  E22900T22S_FIELD_FLAG,
+  E22900T22S_FIELD_NAME,
+  E22900T22S_FIELD_BAUDRATE,
+  E22900T22S_FIELD_PARITY,
+  E22900T22S_FIELD_AIRRATE,
+  E22900T22S_FIELD_PACKET,
+  E22900T22S_FIELD_POWER,
+  E22900T22S_FIELD_WORCYCLE,
+} e22900t22s_field_kind_t;
+
+typedef struct{
+  const char *            path;             // Element path below the root, example: "network/id"
+  e22900t22s_field_kind_t kind;             // How the element text is converted
+  size_t                  offset;           // Where the converted value is stored in `e22900t22s_config_t`
+} e22900t22s_field_t;
+
+typedef struct{
+  e22900t22s_eeprom_t  eeprom;
+  e22900t22s_pinmode_t pinout;
+  e22900t22s_mixip_t   translator;
+  uint8_t              adapt;               // Adapts the air rate and packet size to the link SNR, with the peer, it turns the RSSI byte on
+} e22900t22s_config_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Loads the E22900T22S EEPROM, pinout and Translator parameters from the configuration XML file. \n
+ *        The document is parsed once and walked once, every element text is released after being converted. \n
+ *        The parser state is kept between calls, so it is safe to call it repeatedly, elements missing from the file keep the defaults.
+ *  
+ * @param[in] filename The path to the configuration file.
+ * @param[out] config The new filled configuration loadded.
+ * 
+ * @return Upon success, it will fill the `config` struct, and it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_load( const char * filename, e22900t22s_config_t * config );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
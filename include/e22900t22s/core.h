@@ -33,6 +33,13 @@
 
 #include <serialposix.h>
 #include <gpiod.h>
+#include <pthread.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define E22900T22S_REG_BLOCK 9                              // Configuration registers, ADDH up to CRYPTL
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
  * Data structures
@@ -100,10 +107,49 @@ typedef struct{
   gpiod_chip2_t chip;
 } e22900t22s_pinmode_t;
 
+typedef enum{
+  E22900T22S_AUX_WAIT_MS = 10,                              // Maximum time waiting for an AUX edge before reading the line level again
+} e22900t22s_aux_default_t;
+
+typedef struct{
+  uint8_t  events;                                          // AUX line delivers rising edge events (1), or it is polled (0)
+  uint32_t wakes;                                           // Number of times the driver was woken by an AUX rising edge
+  uint32_t last_ns;                                         // Latency between the last AUX rising edge and the driver wake up (ns)
+  uint32_t max_ns;                                          // Maximum wake latency observed (ns)
+  uint64_t total_ns;                                        // Accumulated wake latency, total_ns / wakes gives the average (ns)
+} e22900t22s_aux_t;
+
+typedef enum{
+  E22900T22S_FIXED_HEADER = 3,                              // Address high, address low and channel in front of every fixed transmission (B)
+  E22900T22S_CHANNEL_MAX  = 80,                             // Last channel, 850.125 MHz + 80 x 1 MHz
+} e22900t22s_fixed_default_t;
+
+typedef struct{
+  uint8_t    mode;                                          // Mode the M0/M1 pins are driving, `e22900t22s_mode_t`
+  uint8_t    serial;                                        // The serial line settings below were programmed (1), or are unknown (0)
+  baudRate_t baudrate;                                      // Baud rate programmed on the serial port
+  parity_t   parity;                                        // Parity programmed on the serial port
+  uint8_t    rule;                                          // Read timeout programmed on the serial port (ds)
+  uint32_t   switches;                                      // Mode switches performed
+  uint32_t   elided;                                        // Mode switches skipped, the module was already in the requested mode
+} e22900t22s_state_t;
+
+typedef struct{
+  uint8_t  reg[ E22900T22S_REG_BLOCK ];                     // Last register values confirmed by the module, by a read or by a write echo
+  uint16_t known;                                           // Bit per register, set when `reg` holds the module value
+  uint16_t dirty;                                           // Bit per register, set by the setters that changed a field packed into it
+  uint8_t  pid;                                             // The product information in `cfg.pid` was read (1)
+  uint8_t  running[ E22900T22S_REG_BLOCK ];                 // Values written to the volatile registers (0xC2), valid where `temporary` is set
+  uint16_t temporary;                                       // Bit per register, set while the module runs a value that is not the EEPROM one
+} e22900t22s_shadow_t;
+
 typedef struct{
   e22900t22s_eeprom_t  cfg;
   serial_manager_t     *serial;
   e22900t22s_pinmode_t gpio;
+  e22900t22s_aux_t     aux;
+  e22900t22s_state_t   state;
+  e22900t22s_shadow_t  shadow;
 } e22900t22s_t;
 
 // Mode switching can only be valid when AUX output is 1, otherwise it will delay switching.
@@ -168,11 +214,88 @@ typedef enum{
   E22900T22S_PID_SIZE = 7,
 } e22900t22s_eeprom_mem_t;
 
+typedef enum{
+  E22900T22S_TRANSACTION_OPS = 8,                           // Register operations queued per configuration session
+} e22900t22s_transaction_default_t;
+
+typedef struct{
+  uint8_t   command;                                        // E22900T22S_READ_REG or E22900T22S_SET_REG
+  uint8_t   address;                                        // Starting address
+  uint8_t   length;                                         // Number of registers
+  uint8_t * data;                                           // Where the registers read are stored, owned by the caller
+  uint8_t   value[ E22900T22S_REG_BLOCK ];                    // Copy of the registers to write, ADDH up to CRYPTL
+} e22900t22s_register_op_t;
+
+typedef struct{
+  e22900t22s_t *           dev;
+  e22900t22s_register_op_t op[ E22900T22S_TRANSACTION_OPS ];
+  uint8_t                  length;                          // Number of operations queued
+} e22900t22s_transaction_t;
+
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
  * Lookup tables
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 
- typedef struct{
+// Every table is written once as X( bin, text, key, code ) and expanded into the arrays below and into the direct index tables of the driver
+// bin is the register value and the array index, key is the number carried by the text (the letter for parity) and is what E22900T22S_LUT_HASH hashes
+#define E22900T22S_LUT_HASH_BITS  5
+#define E22900T22S_LUT_HASH( key ) ( (uint32_t) ( (uint32_t) (key) * 0x85EBCA6BU ) >> ( 32 - E22900T22S_LUT_HASH_BITS ) )
+
+#define E22900T22S_LUT_UART( X )        \
+  X( 0, "1200"  , 1200  , B1200   )     \
+  X( 1, "2400"  , 2400  , B2400   )     \
+  X( 2, "4800"  , 4800  , B4800   )     \
+  X( 3, "9600"  , 9600  , B9600   )     \
+  X( 4, "19200" , 19200 , B19200  )     \
+  X( 5, "38400" , 38400 , B38400  )     \
+  X( 6, "57600" , 57600 , B57600  )     \
+  X( 7, "115200", 115200, B115200 )
+
+#define E22900T22S_LUT_PARITY( X )      \
+  X( 0, "8N1", 'N', BPARITY_NONE )      \
+  X( 1, "8O1", 'O', BPARITY_ODD  )      \
+  X( 2, "8E1", 'E', BPARITY_EVEN )
+
+// The module decodes the fourth parity value as 8N1, it is only ever read back
+#define E22900T22S_LUT_PARITY_ALIAS( X ) \
+  X( 3, "8N1", 'N', BPARITY_NONE )
+
+#define E22900T22S_LUT_AIRRATE( X )     \
+  X( 0, "300"  , 300  , B300   )        \
+  X( 1, "1200" , 1200 , B1200  )        \
+  X( 2, "2400" , 2400 , B2400  )        \
+  X( 3, "4800" , 4800 , B4800  )        \
+  X( 4, "9600" , 9600 , B9600  )        \
+  X( 5, "19200", 19200, B19200 )        \
+  X( 6, "38400", 38400, B38400 )        \
+  X( 7, "62500", 62500, B62500 )
+
+#define E22900T22S_LUT_PACKET( X )      \
+  X( 0, "240", 240, E22900T22S_PACKET_240 ) \
+  X( 1, "128", 128, E22900T22S_PACKET_128 ) \
+  X( 2, "64" , 64 , E22900T22S_PACKET_64  ) \
+  X( 3, "32" , 32 , E22900T22S_PACKET_32  )
+
+#define E22900T22S_LUT_POWER( X )       \
+  X( 0, "22", 22, E22900T22S_DBM_22 )   \
+  X( 1, "17", 17, E22900T22S_DBM_17 )   \
+  X( 2, "13", 13, E22900T22S_DBM_13 )   \
+  X( 3, "10", 10, E22900T22S_DBM_10 )
+
+#define E22900T22S_LUT_WORCYCLE( X )    \
+  X( 0, "500" , 500 , E22900T22S_WOR_500  ) \
+  X( 1, "1000", 1000, E22900T22S_WOR_1000 ) \
+  X( 2, "1500", 1500, E22900T22S_WOR_1500 ) \
+  X( 3, "2000", 2000, E22900T22S_WOR_2000 ) \
+  X( 4, "2500", 2500, E22900T22S_WOR_2500 ) \
+  X( 5, "3000", 3000, E22900T22S_WOR_3000 ) \
+  X( 6, "3500", 3500, E22900T22S_WOR_3500 ) \
+  X( 7, "4000", 4000, E22900T22S_WOR_4000 )
+
+#define E22900T22S_LUT_ENTRY( bin, text, key, code )      [ bin ] = { bin, text, code },
+#define E22900T22S_LUT_ENTRY_TEXT( bin, text, key, code ) [ bin ] = { text, code },
+
+typedef struct{
   uint8_t    bin;
   char       text[32];
   baudRate_t code;
@@ -180,14 +303,7 @@ typedef enum{
 
 static const 
 lut_baudrate_t lut_baudrate[ E22900T22S_LUT_SIZE_UART ] = {
-  {0, "1200"  , B1200},
-  {1, "2400"  , B2400},
-  {2, "4800"  , B4800},
-  {3, "9600"  , B9600},
-  {4, "19200" , B19200},
-  {5, "38400" , B38400},
-  {6, "57600" , B57600},
-  {7, "115200", B115200},
+  E22900T22S_LUT_UART( E22900T22S_LUT_ENTRY )
 };
 
 typedef struct{
@@ -198,9 +314,8 @@ typedef struct{
 
 static const 
 lut_parity_t lut_parity[ E22900T22S_LUT_SIZE_PARITY ] = {
-  {0, "8N1", BPARITY_NONE},
-  {1, "8O1", BPARITY_ODD},
-  {2, "8E1", BPARITY_EVEN},
+  E22900T22S_LUT_PARITY( E22900T22S_LUT_ENTRY )
+  E22900T22S_LUT_PARITY_ALIAS( E22900T22S_LUT_ENTRY )
 };
 
 typedef struct{
@@ -211,14 +326,7 @@ typedef struct{
 
 static const 
 lut_airrate_t lut_airrate[ E22900T22S_LUT_SIZE_AIRRATE ] = {
-  {0, "300"  , B300},
-  {1, "1200" , B1200},
-  {2, "2400" , B2400},
-  {3, "4800" , B4800},
-  {4, "9600" , B9600},
-  {5, "19200", B19200},
-  {6, "38400", B38400},
-  {7, "62500", B62500},
+  E22900T22S_LUT_AIRRATE( E22900T22S_LUT_ENTRY )
 };
 
 typedef struct{
@@ -228,10 +336,7 @@ typedef struct{
 
 static const 
 lut_packet_t lut_packetsize[ E22900T22S_LUT_SIZE_PACKET ] = {
-  {"240", E22900T22S_PACKET_240},
-  {"128", E22900T22S_PACKET_128},
-  {"64",  E22900T22S_PACKET_64},
-  {"32",  E22900T22S_PACKET_32},
+  E22900T22S_LUT_PACKET( E22900T22S_LUT_ENTRY_TEXT )
 };
 
 typedef struct{
@@ -241,10 +346,7 @@ typedef struct{
 
 static const 
 lut_power_t lut_power[ E22900T22S_LUT_SIZE_POWER ] = {
-  {"22", E22900T22S_DBM_22},
-  {"17", E22900T22S_DBM_17},
-  {"13", E22900T22S_DBM_13},
-  {"10", E22900T22S_DBM_10},
+  E22900T22S_LUT_POWER( E22900T22S_LUT_ENTRY_TEXT )
 };
 
 typedef struct{
@@ -254,22 +356,32 @@ typedef struct{
 
 static const 
 lut_worcycle_t lut_worcycle[ E22900T22S_LUT_SIZE_WORCYCLE ] = {
-  {"500" , E22900T22S_WOR_500 },
-  {"1000", E22900T22S_WOR_1000},
-  {"1500", E22900T22S_WOR_1500},
-  {"2000", E22900T22S_WOR_2000},
-  {"2500", E22900T22S_WOR_2500},
-  {"3000", E22900T22S_WOR_3000},
-  {"3500", E22900T22S_WOR_3500},
-  {"4000", E22900T22S_WOR_4000},
+  E22900T22S_LUT_WORCYCLE( E22900T22S_LUT_ENTRY_TEXT )
 };
 
+// The numbers behind the register values
+#define E22900T22S_LUT_KEY( bin, text, key, code ) [ bin ] = key,
+
+static const uint32_t lut_airrate_bps[ E22900T22S_LUT_SIZE_AIRRATE ]   = { E22900T22S_LUT_AIRRATE( E22900T22S_LUT_KEY ) };
+static const uint16_t lut_packet_bytes[ E22900T22S_LUT_SIZE_PACKET ]   = { E22900T22S_LUT_PACKET( E22900T22S_LUT_KEY ) };
+static const uint16_t lut_worcycle_ms[ E22900T22S_LUT_SIZE_WORCYCLE ]  = { E22900T22S_LUT_WORCYCLE( E22900T22S_LUT_KEY ) };
+
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
  * Prototypes
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Returns the index of an air rate in `lut_airrate` and `lut_airrate_bps`, the switch over the codes compiles to a jump table.
+ *  
+ * @param[in] baud_code The air rate.
+ * 
+ * @return Returns the index, 0xFF if the module has no such air rate.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t lookup_table_airrate_2bin( const baudRate_t baud_code );
+
  /**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
- * @brief Updates the E22900T22S EEPROM configuration with the object internal configuration.
+ * @brief Updates the E22900T22S EEPROM configuration with the object internal configuration. \n
+ *        Only the smallest contiguous range holding the dirty registers that differ from the shadow image is written, nothing if it is empty.
  *  
  * @param[in] dev The E22900T22S object used to access the serial port and the mode pins.
  * 
@@ -278,6 +390,18 @@ lut_worcycle_t lut_worcycle[ E22900T22S_LUT_SIZE_WORCYCLE ] = {
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int8_t e22900t22s_update_eeprom( e22900t22s_t * dev );
 
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Applies the object internal configuration to the E22900T22S volatile registers (0xC2), the EEPROM is left untouched. \n
+ *        Only the range of readable registers that differ from what the module is running is written, in a single configuration session. \n
+ *        The module returns to the EEPROM configuration on power up, or when the registers are written by `e22900t22s_update_eeprom`.
+ *  
+ * @param[in] dev The E22900T22S object used to access the serial port and the mode pins.
+ * 
+ * @return Upon success, it will update the running parameters, and it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_update_temporary( e22900t22s_t * dev );
+
 /**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
  * @brief Updates the E22900T22S EEPROM configuration or just the E22900T22S object based on the configuration structure passed as argument, depending on the flags.
  *  
@@ -520,6 +644,30 @@ int8_t e22900t22s_set_encryption_key( const uint16_t key, e22900t22s_t * dev );
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int8_t e22900t22s_get_config( e22900t22s_t * dev );
 
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Writes the object EEPROM configuration, reads it back and reads the product information, all in a single configuration session. \n
+ *        It replaces `e22900t22s_update_eeprom` followed by `e22900t22s_get_config`, paying one mode switch instead of three. \n
+ *        Like `e22900t22s_update_eeprom` it only writes the dirty range, and registers confirmed by the write echo are not read back.
+ *  
+ * @param[in,out] dev The E22900T22S object, upon success it will have its EEPROM configuration filled with the device parameters.
+ * 
+ * @return Upon success, it will update the EEPROM parameters, and it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_sync_config( e22900t22s_t * dev );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Reads the device EEPROM configuration and the product information once, and compares it with the object configuration. \n
+ *        Only the registers that differ are programmed, so a restart with the same settings does not pay a write nor wears the EEPROM. \n
+ *        The encryption key registers are write only, they are programmed when a key is configured or when another register differs.
+ *  
+ * @param[in,out] dev The E22900T22S object, with the configuration to be verified, e.g., after `e22900t22s_set_config`.
+ * 
+ * @return Upon success, it returns 0 if the device already held the configuration, or 1 if it was programmed. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_verify_config( e22900t22s_t * dev );
+
 
 /**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
  * @brief Print the paramters inside the E22900T22S object passed as argument.
@@ -545,7 +693,9 @@ const char * e22900t22s_print_config( uint8_t console, e22900t22s_t * dev );
 int8_t e22900t22s_set_gpio_chip_name( const char * chip_name, const uint8_t len, e22900t22s_t * dev );
 
 /**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
- * @brief Sets up the E22900T22S device's operational mode, it might hold the program until it does so.
+ * @brief Sets up the E22900T22S device's operational mode, it might hold the program until it does so. \n
+ *        The M0/M1 pins are written in one bulk update, and if the module is already in `mode` only the serial settings that differ are
+ *        programmed, without waiting for AUX nor the 2 ms idle time, the switch is counted in `dev->state.elided`.
  *  
  * @param[in] mode The mode that the E22900T22S should be working (`e22900t22s_mode_t`).
  * @param[out] dev The E22900T22S object that will get its internal pin structure updated.
@@ -580,15 +730,44 @@ int8_t e22900t22s_gpio_init( const char * chip_name, uint8_t m0, uint8_t m1, uin
 int8_t e22900t22s_gpio_close( e22900t22s_t * dev );
 
 /**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
- * @brief Halts the driver until the AUX pin in the E22900T22S is not busy.
+ * @brief Halts the driver until the AUX pin in the E22900T22S is not busy. \n
+ *        If the AUX line was requested with rising edge events it sleeps on the line event until the edge, re-reading the level every
+ *        `E22900T22S_AUX_WAIT_MS`, and it records the wake latency in `dev->aux`. Otherwise it polls the line level.
  *  
- * @param[in] delay The delay between each check, in microsseconds.
+ * @param[in] delay The delay between each check when polling, in microsseconds.
+ * @param[in] dev The E22900T22S object.
  * 
  * @return Upon success, the device is not busy and it will return 0. \n
  *         Otherwise, -1 is returned and `errno` is set to indicate the error.
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int8_t e22900t22s_while_busy( const uint32_t delay, e22900t22s_t * dev );
 
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Reads the AUX pin once, without waiting. \n
+ *        In normal mode AUX is low while the module buffer holds data to transmit, it rises once the last packet is on the air.
+ *  
+ * @param[in] dev The E22900T22S object.
+ * 
+ * @return Returns 1 if the module is busy, 0 if it is idle. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_is_busy( e22900t22s_t * dev );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Sends `payload` to the module at `address` on `channel`, the module must run fixed point transmission. \n
+ *        The header and the payload are written with one `writev`, the payload is not copied and the header is built on the stack.
+ *  
+ * @param[in] address The address of the destination, 0xFFFF reaches every module on the channel.
+ * @param[in] channel The channel of the destination, ranging between 0 - 80.
+ * @param[in] payload The data to send.
+ * @param[in] length The number of bytes in `payload`, at most the packet size minus `E22900T22S_FIXED_HEADER`.
+ * @param[in] dev The E22900T22S object.
+ * 
+ * @return Upon success, the number of bytes of `payload` written. \n
+ *         Otherwise, 0 is returned and `errno` is set to indicate the error, `EOPNOTSUPP` if fixed point transmission is disabled, `EMSGSIZE` if the payload does not fit in a packet.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_send( const uint16_t address, const uint8_t channel, const uint8_t * payload, const size_t length, e22900t22s_t * dev );
+
 /**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
  * @brief Reads the register(s) starting at the `address` for `length`.
  *  
@@ -630,6 +809,88 @@ uint8_t e22900t22s_write_register( const uint8_t address, const uint8_t length,
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 uint8_t e22900t22s_read_rssi_register( const uint8_t address, const uint8_t length, uint8_t * data, const uint8_t size, e22900t22s_t * dev );
 
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Starts a register transaction, the operations queued are only sent on `e22900t22s_transaction_commit`.
+ *  
+ * @param[out] tr The transaction.
+ * @param[in] dev The E22900T22S object.
+ *  
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_transaction_begin( e22900t22s_transaction_t * tr, e22900t22s_t * dev );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Queues the read of the register(s) starting at the `address` for `length`.
+ *  
+ * @param[in,out] tr The transaction.
+ * @param[in] address The starting EEPROM address.
+ * @param[in] length The number of bytes to read.
+ * @param[out] data Buffer to store the read data, it must stay valid until the commit.
+ * @param[in] size The capacity of `data`.
+ *  
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error, ENOSPC if `E22900T22S_TRANSACTION_OPS` are already queued.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_transaction_read( e22900t22s_transaction_t * tr, const uint8_t address, const uint8_t length, uint8_t * data, const uint8_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Queues the write of `data` to the register(s) starting at the `address` for `length`, `data` is copied.
+ *  
+ * @param[in,out] tr The transaction.
+ * @param[in] address The starting EEPROM address.
+ * @param[in] length The number of bytes to write.
+ * @param[in] data The buffer with the data to write to the E22900T22S.
+ *  
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error, ENOSPC if `E22900T22S_TRANSACTION_OPS` are already queued.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_transaction_write( e22900t22s_transaction_t * tr, const uint8_t address, const uint8_t length, const uint8_t * data );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Queues the write of `data` to the volatile register(s) starting at the `address` for `length`, `data` is copied. \n
+ *        The value is lost on power up, the EEPROM is not written.
+ *  
+ * @param[in,out] tr The transaction.
+ * @param[in] address The starting EEPROM address.
+ * @param[in] length The number of bytes to write.
+ * @param[in] data The buffer with the data to write to the E22900T22S.
+ *  
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error, ENOSPC if `E22900T22S_TRANSACTION_OPS` are already queued.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_transaction_write_temporary( e22900t22s_transaction_t * tr, const uint8_t address, const uint8_t length, const uint8_t * data );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Enters the configuration mode once, runs every operation queued back-to-back, and returns to the normal mode once. \n
+ *        The transaction is emptied, even on failure.
+ *  
+ * @param[in,out] tr The transaction.
+ *  
+ * @return Upon success, every read buffer is filled and it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error, the operations after the failed one are not sent.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_transaction_commit( e22900t22s_transaction_t * tr );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Initializes a lock for state kept in memory shared by the driver processes. \n
+ *        The lock is robust, a process that dies holding it does not leave the others blocked.
+ *  
+ * @param[out] lock The lock, in shared memory.
+ *  
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_shared_mutex_init( pthread_mutex_t * lock );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Takes a lock made by `e22900t22s_shared_mutex_init`. \n
+ *        When its owner died holding it, the lock is made consistent again and the state it guards is used as it was left.
+ *  
+ * @param[in,out] lock The lock.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_shared_mutex_lock( pthread_mutex_t * lock );
+
 #endif
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
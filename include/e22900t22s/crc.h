@@ -0,0 +1,124 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s/crc.h
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_CRC_H
+#define E22900T22S_CRC_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/segment.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef enum{
+  E22900T22S_CRC_TRAILER = 5,                       // CRC32C before the EOF limiter, 7 bits per byte with the top bit set so no byte is a limiter (B)
+} e22900t22s_crc_default_t;
+
+typedef struct{
+  e22900t22s_segment_walker_t writer;               // Segment to seal still open at the end of the previous write
+  e22900t22s_segment_walker_t reader;               // Segment to check still open at the end of the previous read
+  uint32_t passed;                                  // Segments whose trailer matched
+  uint32_t dropped;                                 // Segments removed, the trailer did not match or was missing
+} e22900t22s_crc_state_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Computes the CRC32C (Castagnoli) of `data`. \n
+ *        It uses the SSE4.2 or the ARMv8 CRC instructions when the CPU has them, checked once at the first call, slicing-by-8 tables otherwise.
+ *  
+ * @param[in] data The bytes.
+ * @param[in] len The number of bytes.
+ * 
+ * @return Returns the CRC32C, 0xE3069283 for "123456789".
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t e22900t22s_crc32c( const uint8_t * data, const size_t len );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Computes the CRC32C of `data` with the slicing-by-8 tables, whatever the CPU has. \n
+ *        `e22900t22s_crc32c` must return the same, it is how the instructions are checked against the portable path.
+ *  
+ * @param[in] data The bytes.
+ * @param[in] len The number of bytes.
+ * 
+ * @return Returns the CRC32C.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t e22900t22s_crc32c_sliced( const uint8_t * data, const size_t len );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Copies the segments of `data` to `out`, adding the CRC trailer of each one before its EOF limiter. \n
+ *        Bytes outside the segments are dropped, a segment still open at the end of `data` is held and sealed by the write that closes it.
+ *  
+ * @param[in,out] state Carries the segment split between two writes.
+ * @param[in] data The segments to write, framed by 0x00 limiters.
+ * @param[in] len The number of bytes in `data`.
+ * @param[out] out The sealed segments.
+ * @param[in] size The capacity of `out`, `e22900t22s_crc_bound` bytes are enough.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, 0 is returned and `errno` is set to indicate the error, ENOBUFS if `out` is too small.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_crc_seal( e22900t22s_crc_state_t * state, const uint8_t * data, const size_t len, uint8_t * out, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Checks the trailer of every segment of a received buffer, a segment open at the end is held until the next buffer closes it. \n
+ *        The good segments are copied to `out` without their trailer. A bad one is dropped and its EOF limiter is taken as the next SOF, \n
+ *        so a limiter lost or made up by the air does not take the following segments with it. Bytes outside the segments are dropped.
+ *  
+ * @param[in,out] state Carries the segment split between two buffers, and counts the segments.
+ * @param[in] data The received bytes.
+ * @param[in] len The number of bytes in `data`.
+ * @param[in] rssi The module appends an RSSI byte after every EOF limiter.
+ * @param[out] out The checked segments, each one followed by its RSSI byte.
+ * @param[in] size The capacity of `out`, `e22900t22s_crc_bound` bytes are enough.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, 0 is returned and `errno` is set to indicate the error, ENOBUFS if `out` is too small.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_crc_verify( e22900t22s_crc_state_t * state, const uint8_t * data, const size_t len, const uint8_t rssi, uint8_t * out, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Returns the capacity `e22900t22s_crc_seal` and `e22900t22s_crc_verify` need for `len` bytes, with the segments they hold.
+ *  
+ * @param[in] state The segment checks.
+ * @param[in] len The number of bytes to seal or to check.
+ * 
+ * @return Returns the capacity (B).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_crc_bound( const e22900t22s_crc_state_t * state, const size_t len );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
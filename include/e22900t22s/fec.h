@@ -0,0 +1,212 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s/fec.h
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_FEC_H
+#define E22900T22S_FEC_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/airtime.h>
+#include <e22900t22s/segment.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef enum{
+  E22900T22S_FEC_HEADER  = 5,                       // Block, index and sources of a repair, plus its length byte and COBS code byte over the longest source (B)
+  E22900T22S_FEC_SOURCES = 32,                      // Most segments in a block
+  E22900T22S_FEC_REPAIRS = 16,                      // Most repair segments per block
+  E22900T22S_FEC_SYMBOL  = 257,                     // Length byte and the longest segment body, the translator segment size is a byte (B)
+  E22900T22S_FEC_REPAIR  = 0x80,                    // Index byte flag of a repair segment
+  E22900T22S_FEC_PLAIN   = 0x7F,                    // Block and index byte of a segment outside any block, a frame of the loop process
+} e22900t22s_fec_default_t;
+
+typedef struct{
+  uint8_t  block;                                   // Block being filled, 1 to 255, 0 is the limiter
+  uint8_t  sources;                                 // Sources in the block
+  uint8_t  longest;                                 // Longest source body in the block (B)
+  uint8_t  symbol[ E22900T22S_FEC_SOURCES ][ E22900T22S_FEC_SYMBOL ];   // Length byte, body, zero padding
+  e22900t22s_segment_walker_t walker;               // Source still open at the end of the previous write
+  e22900t22s_segment_walker_t plain;                // Segment outside the blocks still open at the end of the previous frame
+} e22900t22s_fec_encoder_t;
+
+typedef struct{
+  uint8_t  block;                                   // Block being gathered, 0 before the first segment
+  uint8_t  sources;                                 // Sources of the block, known from its first repair, 0 until then
+  uint8_t  length;                                  // Symbol length of the block, known from its first repair (B)
+  uint8_t  next;                                    // Next source handed to the translator, the ones after a gap wait for the repairs
+  uint64_t first;                                   // When the first segment of the block arrived (ns)
+  uint32_t have;                                    // Sources received or recovered, one bit each
+  uint16_t repaired;                                // Repairs received, one bit each
+  uint8_t  rssi[ E22900T22S_FEC_SOURCES ];          // RSSI byte of every source, a recovered one takes the RSSI of the last repair
+  uint8_t  rssi_repair;
+  uint8_t  symbol[ E22900T22S_FEC_SOURCES ][ E22900T22S_FEC_SYMBOL ];
+  uint8_t  repair[ E22900T22S_FEC_REPAIRS ][ E22900T22S_FEC_SYMBOL ];
+  e22900t22s_segment_walker_t walker;               // Received segment still open at the end of the previous buffer
+} e22900t22s_fec_decoder_t;
+
+typedef struct{
+  uint8_t  block;                                   // Sources per block
+  uint8_t  repairs;                                 // Repairs per full block, a shorter block gets its share, at least one
+  e22900t22s_fec_encoder_t encoder;                 // Writer side
+  e22900t22s_fec_decoder_t decoder;                 // Reader side
+  uint64_t hold;                                    // Longest a block is gathered before its gaps are given up, 0 without limit (ns)
+  uint64_t now;                                     // Time of the read being handled (ns)
+  uint32_t sources;                                 // Source segments sent or received
+  uint32_t repaired;                                // Repair segments sent or received
+  uint32_t recovered;                               // Sources rebuilt from the repairs
+  uint32_t lost;                                    // Sources given up, too few segments of their block arrived
+  uint32_t errors;                                  // Received segments without a valid header, they are dropped
+} e22900t22s_fec_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Starts an encoder and a decoder. \n
+ *        The code is a systematic Reed-Solomon erasure code over GF(256), with a Cauchy matrix: \n
+ *        a block of k sources and r repairs is recovered from any k of its segments.
+ *  
+ * @param[out] fec The coder.
+ * @param[in] block The sources per block, 1 to `E22900T22S_FEC_SOURCES`.
+ * @param[in] repairs The repairs per full block, 1 to `E22900T22S_FEC_REPAIRS`.
+ * 
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_fec_init( e22900t22s_fec_t * fec, const uint8_t block, const uint8_t repairs );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Aligns the deadline of the decoder with a new configuration of the module. \n
+ *        A block is gathered for twice the air time of a full block with its repairs, one for the block and one for the data queued ahead of it.
+ *  
+ * @param[in,out] fec The coder.
+ * @param[in] cfg The configuration the module runs.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_fec_tune( e22900t22s_fec_t * fec, const e22900t22s_eeprom_t * cfg );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Adds `c` times `src` to `dst` in GF(256), the product of a byte is looked up by its two nibbles. \n
+ *        It takes 16 bytes at a time with SSSE3, when the CPU has it, or NEON (AArch64), checked once at the first call.
+ *  
+ * @param[in,out] dst The bytes added to.
+ * @param[in] src The bytes multiplied.
+ * @param[in] c The constant.
+ * @param[in] len The number of bytes.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_fec_mul_add( uint8_t * dst, const uint8_t * src, const uint8_t c, const size_t len );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Adds `c` times `src` to `dst` in GF(256) one byte at a time, whatever the CPU has. \n
+ *        `e22900t22s_fec_mul_add` must give the same bytes, it is how the vector path is checked against the portable one.
+ *  
+ * @param[in,out] dst The bytes added to.
+ * @param[in] src The bytes multiplied.
+ * @param[in] c The constant.
+ * @param[in] len The number of bytes.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_fec_mul_add_narrow( uint8_t * dst, const uint8_t * src, const uint8_t c, const size_t len );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Puts every segment of a buffer to write in the open block, with the block and its index in front of the body. \n
+ *        When the block is full its repairs follow, as segments stuffed with COBS, and the next block opens. \n
+ *        A segment open at the end is held until the next write closes it, the bytes outside the segments are dropped.
+ *  
+ * @param[in,out] fec The coder.
+ * @param[in] data The segments, framed by 0x00 limiters.
+ * @param[in] len The number of bytes in `data`.
+ * @param[in] flush Closes the open block at the end of `data`, no more segments are expected soon.
+ * @param[out] out The segments and the repairs.
+ * @param[in] size The capacity of `out`, `e22900t22s_fec_pack_bound` bytes are enough.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, 0 is returned and `errno` is set to indicate the error, ENOBUFS if `out` is too small.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_fec_pack( e22900t22s_fec_t * fec, const uint8_t * data, const size_t len, const uint8_t flush, uint8_t * out, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Copies the segments of `data` to `out` outside any block, for the frames of a process that does not share the open block. \n
+ *        A segment open at the end is held until the next frame closes it, the bytes outside the segments are dropped.
+ *  
+ * @param[in,out] fec The coder, only its segment outside the blocks is kept.
+ * @param[in] data The segments, framed by 0x00 limiters.
+ * @param[in] len The number of bytes in `data`.
+ * @param[out] out The segments, each one with its plain header.
+ * @param[in] size The capacity of `out`, `len` plus 2 bytes per segment, and the held segment, is always enough.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, 0 is returned and `errno` is set to indicate the error, ENOBUFS if `out` is too small.
+  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_fec_plain( e22900t22s_fec_t * fec, const uint8_t * data, const size_t len, uint8_t * out, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Returns the capacity `e22900t22s_fec_pack` needs for `len` bytes to write, every block closing with its repairs.
+ *  
+ * @param[in] fec The coder.
+ * @param[in] len The number of bytes to write.
+ * 
+ * @return Returns the capacity (B).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_fec_pack_bound( const e22900t22s_fec_t * fec, const size_t len );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Hands the sources of every block in order, rebuilding the lost ones once enough repairs arrive. \n
+ *        A source after a gap waits until the gap is recovered, a segment of the next block arrives, or the block is held past its deadline, \n
+ *        then the gap is given up. The repairs are removed, every source keeps its RSSI byte.
+ *  
+ * @param[in,out] fec The coder.
+ * @param[in] data The received bytes.
+ * @param[in] len The number of bytes in `data`.
+ * @param[in] rssi The module appends an RSSI byte after every EOF limiter.
+ * @param[in] now The time of the read (ns).
+ * @param[out] out The sources, framed by 0x00 limiters.
+ * @param[in] size The capacity of `out`, `e22900t22s_fec_bound` bytes are enough.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, 0 is returned and `errno` is set to indicate the error, ENOBUFS if `out` is too small.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_fec_unpack( e22900t22s_fec_t * fec, const uint8_t * data, const size_t len, const uint8_t rssi, const uint64_t now, uint8_t * out, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Returns the capacity `e22900t22s_fec_unpack` needs for `len` received bytes, every waiting source handed over with them.
+ *  
+ * @param[in] fec The coder.
+ * @param[in] len The number of bytes received.
+ * 
+ * @return Returns the capacity (B).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_fec_bound( const e22900t22s_fec_t * fec, const size_t len );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
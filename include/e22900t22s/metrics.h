@@ -34,6 +34,13 @@
 #include <e22900t22s/core.h>
 #include <e22900t22s/mixip.h>
 
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define E22900T22S_METRICS_SHM   "/e22900t22s_%s_metrics"   // Shared memory object of the per packet metrics, %s is the driver name
+#define E22900T22S_METRICS_MAGIC 0xE22900A1
+
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
  * Data structures
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
@@ -44,19 +51,65 @@ typedef struct{
 } e22900t22s_rssi_t;
 
 typedef struct{
-  float Pr;                                        // Received signal power (dBm)
-  float SNR;                                       // Signal to Noise ratio (dBm)
+  uint64_t ts;                                     // Monotonic clock when the packet RSSI byte, or its EOF without <rssi>, was read (ns)
+  float    Pr;                                     // Received signal power, NaN without <rssi> (dBm)
+  float    SNR;                                    // Signal to Noise ratio, NaN without <rssi> (dBm)
+  float    No;                                     // Noise power used to compute the SNR (dBm)
+  uint32_t length;                                 // Segment length, from the previous RSSI byte up to the EOF limiter (B)
 } e22900t22s_rx_metric_t;
 
 typedef struct{
   float                       No;                  // Noise power (dBm) (permanent)
-  e22900t22s_rx_metric_t      sample[ NSEG_MAX ];  // Received signals power per data buffer arrival (temporary)
-  uint8_t                     n_samples;           // Number of samples captured (temporary)
   uint32_t                    n_sent;              // Number of packets sent over time (permanent)
   uint32_t                    n_received;          // Number of packets received over time (permanent)
-  e22900t22s_mixip_segments_t tmp;                 // Auxilary struct to understand the limits of segments
+  uint32_t                    n_held;              // Number of transmissions held by the duty cycle (permanent)
+  uint32_t                    held_ms;             // Time the transmissions were held (ms) (permanent)
+  uint32_t                    n_dropped;           // Number of segments dropped by the CRC check (permanent)
+  uint32_t                    n_recovered;         // Number of segments rebuilt by the FEC, without retransmission (permanent)
+  uint32_t                    n_acked;             // Number of segments the peer acknowledged, with the ARQ (permanent)
+  uint32_t                    n_resent;            // Number of segments sent again by the ARQ (permanent)
+  uint32_t                    n_abandoned;         // Number of segments the ARQ gave up (permanent)
 } e22900t22s_log_t; 
 
+typedef enum{
+  E22900T22S_NOISE_WINDOW       = 8,               // Samples the minimum filter looks back on
+  E22900T22S_NOISE_INTERVAL_MIN = 1,               // Sampling interval while the noise moves (s)
+  E22900T22S_NOISE_INTERVAL_MAX = 64,              // Sampling interval once the noise is steady (s)
+} e22900t22s_noise_default_t;
+
+#define E22900T22S_NOISE_ALPHA     0.25f           // Weight of the newest minimum in the average
+#define E22900T22S_NOISE_THRESHOLD 3.0f            // Distance (dB) from the average that brings the interval back to the minimum
+
+typedef struct{
+  float    sample[ E22900T22S_NOISE_WINDOW ];      // Last samples (dBm)
+  uint8_t  index;                                  // Slot of the next sample
+  uint8_t  count;                                  // Samples in the window
+  uint16_t interval;                               // Time until the next sample (s)
+  float    floor;                                  // Minimum of the window, packets on the air while sampling only raise the RSSI (dBm)
+  float    No;                                     // Moving average of the minimum, the value published (dBm)
+} e22900t22s_noise_t;
+
+typedef enum{
+  E22900T22S_METRICS_SLOTS = 4096,                 // Packets of history kept, must be a power of 2
+} e22900t22s_metrics_default_t;
+
+typedef struct{
+  uint64_t               seq;                      // 2 * position + 1 while being written, 2 * position + 2 once complete
+  e22900t22s_rx_metric_t metric;
+} e22900t22s_metrics_slot_t;
+
+typedef struct{
+  uint32_t                  magic;                 // E22900T22S_METRICS_MAGIC once the driver initialized the ring
+  uint32_t                  slots;                 // E22900T22S_METRICS_SLOTS of the driver that created it
+  uint64_t                  head;                  // Number of packets written since the ring was created
+  e22900t22s_metrics_slot_t slot[ E22900T22S_METRICS_SLOTS ];
+} e22900t22s_metrics_ring_t;
+
+typedef struct{
+  uint64_t cursor;                                 // Next position to read, 0 reads all the history still in the ring
+  uint64_t lost;                                   // Packets overwritten by the driver before this reader got to them
+} e22900t22s_metrics_reader_t;
+
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
  * Prototypes
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
@@ -77,8 +130,8 @@ int8_t e22900t22s_get_rssi( e22900t22s_rssi_t * rssi, e22900t22s_t * dev );
  *  
  * @param[in] dev The E22900T22S object.
  * @param[in] tmp Activate the configuration temporary to perform the retrive. \n 
- *                If tmp is greater than 0 it will set the EEPROM ambient noise value, retrive the noise and in the end reset the ambient noise.
- *                If tmp is 0 it will perform the operation without changing the ambient noise EEPROM value, but this has to be activated, otherwise error is retuned.
+ *                If tmp is greater than 0 it will enable the ambient noise in the volatile registers, retrive the noise and in the end restore it, the EEPROM is not written. \n
+ *                If tmp is 0 it will perform the operation without changing the ambient noise value, but this has to be activated, otherwise EPERM is retuned.
  * 
  * @return Upon success, it returns the Noise power in dBm. \n 
  *         Otherwise, 0 is returned and `errno` is set to indicate the error. \n
@@ -95,6 +148,86 @@ float e22900t22s_get_noise_rssi( e22900t22s_t * dev, uint8_t tmp );
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 float e22900t22s_get_signal_rssi( const uint8_t data );
 
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Starts the noise floor tracker from a first measurement.
+ *  
+ * @param[out] noise The tracker.
+ * @param[in] No The noise power measured at startup (dBm).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_noise_init( e22900t22s_noise_t * noise, const float No );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Adds a noise sample to the tracker, the average follows the minimum of the last `E22900T22S_NOISE_WINDOW` samples. \n
+ *        The interval to the next sample is reset to `E22900T22S_NOISE_INTERVAL_MIN` if the sample is `E22900T22S_NOISE_THRESHOLD` away from the average, otherwise it doubles up to `E22900T22S_NOISE_INTERVAL_MAX`.
+ *  
+ * @param[in,out] noise The tracker.
+ * @param[in] sample The noise power read (dBm).
+ * 
+ * @return Returns the noise floor to publish (dBm).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+float e22900t22s_noise_update( e22900t22s_noise_t * noise, const float sample );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Publishes the noise floor to the processes sharing `logs`, the store is atomic so a reader never sees a torn value.
+ *  
+ * @param[in] logs The shared logs.
+ * @param[in] No The noise floor (dBm).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_noise_publish( e22900t22s_log_t * logs, const float No );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Reads the last noise floor published.
+ *  
+ * @param[in] logs The shared logs.
+ * 
+ * @return Returns the noise floor (dBm).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+float e22900t22s_noise_current( const e22900t22s_log_t * logs );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Opens the per packet metrics ring, a named shared memory object (`E22900T22S_METRICS_SHM`) that outlives the driver processes.
+ *  
+ * @param[in] name The driver name, e.g., lorarx.
+ * @param[in] create If greater than 0 the ring is created (or reset) writable, this is what the driver does. \n
+ *                   If 0 an existing ring is mapped read-only, this is what a monitor does.
+ * 
+ * @return Upon success, it returns the mapped ring. \n
+ *         Otherwise, NULL is returned and `errno` is set to indicate the error, ENODATA if the ring was not initialized by a driver.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+e22900t22s_metrics_ring_t * e22900t22s_metrics_open( const char * name, const uint8_t create );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Appends a packet metric, single producer. It never waits for the readers, the oldest packet is overwritten when the ring is full.
+ *  
+ * @param[in] ring The metrics ring.
+ * @param[in] metric The packet metric.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_metrics_push( e22900t22s_metrics_ring_t * ring, const e22900t22s_rx_metric_t * metric );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Reads the next packet metric without locks, any number of readers can follow the ring each with its own `reader`. \n
+ *        Slots overwritten before or while being copied are detected with the sequence numbers, skipped and counted in `reader->lost`.
+ *  
+ * @param[in] ring The metrics ring.
+ * @param[in,out] reader The reader position.
+ * @param[out] metric The packet metric read.
+ * 
+ * @return Returns 1 if `metric` was filled, 0 if there is nothing new. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_metrics_pop( const e22900t22s_metrics_ring_t * ring, e22900t22s_metrics_reader_t * reader, e22900t22s_rx_metric_t * metric );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Unmaps the per packet metrics ring.
+ *  
+ * @param[in] ring The metrics ring.
+ * @param[in] name If not NULL, the shared memory object of the driver `name` is also removed.
+ * 
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_metrics_close( e22900t22s_metrics_ring_t * ring, const char * name );
+
 /**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 
 #endif
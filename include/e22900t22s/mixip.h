@@ -32,12 +32,18 @@
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 
 #include <mixip.h>
+#include <e22900t22s/core.h>
+#include <e22900t22s/crc.h>
+#include <e22900t22s/codec.h>
+#include <e22900t22s/rohc.h>
+#include <e22900t22s/fec.h>
+#include <e22900t22s/arq.h>
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
  * Definitions
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 
-#define NSEG_MAX 4
+#define NSEG_MAX 4                          // Initial capacity of the segments array
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
  * Data Structures
@@ -46,22 +52,35 @@
 typedef enum{
   E22900T22S_DEF_RB  = 1,
   E22900T22S_DEF_SLS = 32,
+
+  E22900T22S_MIXIP_LIMITERS = 2,            // Limiters around every segment (B)
+  E22900T22S_MIXIP_HEADER   = E22900T22S_FIXED_HEADER, // Address and channel in front of every packet in fixed transmission (B)
+  E22900T22S_MIXIP_WINDOW   = 1000,         // Air time the ring buffer slots hold (ms)
+  E22900T22S_MODULE_BUFFER  = 1000,         // Serial buffer of the module (B)
 } e22900t22s_mixip_default_t;
 
 typedef struct{
   translator_parameters_t   tmp;
   translator_parameters_t * ptr;
+  uint8_t                   crc;            // Every segment carries a CRC trailer, `E22900T22S_CRC_TRAILER` bytes of the packet are kept for it
+  uint8_t                   compress;       // Every segment is coded, `E22900T22S_CODEC_HEADER` bytes of the packet are kept for the codec byte
+  char                      dictionary[NAME_MAX];   // Static dictionary of the codec, none if empty
+  uint8_t                   rohc;           // The IPv4/UDP headers of every datagram are compressed, `E22900T22S_ROHC_HEADER` bytes of the packet are kept for the marker
+  uint8_t                   fec_block;      // Segments per FEC block
+  uint8_t                   fec_repairs;    // Repair segments per FEC block, 0 disables it, `E22900T22S_FEC_HEADER` bytes of the packet are kept for the block header
+  uint8_t                   arq;            // Lost segments are sent again, `E22900T22S_ARQ_HEADER` bytes of the packet are kept for the sequence number
 } e22900t22s_mixip_t;
 
 typedef struct{
   size_t  end;
-  uint8_t count;
 } mixip_segments_t;
 
 typedef struct{
-  mixip_segments_t segment[NSEG_MAX];
-  uint8_t          length;
-  uint8_t          first;                   // If the previous buffer had in its end EOF, this `first` flag identifies that, because the first bytes can represent RSSI for example
+  mixip_segments_t * segment;               // Caller supplied array, it is grown with realloc when a buffer holds more segments than `capacity`
+  size_t             capacity;              // Number of entries allocated in `segment`
+  size_t             length;                // Number of segments identified in the last buffer
+  uint8_t            count;                 // Limiters identified and not yet paired, carried to the next buffer
+  uint8_t            first;                 // If the previous buffer had in its end EOF, this `first` flag identifies that, because the first bytes can represent RSSI for example
 } e22900t22s_mixip_segments_t;
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
@@ -93,37 +112,40 @@ int8_t e22900t22s_connect_mixip( const char * name, e22900t22s_mixip_t * config
 int8_t e22900t22s_load_mixip_config( const char * filename, e22900t22s_mixip_t * config );
 
 /**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
- * @brief Attempts to update the translator with the parameters loaded into the `config` struct.
+ * @brief Attempts to update the translator with the parameters loaded into the `config` struct. \n
+ *        If `radio` is given, the segment size and the slots are first derived from it: a segment with its limiters fills exactly one RF packet, \n
+ *        less the fixed transmission header, the CRC trailer, the codec byte, the header compression marker and the FEC header, and the ring buffer holds `E22900T22S_MIXIP_WINDOW` of air time without exceeding the module buffer, \n
+ *        counting the RSSI byte the receiver appends to every packet.
  *  
- * @param[in] config The new configuration of the Translator.
+ * @param[in,out] config The new configuration of the Translator, `tmp` is updated with the values derived.
+ * @param[in] radio The radio configuration the module runs, or NULL to apply `config` as it is.
  * 
  * @return Upon success, it will update the Translator, and return 0. \n
  *         Otherwise, -1 is returned and `errno` is set to indicate the error.
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
-int8_t e22900t22s_update_mixip_config( const e22900t22s_mixip_t * config );
+int8_t e22900t22s_update_mixip_config( e22900t22s_mixip_t * config, const e22900t22s_eeprom_t * radio );
 
 /**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
- * @brief Attempts to update the translator with the parameters loaded into the `config` struct.
- *  
- * @param[in] config The new configuration of the Translator.
- * 
- * @return Upon success, it will update the Translator, and return 0. \n
- *         Otherwise, -1 is returned and `errno` is set to indicate the error.
- **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
-int8_t e22900t22s_update_mixip_config( const e22900t22s_mixip_t * config );
-
-/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
- * @brief Attempts to identify the segments in `data`, and fills a struct `e22900t22s_mixip_segments_t` before returning.
+ * @brief Attempts to identify the segments in `data`, and fills a struct `e22900t22s_mixip_segments_t` before returning. \n
+ *        The limiters are searched 16/32 bytes at a time (SSE2, AVX2 or NEON, depending on the target) with a scalar tail. \n
+ *        A zero initialized `st` is valid, `st->segment` is (re)allocated as needed and released with `e22900t22s_free_segments`.
  *  
  * @param[in] data The data obtained from the E22.
  * @param[in] length The `data` length.
  * @param[in,out] e22900t22s_mixip_segments_t The struct that will be filled with the segments identified, it will start looking at final position.
  * 
- * @return Upon success, it will update the Translator, and return 0. \n
+ * @return Upon success, it will fill `st` with every segment found, and return 0. \n
  *         Otherwise, -1 is returned and `errno` is set to indicate the error.
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int8_t e22900t22s_identify_segments( const uint8_t * data, const size_t len, e22900t22s_mixip_segments_t * st );
 
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Releases the segments array grown by `e22900t22s_identify_segments`, and resets `st`.
+ *  
+ * @param[in,out] st The segments struct to release.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_free_segments( e22900t22s_mixip_segments_t * st );
+
 #endif
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
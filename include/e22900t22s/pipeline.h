@@ -0,0 +1,197 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s/pipeline.h
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_PIPELINE_H
+#define E22900T22S_PIPELINE_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/airtime.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef struct{
+  uint16_t capacity;                                // Serial buffer of the module (B)
+  uint64_t empty;                                   // When the module buffer is expected to be empty, monotonic (ns)
+  uint64_t start;                                   // When the first write was handed to the module, monotonic (ns)
+  uint64_t bytes;                                   // Bytes handed to the module
+  uint64_t airtime;                                 // Air time of those bytes (us)
+  uint32_t stalls;                                  // Writes held because the module buffer was full
+  uint64_t stalled;                                 // Time the writes were held (us)
+  uint32_t resyncs;                                 // Times AUX reported the buffer empty before the estimate did
+} e22900t22s_pipeline_t;
+
+typedef struct{
+  pthread_mutex_t       lock;                       // Shared by the writer and the loop processes, both write to the module
+  e22900t22s_duty_t     duty;                       // Air time spent per sub-band by every write
+  e22900t22s_pipeline_t pipeline;                   // Estimated occupancy of the module buffer, every write included
+} e22900t22s_transmit_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Starts the transmit pipeline with the module buffer empty.
+ *  
+ * @param[out] pipeline The pipeline.
+ * @param[in] capacity The serial buffer of the module (B).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_pipeline_init( e22900t22s_pipeline_t * pipeline, const uint16_t capacity );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Estimates the bytes still waiting in the module buffer, the buffer drains at the air time of the configuration.
+ *  
+ * @param[in] pipeline The pipeline.
+ * @param[in] cfg The configuration the module runs.
+ * @param[in] now Monotonic time (ns).
+ * 
+ * @return Returns the bytes in the module buffer.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_pipeline_queued( const e22900t22s_pipeline_t * pipeline, const e22900t22s_eeprom_t * cfg, const uint64_t now );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Synchronizes the estimate with an idle AUX, the module buffer is empty whatever the estimate says.
+ *  
+ * @param[in,out] pipeline The pipeline.
+ * @param[in] now Monotonic time (ns).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_pipeline_idle( e22900t22s_pipeline_t * pipeline, const uint64_t now );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Accounts a write of `len` bytes, it goes on the air after the bytes already in the module buffer.
+ *  
+ * @param[in,out] pipeline The pipeline.
+ * @param[in] cfg The configuration the module runs.
+ * @param[in] len The bytes written to the module.
+ * @param[in] now Monotonic time (ns).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_pipeline_push( e22900t22s_pipeline_t * pipeline, const e22900t22s_eeprom_t * cfg, const size_t len, const uint64_t now );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Computes how long a write of `len` bytes has to wait for room in the module buffer.
+ *  
+ * @param[in] pipeline The pipeline.
+ * @param[in] cfg The configuration the module runs.
+ * @param[in] len The bytes of the next write.
+ * @param[in] now Monotonic time (ns).
+ * 
+ * @return Returns the wait (us), 0 if the bytes fit now.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t e22900t22s_pipeline_room( const e22900t22s_pipeline_t * pipeline, const e22900t22s_eeprom_t * cfg, const size_t len, const uint64_t now );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Computes the goodput achieved since the first write, up to the moment the module buffer empties.
+ *  
+ * @param[in] pipeline The pipeline.
+ * @param[in] cfg The configuration the module runs.
+ * @param[in] now Monotonic time (ns).
+ * @param[out] ratio If not NULL, the goodput over the configured air rate.
+ * 
+ * @return Returns the goodput (bps), 0 before the first write.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+float e22900t22s_pipeline_goodput( const e22900t22s_pipeline_t * pipeline, const e22900t22s_eeprom_t * cfg, const uint64_t now, float * ratio );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Starts the state every process writing to the module charges, the duty cycle buckets full and the module buffer empty.
+ *  
+ * @param[out] transmit The state, in memory shared by the writer and the loop processes.
+ * @param[in] capacity The serial buffer of the module (B).
+ * @param[in] now Monotonic time (ns).
+ * 
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_transmit_init( e22900t22s_transmit_t * transmit, const uint16_t capacity, const uint64_t now );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Charges the air time of a write of `len` bytes to the sub-band of the channel, see `e22900t22s_duty_reserve`.
+ *  
+ * @param[in,out] transmit The state.
+ * @param[in] cfg The configuration the module runs.
+ * @param[in] len The bytes of the write.
+ * @param[in] now Monotonic time (ns).
+ * @param[out] airtime If not NULL, the air time of the write (us).
+ * 
+ * @return Returns how long the write has to wait to respect the duty cycle (us), 0 if it can go now.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t e22900t22s_transmit_reserve( e22900t22s_transmit_t * transmit, const e22900t22s_eeprom_t * cfg, const size_t len, const uint64_t now, uint64_t * airtime );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Returns the air time that can still be spent right away in the sub-band of the channel, see `e22900t22s_duty_budget`.
+ *  
+ * @param[in,out] transmit The state.
+ * @param[in] cfg The configuration the module runs.
+ * @param[in] now Monotonic time (ns).
+ * 
+ * @return Returns the air time available (us).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t e22900t22s_transmit_budget( e22900t22s_transmit_t * transmit, const e22900t22s_eeprom_t * cfg, const uint64_t now );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Estimates the bytes still waiting in the module buffer, see `e22900t22s_pipeline_queued`.
+ *  
+ * @param[in] transmit The state.
+ * @param[in] cfg The configuration the module runs.
+ * @param[in] now Monotonic time (ns).
+ * 
+ * @return Returns the bytes in the module buffer.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_transmit_queued( e22900t22s_transmit_t * transmit, const e22900t22s_eeprom_t * cfg, const uint64_t now );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Accounts a write of `len` bytes to the module buffer, see `e22900t22s_pipeline_push`.
+ *  
+ * @param[in,out] transmit The state.
+ * @param[in] cfg The configuration the module runs.
+ * @param[in] len The bytes written to the module.
+ * @param[in] idle AUX reported the module idle before the write, the estimate is synchronized first.
+ * @param[in] now Monotonic time (ns).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_transmit_push( e22900t22s_transmit_t * transmit, const e22900t22s_eeprom_t * cfg, const size_t len, const uint8_t idle, const uint64_t now );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Computes how long a write of `len` bytes has to wait for room in the module buffer, the wait is counted as a stall.
+ *  
+ * @param[in,out] transmit The state.
+ * @param[in] cfg The configuration the module runs.
+ * @param[in] len The bytes of the write.
+ * @param[in] now Monotonic time (ns).
+ * 
+ * @return Returns the wait (us), 0 if the bytes fit now.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t e22900t22s_transmit_room( e22900t22s_transmit_t * transmit, const e22900t22s_eeprom_t * cfg, const size_t len, const uint64_t now );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
@@ -0,0 +1,175 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s/reactor.h
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_REACTOR_H
+#define E22900T22S_REACTOR_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/core.h>
+#include <e22900t22s/config.h>
+#include <e22900t22s/metrics.h>
+#include <e22900t22s/airtime.h>
+#include <e22900t22s/pipeline.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef enum{
+  E22900T22S_DEVICES        = 4,                    // Modules one reactor drives
+  E22900T22S_REACTOR_EVENTS = 16,                   // Events handled per wait
+  E22900T22S_RX_CHUNK       = 1024,                 // Bytes read from a serial port per readable event
+  E22900T22S_TX_QUEUE       = 8,                    // Writes waiting per module, must be a power of 2
+  E22900T22S_TX_SLOT        = 240,                  // Largest write, one RF packet of the biggest size (B)
+  E22900T22S_NOISE_COMMAND  = 6,                    // RSSI read command, 0xC0 to 0xC3, address and length (B)
+  E22900T22S_NOISE_REPLY    = 4,                    // Its reply, 0xC1, address, length and the noise byte (B)
+  E22900T22S_NOISE_WAIT     = 100,                  // Longest wait for the reply before the sample is given up (ms)
+} e22900t22s_reactor_default_t;
+
+typedef enum{
+  E22900T22S_SOURCE_SERIAL = 0,                     // The serial port is readable, or writable while a write is pending
+  E22900T22S_SOURCE_AUX    = 1,                     // AUX rising edge, the module buffer is empty
+  E22900T22S_SOURCE_NOISE  = 2,                     // Timer of the noise floor tracker
+  E22900T22S_SOURCE_TX     = 3,                     // Timer of a write held by the duty cycle or by the module buffer
+} e22900t22s_source_t;
+
+typedef struct e22900t22s_device e22900t22s_device_t;
+
+// Called from the reactor with the bytes read from the module, `data` is only valid during the call
+typedef void ( *e22900t22s_receive_t )( e22900t22s_device_t * device, const uint8_t * data, const size_t length, void * user );
+
+typedef struct{
+  uint8_t  data[ E22900T22S_TX_SLOT ];
+  uint16_t length;
+  uint16_t done;                                    // Bytes already written to the serial port
+  uint8_t  charged;                                 // The air time was taken from the duty cycle
+  uint64_t ready;                                   // When the duty cycle lets the write go, monotonic (ns)
+} e22900t22s_tx_t;
+
+struct e22900t22s_device{
+  e22900t22s_t          dev;
+  e22900t22s_log_t      logs;                       // Counters and noise floor of this module
+  e22900t22s_noise_t    noise;
+  e22900t22s_duty_t     duty;
+  e22900t22s_pipeline_t pipeline;
+  e22900t22s_tx_t       queue[ E22900T22S_TX_QUEUE ];
+  uint8_t               head;                       // Oldest write in `queue`
+  uint8_t               count;                      // Writes in `queue`
+  uint8_t               writable;                   // Waiting for the serial port to take more bytes
+  uint8_t               sampling;                   // The RSSI command is written, the writes wait for its reply
+  uint8_t               replied;                    // Bytes of the reply matched so far, taken out of the received data
+  uint8_t               open;                       // A segment is open in the received data
+  uint8_t               filled;                     // The open segment has a body, a limiter now closes it
+  uint8_t               awaiting;                   // The next received byte is the RSSI of the segment just closed
+  int                   aux;                        // AUX event descriptor, -1 if the line is polled
+  int                   noise_timer;
+  int                   tx_timer;
+  e22900t22s_receive_t  receive;
+  void                  * user;
+};
+
+// The reactor only moves bytes between the modules and their serial ports, it does not run the link stages of the MIXIP driver (run_e22900t22s.c):
+// no ROHC, codec, FEC, CRC or ARQ. The writes go out as they are queued and `receive` gets what the module delivers, RSSI bytes included,
+// a caller wanting those stages runs them around `e22900t22s_reactor_send` and its `receive`.
+typedef struct{
+  int                 epoll;
+  uint8_t             count;                        // Modules registered
+  e22900t22s_device_t device[ E22900T22S_DEVICES ];
+} e22900t22s_reactor_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Creates an empty reactor.
+ *  
+ * @param[out] reactor The reactor.
+ * 
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_reactor_init( e22900t22s_reactor_t * reactor );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Configures a module and registers its serial port, its AUX line and its timers in the reactor. \n
+ *        The module is configured with blocking calls, then its serial port is switched to non-blocking for the reactor. \n
+ *        The ambient noise is enabled in the volatile registers, the noise floor is then sampled with the RSSI command and its reply, without blocking.
+ *  
+ * @param[in,out] reactor The reactor.
+ * @param[in] serial The serial port of the module, already open, it must outlive the reactor.
+ * @param[in] config The configuration of the module, as loaded by `e22900t22s_load`.
+ * @param[in] receive Called with the bytes the module receives, it can be NULL.
+ * @param[in] user Handed back to `receive`.
+ * 
+ * @return Upon success, it returns the index of the module in the reactor. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error, ENOSPC if `E22900T22S_DEVICES` are registered.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_reactor_add( e22900t22s_reactor_t * reactor, serial_manager_t * serial, const e22900t22s_config_t * config, e22900t22s_receive_t receive, void * user );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Queues a write to a module, it goes out as soon as the duty cycle and the module buffer allow it.
+ *  
+ * @param[in,out] reactor The reactor.
+ * @param[in] index The index of the module.
+ * @param[in] data The bytes to write, they are copied.
+ * @param[in] length The number of bytes, at most `E22900T22S_TX_SLOT`.
+ * 
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error, EAGAIN if the queue of the module is full.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_reactor_send( e22900t22s_reactor_t * reactor, const uint8_t index, const uint8_t * data, const size_t length );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Waits for the events of every module and serves them, reception, transmission and the noise floor tracker.
+ *  
+ * @param[in,out] reactor The reactor.
+ * @param[in] timeout The longest wait (ms), -1 waits forever.
+ * 
+ * @return Upon success, it returns the number of events served, 0 on timeout. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int e22900t22s_reactor_run( e22900t22s_reactor_t * reactor, const int timeout );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Releases the modules and the descriptors of the reactor, the serial ports stay open.
+ *  
+ * @param[in,out] reactor The reactor.
+ * 
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_reactor_close( e22900t22s_reactor_t * reactor );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
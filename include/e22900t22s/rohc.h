@@ -0,0 +1,143 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s/rohc.h
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_ROHC_H
+#define E22900T22S_ROHC_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/segment.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef enum{
+  E22900T22S_ROHC_RAW  = 0x01,                      // The segment follows as it is
+  E22900T22S_ROHC_COBS = 0x02,                      // The segment is a datagram with its headers compressed, stuffed again with COBS
+} e22900t22s_rohc_id_t;
+
+typedef enum{
+  E22900T22S_ROHC_IR   = 0,                         // Full headers, they (re)start the context
+  E22900T22S_ROHC_CO8  = 1,                         // Headers from the context, 8 bits of IP identification
+  E22900T22S_ROHC_CO16 = 2,                         // Headers from the context, the whole IP identification
+} e22900t22s_rohc_kind_t;
+
+typedef enum{
+  E22900T22S_ROHC_HEADER   = 2,                     // Marker byte in front of every segment, and the packet type byte a full header adds (B)
+  E22900T22S_ROHC_IPV4     = 20,                    // IPv4 header without options (B)
+  E22900T22S_ROHC_UDP      = 8,                     // UDP header (B)
+  E22900T22S_ROHC_HEADERS  = E22900T22S_ROHC_IPV4 + E22900T22S_ROHC_UDP,
+  E22900T22S_ROHC_SEGMENT  = 256,                   // Longest segment body, the translator segment size is a byte (B)
+  E22900T22S_ROHC_CONTEXTS = 8,                     // Flows compressed at once, the context id takes 3 bits of the packet type byte
+  E22900T22S_ROHC_STARTUP  = 3,                     // First packets of a context sent with full headers, in case some are lost
+  E22900T22S_ROHC_REFRESH  = 32,                    // Every this many packets a flow sends full headers again, a receiver that lost its context recovers
+  E22900T22S_ROHC_WINDOW   = 128,                   // Largest IP identification step sent in 8 bits, the rest of the 256 covers lost packets
+} e22900t22s_rohc_default_t;
+
+typedef struct{
+  uint8_t  used;
+  uint8_t  startup;                                 // Packets still to send with full headers
+  uint8_t  headers[ E22900T22S_ROHC_HEADERS ];      // Headers of the last packet of the flow, the reference of the next one
+  uint32_t packets;                                 // Packets of the flow since its context started
+  uint32_t stamp;                                   // Last use, the least recently used context is replaced
+} e22900t22s_rohc_context_t;
+
+typedef struct{
+  e22900t22s_rohc_context_t compressor[ E22900T22S_ROHC_CONTEXTS ];   // Writer side, found by hashing the addresses and the ports
+  e22900t22s_rohc_context_t decompressor[ E22900T22S_ROHC_CONTEXTS ]; // Reader side, found by the context id
+  uint32_t clock;                                   // Stamps of the compressor contexts
+  e22900t22s_segment_walker_t writer;               // Segment to compress still open at the end of the previous write
+  e22900t22s_segment_walker_t reader;               // Received segment still open at the end of the previous buffer
+  uint32_t datagrams;                               // Datagrams sent or received with compressed headers
+  uint32_t refreshes;                               // Of them, the ones with full headers
+  uint32_t passed;                                  // Segments that are not a whole IPv4/UDP datagram, sent as they are
+  uint64_t headers_in;                              // Header bytes before compression
+  uint64_t headers_out;                             // Header bytes after compression, the packet type byte and the fields sent
+  uint32_t errors;                                  // Received segments without context, or whose headers failed the check, they are dropped
+} e22900t22s_rohc_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Starts a header compressor and decompressor without contexts.
+ *  
+ * @param[out] rohc The compressor.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_rohc_init( e22900t22s_rohc_t * rohc );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Compresses the headers of every segment of a buffer to write, a segment open at the end is held until the next write closes it. \n
+ *        Only a segment holding one whole IPv4/UDP datagram, stuffed with COBS, is compressed, any other goes raw behind its marker byte. \n
+ *        The bytes outside the segments are dropped.
+ *  
+ * @param[in,out] rohc The compressor.
+ * @param[in] data The segments, framed by 0x00 limiters.
+ * @param[in] len The number of bytes in `data`.
+ * @param[out] out The segments with their headers compressed.
+ * @param[in] size The capacity of `out`, `len` plus `E22900T22S_ROHC_HEADER` per segment, and the held segment, is always enough.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, 0 is returned and `errno` is set to indicate the error, ENOBUFS if `out` is too small.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_rohc_pack( e22900t22s_rohc_t * rohc, const uint8_t * data, const size_t len, uint8_t * out, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Restores the headers of every segment of a received buffer, a segment open at the end is held until the next buffer closes it. \n
+ *        A segment that can not be restored is dropped with its RSSI byte, the bytes outside the segments are dropped.
+ *  
+ * @param[in,out] rohc The decompressor.
+ * @param[in] data The received bytes.
+ * @param[in] len The number of bytes in `data`.
+ * @param[in] rssi An RSSI byte follows every EOF limiter, it is kept after the restored segment.
+ * @param[out] out The segments as the translator wrote them.
+ * @param[in] size The capacity of `out`, `e22900t22s_rohc_bound` bytes are enough.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, 0 is returned and `errno` is set to indicate the error, ENOBUFS if `out` is too small.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_rohc_unpack( e22900t22s_rohc_t * rohc, const uint8_t * data, const size_t len, const uint8_t rssi, uint8_t * out, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Returns the capacity `e22900t22s_rohc_unpack` needs for `len` received bytes, every segment getting back whole headers.
+ *  
+ * @param[in] rohc The decompressor.
+ * @param[in] len The number of bytes received.
+ * 
+ * @return Returns the capacity (B).
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_rohc_bound( const e22900t22s_rohc_t * rohc, const size_t len );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
@@ -0,0 +1,144 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s/segment.h
+ * 
+ * @version   1.0
+ *
+ * @date      17-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_SEGMENT_H
+#define E22900T22S_SEGMENT_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef enum{
+  E22900T22S_SEGMENT_BODY   = 516,                  // Longest body gathered, twice a translator segment with the headers of every stage (B)
+  E22900T22S_SEGMENT_RESYNC = 1,                    // Returned by a check, the segment is rejected and its EOF limiter opens the next one
+} e22900t22s_segment_default_t;
+
+typedef struct{
+  uint8_t  open;                                    // A SOF limiter arrived, its EOF did not
+  uint8_t  awaiting;                                // The segment in `body` is closed, its RSSI byte comes next
+  uint8_t  overlong;                                // The open segment outgrew `body`, it is dropped at its EOF
+  uint16_t length;                                  // Bytes in `body`
+  uint8_t  body[ E22900T22S_SEGMENT_BODY ];         // Segment still open at the end of the previous buffer, without its limiters
+  uint32_t stray;                                   // Bytes outside any segment, dropped
+  uint32_t dropped;                                 // Segments longer than `body`, dropped
+} e22900t22s_segment_walker_t;
+
+// Tells whether a closed segment is valid before its RSSI byte is taken, 0 if it is, `E22900T22S_SEGMENT_RESYNC` otherwise
+typedef int8_t ( *e22900t22s_segment_check_t )( void * stage, const uint8_t * body, const size_t len );
+
+// Handles a whole segment, appending its output to `out` at `*length`, 0 upon success, -1 with `errno` set otherwise
+typedef int8_t ( *e22900t22s_segment_handler_t )( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi,
+                                                uint8_t * out, size_t * length, const size_t size );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Finds the next 0x00 limiter.
+ *  
+ * @param[in] data The bytes.
+ * @param[in] from The first byte looked at.
+ * @param[in] len The number of bytes in `data`.
+ * 
+ * @return Returns the position of the limiter, `len` if there is none.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_segment_limiter( const uint8_t * data, const size_t from, const size_t len );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Stuffs `data` with COBS, so it holds no 0x00 and can go inside a segment.
+ *  
+ * @param[in] data The bytes.
+ * @param[in] len The number of bytes in `data`.
+ * @param[out] out The stuffed bytes, it takes at most `len + len / 254 + 1` bytes.
+ * 
+ * @return Returns the number of bytes in `out`.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_segment_stuff( const uint8_t * data, const size_t len, uint8_t * out );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Restores the bytes stuffed by `e22900t22s_segment_stuff`.
+ *  
+ * @param[in] data The stuffed bytes.
+ * @param[in] len The number of bytes in `data`.
+ * @param[out] out The bytes.
+ * @param[in] size The capacity of `out`.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, -1 is returned, the bytes are not valid COBS or do not fit in `out`.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int e22900t22s_segment_unstuff( const uint8_t * data, const size_t len, uint8_t * out, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Appends a segment to `out`, between its limiters and followed by its RSSI byte.
+ *  
+ * @param[in] body The segment body.
+ * @param[in] len The number of bytes in `body`.
+ * @param[in] rssi The RSSI byte.
+ * @param[in] with_rssi The RSSI byte is appended.
+ * @param[out] out The output.
+ * @param[in,out] length The bytes in `out`, it grows by the segment.
+ * @param[in] size The capacity of `out`.
+ * 
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to ENOBUFS.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_segment_emit( const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Hands every whole segment of `data` to a stage, the one still open at the end waits in the walker until a later buffer closes it. \n
+ *        Only a limiter opens a segment, the bytes outside the segments are dropped, and two limiters in a row open a single segment. \n
+ *        With `rssi`, a segment is handed over with the byte after its EOF limiter, even when it only comes in the next buffer.
+ *  
+ * @param[in,out] walker The segment split between two buffers, all zero before the first one.
+ * @param[in] data The bytes.
+ * @param[in] len The number of bytes in `data`.
+ * @param[in] rssi The module appends an RSSI byte after every EOF limiter.
+ * @param[in] check If not NULL, runs on every closed segment first, a rejected one is not handed over and its EOF limiter opens the next one.
+ * @param[in] handler Runs on every whole segment.
+ * @param[in,out] stage Given to `check` and `handler`.
+ * @param[out] out The output of `handler`.
+ * @param[in] size The capacity of `out`.
+ * 
+ * @return Upon success, the number of bytes in `out`. \n
+ *         Otherwise, 0 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t e22900t22s_segment_walk( e22900t22s_segment_walker_t * walker, const uint8_t * data, const size_t len, const uint8_t rssi, e22900t22s_segment_check_t check,
+                                e22900t22s_segment_handler_t handler, void * stage, uint8_t * out, const size_t size );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
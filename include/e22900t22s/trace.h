@@ -0,0 +1,163 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s/trace.h
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_TRACE_H
+#define E22900T22S_TRACE_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define E22900T22S_TRACE_ENV "E22900T22S_TRACE"    // Environment variable holding the verbosity, `e22900t22s_trace_level_t`
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef enum{
+  E22900T22S_TRACE_OFF   = 0,                      // Nothing is recorded, the hot path only compares the level
+  E22900T22S_TRACE_ERROR = 1,
+  E22900T22S_TRACE_INFO  = 2,                      // Counters and noise floor
+  E22900T22S_TRACE_DEBUG = 3,                      // Per packet samples
+} e22900t22s_trace_level_t;
+
+typedef enum{
+  E22900T22S_TRACE_SENT,                           // `counter` packets sent
+  E22900T22S_TRACE_RECEIVED,                       // `counter` packets received
+  E22900T22S_TRACE_SAMPLE,                         // `index` sample with `Pr`, `No`, `SNR`
+  E22900T22S_TRACE_NOISE,                          // Noise floor `No`, from the tracker also the sample `Pr`, the halt `counter` (us) and the next interval `index` (s)
+  E22900T22S_TRACE_ERRNO,                          // Driver error, `counter` holds errno
+  E22900T22S_TRACE_STARTUP,                        // EEPROM check at startup, `index` is 1 if it was programmed, `counter` the time it took (us)
+  E22900T22S_TRACE_ADAPT,                          // Rate controller, `index` air rate << 8 | packet size, `counter` control frame type << 8 | epoch, 0 once applied with `SNR`
+  E22900T22S_TRACE_DUTY,                           // Transmission held by the duty cycle of sub-band `index` for `counter` (us), `Pr` is the air time of the transmission (ms)
+  E22900T22S_TRACE_CODEC,                          // Segments of one buffer coded (`SNR` 1) or expanded (`SNR` 0), `index` bytes before, `Pr` bytes after, `counter` processor time (ns)
+  E22900T22S_TRACE_ARQ,                            // Retransmission of `index` segments by the loop process, `Pr` the timeout (ms), `counter` segments given up
+} e22900t22s_trace_event_t;
+
+typedef enum{
+  E22900T22S_TRACE_SLOTS    = 1024,                // Number of records, must be a power of 2
+  E22900T22S_TRACE_IDLE_US  = 20000,               // Sleep of the drain process when the ring is empty
+} e22900t22s_trace_default_t;
+
+typedef struct{
+  uint64_t ts;                                     // Wall clock (ns), formatted only by the drain
+  int32_t  pid;                                    // Producer process
+  uint16_t event;                                  // `e22900t22s_trace_event_t`
+  uint16_t index;                                  // Sample index inside the buffer
+  float    Pr;                                     // Received signal power (dBm)
+  float    SNR;                                    // Signal to Noise ratio (dB)
+  float    No;                                     // Noise power (dBm)
+  uint32_t counter;                                // Counter or errno, depending on `event`
+} e22900t22s_trace_record_t;
+
+typedef struct{
+  uint32_t                  seq;                   // Slot sequence, tells the producers and the drain whose turn it is
+  e22900t22s_trace_record_t record;
+} e22900t22s_trace_slot_t;
+
+typedef struct{
+  uint32_t                level;                   // Current `e22900t22s_trace_level_t`
+  uint32_t                head;                    // Next position to be claimed by a producer
+  uint32_t                tail;                    // Next position to be formatted by the drain
+  uint32_t                dropped;                 // Records discarded because the ring was full
+  pid_t                   drain;                   // Drain process, 0 if not running
+  e22900t22s_trace_slot_t slot[ E22900T22S_TRACE_SLOTS ];
+} e22900t22s_trace_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Creates the binary trace ring in shared memory, so every process forked afterwards (reader, writer, loop) can record into it.
+ *  
+ * @param[in] level The verbosity, records above it are discarded before touching the ring.
+ * 
+ * @return Upon success, it returns the trace ring. \n
+ *         Otherwise, NULL is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+e22900t22s_trace_t * e22900t22s_trace_init( const e22900t22s_trace_level_t level );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Forks the drain process, it formats the records into `stream` off the data path, and ends with its parent.
+ *  
+ * @param[in] trace The trace ring.
+ * @param[in] stream Where the records are printed, e.g., stdout.
+ * 
+ * @return Upon success, it returns 0, or 1 if the trace is off and no process was created. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_trace_start( e22900t22s_trace_t * trace, FILE * stream );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Records an event, it never allocates, formats or blocks. If the ring is full the record is dropped and counted.
+ *  
+ * @param[in] trace The trace ring, NULL is accepted and ignored.
+ * @param[in] level The verbosity of the record.
+ * @param[in] event The `e22900t22s_trace_event_t`.
+ * @param[in] index The sample index.
+ * @param[in] Pr The received signal power (dBm).
+ * @param[in] SNR The signal to noise ratio (dB).
+ * @param[in] No The noise power (dBm).
+ * @param[in] counter The counter or errno.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void e22900t22s_trace( e22900t22s_trace_t * trace, const e22900t22s_trace_level_t level, const e22900t22s_trace_event_t event, const uint16_t index,
+                       const float Pr, const float SNR, const float No, const uint32_t counter );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Formats every record available in the ring into `stream`.
+ *  
+ * @param[in] trace The trace ring.
+ * @param[in] stream Where the records are printed.
+ * 
+ * @return Returns the number of records formatted.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t e22900t22s_trace_drain( e22900t22s_trace_t * trace, FILE * stream );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Stops the drain process, formatting what is left, and unmaps the ring.
+ *  
+ * @param[in] trace The trace ring.
+ * 
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t e22900t22s_trace_close( e22900t22s_trace_t * trace );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
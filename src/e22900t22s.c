@@ -25,20 +25,32 @@
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 
 #include <e22900t22s/core.h>
+#include <e22900t22s/config.h>
 #include <e22900t22s/metrics.h>
 #include <e22900t22s/mixip.h>
 #include <errno.h>
 #include <string.h>
 #include <stddef.h>
 #include <unistd.h>
+#include <time.h>
+#include <poll.h>
+#include <sys/uio.h>
 #include <libxml2/libxml/parser.h>
 #include <libxml2/libxml/tree.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
  * Prototypes
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 
 int8_t update_parameter( e22900t22s_t * dev, void * value, size_t dimension, size_t offset, uint8_t cfg );
+uint16_t register_mask( size_t offset );
+int8_t dirty_range( e22900t22s_t * dev, uint8_t * image, uint8_t * first, uint8_t * length );
+int8_t temporary_range( e22900t22s_t * dev, uint8_t * image, uint8_t * first, uint8_t * length );
 int8_t check( e22900t22s_t * dev );
 
 uint8_t lookup_table_baudrate_2bin( const baudRate_t baud_code );
@@ -51,7 +63,6 @@ const char * lookup_table_parity_2text( const parity_t parity_code );
 parity_t lookup_table_parity_2code( const uint8_t parity_bin );
 parity_t lookup_table_parity_fromtext_2code( const char * parity_text );
 
-uint8_t lookup_table_airrate_2bin( const baudRate_t baud_code );
 const char * lookup_table_airrate_2text( const baudRate_t baud_code );
 baudRate_t lookup_table_airrate_2code( const uint8_t baud_bin );
 baudRate_t lookup_table_airrate_fromtext_2code( const char * baud_text );
@@ -69,15 +80,65 @@ int8_t gpiod_init( const char * name, gpiod_chip2_t * chip );
 int8_t gpiod_pin_mode( gpiod_chip2_t * chip, gpiod_line2_t * gpio, uint8_t direction );
 int8_t gpiod_digital_write( gpiod_line2_t * gpio, uint8_t value );
 int8_t gpiod_digital_read( gpiod_line2_t * gpio );
+int8_t gpiod_pin_events( gpiod_chip2_t * chip, gpiod_line2_t * gpio );
+int8_t gpiod_pin_mode_pair( gpiod_chip2_t * chip, gpiod_line2_t * first, gpiod_line2_t * second );
+int8_t gpiod_digital_write_pair( gpiod_line2_t * first, gpiod_line2_t * second, uint8_t first_value, uint8_t second_value );
+int8_t serial_line( const baudRate_t baudrate, const parity_t parity, const uint8_t rule, e22900t22s_t * dev );
+
+int8_t register_range( const uint8_t address, const uint8_t length );
+int8_t register_exchange( e22900t22s_register_op_t * op, e22900t22s_t * dev );
+int8_t transaction_queue( e22900t22s_transaction_t * tr, const uint8_t command, const uint8_t address, const uint8_t length, const uint8_t * data );
+void pack_registers( const e22900t22s_eeprom_t * cfg, uint8_t * reg );
+void unpack_registers( const uint8_t * reg, e22900t22s_eeprom_t * cfg );
 
 float convertRSSI_frombin_2dbm( uint8_t code );
 
+
+int8_t load_node( xmlNode * node, char * path, const size_t length, e22900t22s_config_t * config );
+void load_field( const e22900t22s_field_t * field, const char * text, e22900t22s_config_t * config );
+
+static inline void segment_limiter( e22900t22s_mixip_segments_t * st, const size_t i );
+
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
  * Global variables
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 
 uint32_t delay_us = 100;
 
+// Every value element of the configuration file, the paths are relative to the <e22900t22s> root
+static const e22900t22s_field_t config_fields[] = {
+  { "address",             E22900T22S_FIELD_U16,      offsetof( e22900t22s_config_t, eeprom.address ) },
+  { "network/id",          E22900T22S_FIELD_U8,       offsetof( e22900t22s_config_t, eeprom.netid ) },
+  { "network/key",         E22900T22S_FIELD_U16,      offsetof( e22900t22s_config_t, eeprom.encryption ) },
+  { "serial/baudrate",     E22900T22S_FIELD_BAUDRATE, offsetof( e22900t22s_config_t, eeprom.baudrate ) },
+  { "serial/parity",       E22900T22S_FIELD_PARITY,   offsetof( e22900t22s_config_t, eeprom.parity ) },
+  { "rf/baudrate",         E22900T22S_FIELD_AIRRATE,  offsetof( e22900t22s_config_t, eeprom.airrate ) },
+  { "rf/size",             E22900T22S_FIELD_PACKET,   offsetof( e22900t22s_config_t, eeprom.packet_size ) },
+  { "rf/power",            E22900T22S_FIELD_POWER,    offsetof( e22900t22s_config_t, eeprom.transmit_power ) },
+  { "rf/channel",          E22900T22S_FIELD_U8,       offsetof( e22900t22s_config_t, eeprom.channel ) },
+  { "rf/adapt",            E22900T22S_FIELD_FLAG,     offsetof( e22900t22s_config_t, adapt ) },
+  { "rf/modes/fixed",      E22900T22S_FIELD_FLAG,     offsetof( e22900t22s_config_t, eeprom.fixed ) },
+  { "rf/modes/repeater",   E22900T22S_FIELD_FLAG,     offsetof( e22900t22s_config_t, eeprom.repeater ) },
+  { "rf/modes/lbt",        E22900T22S_FIELD_FLAG,     offsetof( e22900t22s_config_t, eeprom.lbt ) },
+  { "rf/modes/wor/state",  E22900T22S_FIELD_FLAG,     offsetof( e22900t22s_config_t, eeprom.wor ) },
+  { "rf/modes/wor/cycle",  E22900T22S_FIELD_WORCYCLE, offsetof( e22900t22s_config_t, eeprom.wor_cycle ) },
+  { "rf/stats/rssi",       E22900T22S_FIELD_FLAG,     offsetof( e22900t22s_config_t, eeprom.rssi ) },
+  { "rf/stats/noise",      E22900T22S_FIELD_FLAG,     offsetof( e22900t22s_config_t, eeprom.ambient_noise ) },
+  { "pin/chip",            E22900T22S_FIELD_NAME,     offsetof( e22900t22s_config_t, pinout.chip.name ) },
+  { "pin/aux",             E22900T22S_FIELD_U8,       offsetof( e22900t22s_config_t, pinout.aux.offset ) },
+  { "pin/m0",              E22900T22S_FIELD_U8,       offsetof( e22900t22s_config_t, pinout.m0.offset ) },
+  { "pin/m1",              E22900T22S_FIELD_U8,       offsetof( e22900t22s_config_t, pinout.m1.offset ) },
+  { "translator/slots",    E22900T22S_FIELD_U8,       offsetof( e22900t22s_config_t, translator.tmp.size_rb ) },
+  { "translator/srsize",   E22900T22S_FIELD_U8,       offsetof( e22900t22s_config_t, translator.tmp.size_sls ) },
+  { "translator/crc",      E22900T22S_FIELD_FLAG,     offsetof( e22900t22s_config_t, translator.crc ) },
+  { "translator/compress", E22900T22S_FIELD_FLAG,     offsetof( e22900t22s_config_t, translator.compress ) },
+  { "translator/dictionary", E22900T22S_FIELD_NAME,   offsetof( e22900t22s_config_t, translator.dictionary ) },
+  { "translator/rohc",     E22900T22S_FIELD_FLAG,     offsetof( e22900t22s_config_t, translator.rohc ) },
+  { "translator/fec/block",   E22900T22S_FIELD_U8,    offsetof( e22900t22s_config_t, translator.fec_block ) },
+  { "translator/fec/repairs", E22900T22S_FIELD_U8,    offsetof( e22900t22s_config_t, translator.fec_repairs ) },
+  { "translator/arq",      E22900T22S_FIELD_FLAG,     offsetof( e22900t22s_config_t, translator.arq ) },
+};
+
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
  * Functions
  **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
@@ -112,9 +173,93 @@ update_parameter( e22900t22s_t * dev, void * value, size_t dimension, size_t off
   }
 
   memcpy( struct_field, (uint8_t *) value, dimension );
+  if( cfg )
+    dev->shadow.dirty |= register_mask( offset );
   return 0;
 }
 
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint16_t
+register_mask( size_t offset ){
+  switch( offset ){
+    case offsetof(e22900t22s_eeprom_t, address):
+      return 1 << E22900T22S_MEM_ADDH | 1 << E22900T22S_MEM_ADDL;
+    case offsetof(e22900t22s_eeprom_t, netid):
+      return 1 << E22900T22S_MEM_NETID;
+    case offsetof(e22900t22s_eeprom_t, baudrate):
+    case offsetof(e22900t22s_eeprom_t, parity):
+    case offsetof(e22900t22s_eeprom_t, airrate):
+      return 1 << E22900T22S_MEM_REG0;
+    case offsetof(e22900t22s_eeprom_t, packet_size):
+    case offsetof(e22900t22s_eeprom_t, ambient_noise):
+    case offsetof(e22900t22s_eeprom_t, transmit_power):
+      return 1 << E22900T22S_MEM_REG1;
+    case offsetof(e22900t22s_eeprom_t, channel):
+      return 1 << E22900T22S_MEM_REG2;
+    case offsetof(e22900t22s_eeprom_t, rssi):
+    case offsetof(e22900t22s_eeprom_t, fixed):
+    case offsetof(e22900t22s_eeprom_t, repeater):
+    case offsetof(e22900t22s_eeprom_t, lbt):
+    case offsetof(e22900t22s_eeprom_t, wor):
+    case offsetof(e22900t22s_eeprom_t, wor_cycle):
+      return 1 << E22900T22S_MEM_REG3;
+    case offsetof(e22900t22s_eeprom_t, encryption):
+      return 1 << E22900T22S_MEM_CRYPTH | 1 << E22900T22S_MEM_CRYPTL;
+    default:
+      return 0;
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+dirty_range( e22900t22s_t * dev, uint8_t * image, uint8_t * first, uint8_t * length ){
+  pack_registers( &dev->cfg, image );
+
+  // Registers never confirmed by the module are written as well, their content is unknown
+  const uint16_t all = ( 1 << E22900T22S_REG_BLOCK ) - 1;
+  uint16_t dirty = (uint16_t) ( ( dev->shadow.dirty | ~dev->shadow.known ) & all );
+  for( uint8_t i = 0 ; i < E22900T22S_REG_BLOCK ; ++i )
+    if( ( dev->shadow.known >> i & 1 ) && dev->shadow.reg[i] == image[i] )
+      dirty = (uint16_t) ( dirty & ~( 1 << i ) );
+
+  dev->shadow.dirty = dirty;
+  if( !dirty ){
+    *length = 0;
+    return 0;
+  }
+
+  *first = (uint8_t) __builtin_ctz( dirty );
+  *length = (uint8_t) ( 32 - __builtin_clz( dirty ) - *first );
+  return 1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t 
+temporary_range( e22900t22s_t * dev, uint8_t * image, uint8_t * first, uint8_t * length ){
+  pack_registers( &dev->cfg, image );
+
+  // Compared with what the module runs, the key registers are left out since they cannot be confirmed
+  uint16_t diff = 0;
+  for( uint8_t i = 0 ; i <= E22900T22S_MEM_REG3 ; ++i ){
+    uint16_t bit = (uint16_t) ( 1 << i );
+    if( dev->shadow.temporary & bit ){
+      if( dev->shadow.running[i] != image[i] )
+        diff |= bit;
+    }
+    else if( !( dev->shadow.known & bit ) || dev->shadow.reg[i] != image[i] )
+      diff |= bit;
+  }
+
+  if( !diff ){
+    *length = 0;
+    return 0;
+  }
+
+  *first = (uint8_t) __builtin_ctz( diff );
+  *length = (uint8_t) ( 32 - __builtin_clz( diff ) - *first );
+  return 1;
+}
+
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int8_t 
 e22900t22s_set_address_identification( const uint16_t _address, e22900t22s_t * dev ){
@@ -219,6 +364,7 @@ e22900t22s_set_config( const e22900t22s_eeprom_t * config, const uint8_t update,
     return -1;
   }
   memcpy( &dev->cfg, config, sizeof(e22900t22s_eeprom_t) );
+  dev->shadow.dirty = ( 1 << E22900T22S_REG_BLOCK ) - 1;
 
   if( update )
     return e22900t22s_update_eeprom( dev );
@@ -238,13 +384,16 @@ e22900t22s_set_pinout( const e22900t22s_pinmode_t * pinout, e22900t22s_t * dev )
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int8_t 
-e22900t22s_load_config( const char * filename, e22900t22s_eeprom_t * config, e22900t22s_pinmode_t * pinout ){
-  if( !pinout || !config || !filename ){
+e22900t22s_load( const char * filename, e22900t22s_config_t * config ){
+  if( !filename || !config ){
     errno = EINVAL;
     return -1;
   }
-  
-  xmlDoc * docfile = xmlReadFile( filename, NULL, 0 );
+
+  // Idempotent, the parser globals are kept for the next call instead of being torn down with xmlCleanupParser
+  xmlInitParser( );
+
+  xmlDoc * docfile = xmlReadFile( filename, NULL, XML_PARSE_NOBLANKS | XML_PARSE_NONET );
   if( !docfile ){
     errno = EINVAL;
     perror("xmlReadFile");
@@ -252,211 +401,119 @@ e22900t22s_load_config( const char * filename, e22900t22s_eeprom_t * config, e22
   }
   
   xmlNode * root_element = xmlDocGetRootElement(docfile);
-  if( !root_element ){
+  if( !root_element || strcmp( (const char *) root_element->name, "e22900t22s" ) ){
     errno = EINVAL;
     perror("xmlDocGetRootElement");
     xmlFreeDoc( docfile );
     return -1;
   }
 
-  memset( config, 0, sizeof(e22900t22s_eeprom_t) );
-  memset( pinout, 0, sizeof(e22900t22s_pinmode_t) );
-
-  xmlNode * address = NULL;
-  xmlNode * network = NULL;
-  xmlNode * serial = NULL;
-  xmlNode * rf = NULL;
-  xmlNode * pin = NULL;
-
-  if( !strcmp( (char *) root_element->name, "e22900t22s" ) ){
-    for( xmlNode * current_node = root_element->children ; current_node != NULL ; current_node = current_node->next ){
-      if( XML_ELEMENT_NODE == current_node->type ){
-        if( !strcmp( (char *) current_node->name, "address" ) )
-          address = current_node;
-        if( !strcmp( (char *) current_node->name, "network" ) )
-          network = current_node;
-        if( !strcmp( (char *) current_node->name, "serial" ) )
-          serial = current_node;
-        if( !strcmp( (char *) current_node->name, "rf" ) )
-          rf = current_node;        
-        if( !strcmp( (char *) current_node->name, "pin" ) )
-          pin = current_node;        
-      }        
-    }
-  }  
-    
-  if( NULL != address )
-    config->address = (uint16_t) atoi( (const char *) xmlNodeGetContent( address ) );
-
-  if( NULL != network ){
-    xmlNode * id = NULL;
-    xmlNode * key = NULL;
-
-    for( xmlNode * current_node = network->children ; current_node != NULL ; current_node = current_node->next ){
-      if( XML_ELEMENT_NODE == current_node->type ){
-        if( !strcmp( (char *) current_node->name, "id" ) )
-          id = current_node;        
-        if( !strcmp( (char *) current_node->name, "key" ) )
-          key = current_node;        
-      }
-    }
+  memset( config, 0, sizeof(e22900t22s_config_t) );
+  config->translator.tmp.size_rb = E22900T22S_DEF_RB;
+  config->translator.tmp.size_sls = E22900T22S_DEF_SLS;
 
-    if( NULL != id )
-      config->netid = (uint8_t) atoi( (const char *) xmlNodeGetContent( id ) );
-    if( NULL != key )
-      config->encryption = (uint16_t) atoi( (const char *) xmlNodeGetContent( key ) );
-  }
+  char path[E22900T22S_CONFIG_PATH];
+  path[0] = '\0';
 
-  if( NULL != serial ){
-    xmlNode * baudrate;
-    xmlNode * parity;
+  int8_t ret = load_node( root_element, path, 0, config );
+  xmlFreeDoc( docfile );
+  return ret;
+}
 
-    for( xmlNode * current_node = serial->children ; current_node != NULL ; current_node = current_node->next ){
-      if( XML_ELEMENT_NODE == current_node->type ){
-        if( !strcmp( (char *) current_node->name, "baudrate" ) )
-          baudrate = current_node;        
-        if( !strcmp( (char *) current_node->name, "parity" ) )
-          parity = current_node;        
-      }
-    }    
-
-    if( NULL != baudrate )
-      config->baudrate = lookup_table_baudrate_fromtext_2code( (const char *) xmlNodeGetContent( baudrate ) );
-    if( NULL != parity )
-      config->parity = lookup_table_parity_fromtext_2code( (const char *) xmlNodeGetContent( parity ) );    
-  }
-
-  if( NULL != rf ){
-    xmlNode * baudrate = NULL;
-    xmlNode * size = NULL;
-    xmlNode * power = NULL;
-    xmlNode * channel = NULL;
-    xmlNode * modes = NULL;
-    xmlNode * stats = NULL;
-
-    for( xmlNode * current_node = rf->children ; current_node != NULL ; current_node = current_node->next ){
-      if( XML_ELEMENT_NODE == current_node->type ){
-        if( !strcmp( (char *) current_node->name, "baudrate" ) )
-          baudrate = current_node;        
-        if( !strcmp( (char *) current_node->name, "size" ) )
-          size = current_node;        
-        if( !strcmp( (char *) current_node->name, "power" ) )
-          power = current_node;        
-        if( !strcmp( (char *) current_node->name, "channel" ) )
-          channel = current_node;        
-        if( !strcmp( (char *) current_node->name, "modes" ) )
-          modes = current_node;        
-        if( !strcmp( (char *) current_node->name, "stats" ) )
-          stats = current_node;        
-      }
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t 
+load_node( xmlNode * node, char * path, const size_t length, e22900t22s_config_t * config ){
+  for( xmlNode * current_node = node->children ; current_node != NULL ; current_node = current_node->next ){
+    if( XML_ELEMENT_NODE != current_node->type )
+      continue;
+
+    int len = snprintf( path + length, E22900T22S_CONFIG_PATH - length, length ? "/%s" : "%s", (const char *) current_node->name );
+    if( 0 > len || (size_t) len >= E22900T22S_CONFIG_PATH - length ){
+      errno = ENAMETOOLONG;
+      return -1;
     }
 
-    if( NULL != baudrate )
-      config->airrate = lookup_table_airrate_fromtext_2code( (const char *) xmlNodeGetContent( baudrate ) );
-    if( NULL != size )
-      config->packet_size = lookup_table_packet_fromtext( (const char *) xmlNodeGetContent( size ) );
-    if( NULL != power )
-      config->transmit_power = lookup_table_power_fromtext( (const char *) xmlNodeGetContent( power ) );
-    if( NULL != channel )
-      config->channel = (uint8_t) atoi( (const char *) xmlNodeGetContent( channel ) );
-
-    if( NULL != modes ){
-      xmlNode * fixed = NULL;
-      xmlNode * repeater = NULL;
-      xmlNode * lbt = NULL;
-      xmlNode * wor = NULL;
-
-      for( xmlNode * current_node = modes->children ; current_node != NULL ; current_node = current_node->next ){
-        if( XML_ELEMENT_NODE == current_node->type ){
-          if( !strcmp( (char *) current_node->name, "fixed" ) )
-            fixed = current_node;        
-          if( !strcmp( (char *) current_node->name, "repeater" ) )
-            repeater = current_node;        
-          if( !strcmp( (char *) current_node->name, "lbt" ) )
-            lbt = current_node;        
-          if( !strcmp( (char *) current_node->name, "wor" ) )
-            wor = current_node;        
-        }
-      }
-
-      if( NULL != fixed )
-        config->fixed = !atoi( (const char *) xmlNodeGetContent( fixed ) ) ? 0 : 1;
-      if( NULL != repeater )
-        config->repeater = !atoi( (const char *) xmlNodeGetContent( repeater ) ) ? 0 : 1;
-      if( NULL != lbt )
-        config->lbt = !atoi( (const char *) xmlNodeGetContent( lbt ) ) ? 0 : 1;
-
-      if( NULL != wor ){
-        xmlNode * state;
-        xmlNode * cycle;
-
-        for( xmlNode * current_node = wor->children ; current_node != NULL ; current_node = current_node->next ){
-          if( XML_ELEMENT_NODE == current_node->type ){
-            if( !strcmp( (char *) current_node->name, "state" ) )
-              state = current_node;        
-            if( !strcmp( (char *) current_node->name, "cycle" ) )
-              cycle = current_node;        
-          }
-        }
+    // Elements with element children are sections, the others hold a value
+    if( NULL != xmlFirstElementChild( current_node ) ){
+      if( -1 == load_node( current_node, path, length + (size_t) len, config ) )
+        return -1;
+      continue;
+    }
 
-        if( NULL != state )
-          config->wor = !atoi( (const char *) xmlNodeGetContent( state ) ) ? 0 : 1;
-        if( NULL != cycle )
-          config->wor_cycle = lookup_table_worcycle_fromtext( (const char *) xmlNodeGetContent( cycle ) );
+    const e22900t22s_field_t * field = NULL;
+    for( size_t i = 0 ; i < sizeof(config_fields) / sizeof(config_fields[0]) ; ++i ){
+      if( !strcmp( config_fields[i].path, path ) ){
+        field = &config_fields[i];
+        break;
       }
     }
+    if( NULL == field )
+      continue;
 
-    if( NULL != stats ){
-      xmlNode * rssi;
-      xmlNode * noise;
+    xmlChar * content = xmlNodeGetContent( current_node );
+    if( NULL == content )
+      continue;
+    load_field( field, (const char *) content, config );
+    xmlFree( content );
+  }
+  path[length] = '\0';
+  return 0;
+}
 
-      for( xmlNode * current_node = stats->children ; current_node != NULL ; current_node = current_node->next ){
-        if( XML_ELEMENT_NODE == current_node->type ){
-          if( !strcmp( (char *) current_node->name, "rssi" ) )
-            rssi = current_node;        
-          if( !strcmp( (char *) current_node->name, "noise" ) )
-            noise = current_node;        
-        }
-      }
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void 
+load_field( const e22900t22s_field_t * field, const char * text, e22900t22s_config_t * config ){
+  uint8_t * value = (uint8_t *) config + field->offset;
 
-      if( NULL != rssi )
-        config->rssi = !atoi( (const char *) xmlNodeGetContent( rssi ) ) ? 0 : 1;
-      if( NULL != noise )
-        config->ambient_noise = !atoi( (const char *) xmlNodeGetContent( noise ) ) ? 0 : 1;
-    }
+  switch( field->kind ){
+    case E22900T22S_FIELD_U8:
+      *value = (uint8_t) atoi( text );
+      break;
+    case E22900T22S_FIELD_U16:
+      *(uint16_t *) value = (uint16_t) atoi( text );
+      break;
+    case E22900T22S_FIELD_FLAG:
+      *value = !atoi( text ) ? 0 : 1;
+      break;
+    case E22900T22S_FIELD_NAME:
+      strncpy( (char *) value, text, NAME_MAX - 1 );
+      value[NAME_MAX - 1] = '\0';
+      break;
+    case E22900T22S_FIELD_BAUDRATE:
+      *(baudRate_t *) value = lookup_table_baudrate_fromtext_2code( text );
+      break;
+    case E22900T22S_FIELD_PARITY:
+      *(parity_t *) value = lookup_table_parity_fromtext_2code( text );
+      break;
+    case E22900T22S_FIELD_AIRRATE:
+      *(baudRate_t *) value = lookup_table_airrate_fromtext_2code( text );
+      break;
+    case E22900T22S_FIELD_PACKET:
+      *(e22900t22s_packet_size_t *) value = lookup_table_packet_fromtext( text );
+      break;
+    case E22900T22S_FIELD_POWER:
+      *(e22900t22s_transmission_power_t *) value = lookup_table_power_fromtext( text );
+      break;
+    case E22900T22S_FIELD_WORCYCLE:
+      *(e22900t22s_wor_cycle_t *) value = lookup_table_worcycle_fromtext( text );
+      break;
   }
+}
 
-  if( NULL != pin ){
-    xmlNode * chip;
-    xmlNode * aux;
-    xmlNode * m0;
-    xmlNode * m1;
-
-    for( xmlNode * current_node = pin->children ; current_node != NULL ; current_node = current_node->next ){
-      if( XML_ELEMENT_NODE == current_node->type ){
-        if( !strcmp( (char *) current_node->name, "chip" ) )
-          chip = current_node;        
-        if( !strcmp( (char *) current_node->name, "aux" ) )
-          aux = current_node;        
-        if( !strcmp( (char *) current_node->name, "m0" ) )
-          m0 = current_node;        
-        if( !strcmp( (char *) current_node->name, "m1" ) )
-          m1 = current_node;        
-      }
-    }
-
-    if( NULL != chip )
-      strncpy( pinout->chip.name, (const char *) xmlNodeGetContent( chip ), NAME_MAX );
-    if( NULL != aux )
-      pinout->aux.offset = (uint8_t) atoi( (const char *) xmlNodeGetContent( aux ) );   
-    if( NULL != m0 )
-      pinout->m0.offset = (uint8_t) atoi( (const char *) xmlNodeGetContent( m0 ) );   
-    if( NULL != m1 )
-      pinout->m1.offset = (uint8_t) atoi( (const char *) xmlNodeGetContent( m1 ) );   
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t 
+e22900t22s_load_config( const char * filename, e22900t22s_eeprom_t * config, e22900t22s_pinmode_t * pinout ){
+  if( !pinout || !config || !filename ){
+    errno = EINVAL;
+    return -1;
   }
 
-  xmlFreeDoc( docfile );
-  xmlCleanupParser( );
+  e22900t22s_config_t loaded;
+  if( -1 == e22900t22s_load( filename, &loaded ) )
+    return -1;
+
+  *config = loaded.eeprom;
+  *pinout = loaded.pinout;
   return 0;
 }
 
@@ -474,176 +531,249 @@ e22900t22s_default_config( const uint8_t update, e22900t22s_t * dev ){
   dev->cfg.transmit_power = E22900T22S_DBM_22;
   dev->cfg.wor_cycle = E22900T22S_WOR_2000;
   dev->cfg.channel = 0x32;
+  dev->shadow.dirty = ( 1 << E22900T22S_REG_BLOCK ) - 1;
 
   if( update )
     return e22900t22s_update_eeprom( dev );
   return 0;
 }
 
+// Text to table index plus one, 0 is a free slot, indexed by the hash of the number the text carries
+#define LUT_SLOT( bin, text, key, code )        [ E22900T22S_LUT_HASH( key ) ] = (bin) + 1,
+#define LUT_CASE_BIN( bin, text, key, code )    case bin:
+#define LUT_CASE_KEY( bin, text, key, code )    case E22900T22S_LUT_HASH( key ):
+#define LUT_CASE_CODE( bin, text, key, code )   case code:
+#define LUT_RETURN_BIN( bin, text, key, code )  case code: return bin;
+#define LUT_COUNT( bin, text, key, code )       + 1
+
+static const uint8_t lut_baudrate_slot[ 1 << E22900T22S_LUT_HASH_BITS ] = { E22900T22S_LUT_UART( LUT_SLOT ) };
+static const uint8_t lut_parity_slot[ 1 << E22900T22S_LUT_HASH_BITS ]   = { E22900T22S_LUT_PARITY( LUT_SLOT ) };
+static const uint8_t lut_airrate_slot[ 1 << E22900T22S_LUT_HASH_BITS ]  = { E22900T22S_LUT_AIRRATE( LUT_SLOT ) };
+static const uint8_t lut_packet_slot[ 1 << E22900T22S_LUT_HASH_BITS ]   = { E22900T22S_LUT_PACKET( LUT_SLOT ) };
+static const uint8_t lut_power_slot[ 1 << E22900T22S_LUT_HASH_BITS ]    = { E22900T22S_LUT_POWER( LUT_SLOT ) };
+static const uint8_t lut_worcycle_slot[ 1 << E22900T22S_LUT_HASH_BITS ] = { E22900T22S_LUT_WORCYCLE( LUT_SLOT ) };
+
+// Every register value must have exactly one entry
+typedef char lut_check_uart[ ( 0 E22900T22S_LUT_UART( LUT_COUNT ) ) == E22900T22S_LUT_SIZE_UART ? 1 : -1 ];
+typedef char lut_check_parity[ ( 0 E22900T22S_LUT_PARITY( LUT_COUNT ) E22900T22S_LUT_PARITY_ALIAS( LUT_COUNT ) ) == E22900T22S_LUT_SIZE_PARITY ? 1 : -1 ];
+typedef char lut_check_airrate[ ( 0 E22900T22S_LUT_AIRRATE( LUT_COUNT ) ) == E22900T22S_LUT_SIZE_AIRRATE ? 1 : -1 ];
+typedef char lut_check_packet[ ( 0 E22900T22S_LUT_PACKET( LUT_COUNT ) ) == E22900T22S_LUT_SIZE_PACKET ? 1 : -1 ];
+typedef char lut_check_power[ ( 0 E22900T22S_LUT_POWER( LUT_COUNT ) ) == E22900T22S_LUT_SIZE_POWER ? 1 : -1 ];
+typedef char lut_check_worcycle[ ( 0 E22900T22S_LUT_WORCYCLE( LUT_COUNT ) ) == E22900T22S_LUT_SIZE_WORCYCLE ? 1 : -1 ];
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+/**
+ * Never called. A register value, code or text hash repeated inside one table becomes a duplicate case label, so the tables are checked when the driver compiles.
+ */
+static inline void
+lookup_table_validate( const uint32_t value ){
+  switch( value ){ E22900T22S_LUT_UART( LUT_CASE_BIN ) default: break; }
+  switch( value ){ E22900T22S_LUT_UART( LUT_CASE_KEY ) default: break; }
+  switch( value ){ E22900T22S_LUT_UART( LUT_CASE_CODE ) default: break; }
+  switch( value ){ E22900T22S_LUT_PARITY( LUT_CASE_BIN ) E22900T22S_LUT_PARITY_ALIAS( LUT_CASE_BIN ) default: break; }
+  switch( value ){ E22900T22S_LUT_PARITY( LUT_CASE_KEY ) default: break; }
+  switch( value ){ E22900T22S_LUT_PARITY( LUT_CASE_CODE ) default: break; }
+  switch( value ){ E22900T22S_LUT_AIRRATE( LUT_CASE_BIN ) default: break; }
+  switch( value ){ E22900T22S_LUT_AIRRATE( LUT_CASE_KEY ) default: break; }
+  switch( value ){ E22900T22S_LUT_AIRRATE( LUT_CASE_CODE ) default: break; }
+  switch( value ){ E22900T22S_LUT_PACKET( LUT_CASE_BIN ) default: break; }
+  switch( value ){ E22900T22S_LUT_PACKET( LUT_CASE_KEY ) default: break; }
+  switch( value ){ E22900T22S_LUT_POWER( LUT_CASE_BIN ) default: break; }
+  switch( value ){ E22900T22S_LUT_POWER( LUT_CASE_KEY ) default: break; }
+  switch( value ){ E22900T22S_LUT_WORCYCLE( LUT_CASE_BIN ) default: break; }
+  switch( value ){ E22900T22S_LUT_WORCYCLE( LUT_CASE_KEY ) default: break; }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+static inline uint32_t
+lookup_table_key( const char * text ){
+  uint32_t key = 0;
+  for( ; *text >= '0' && *text <= '9' ; ++text )
+    key = key * 10 + (uint32_t) ( *text - '0' );
+  return key;
+}
+
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 uint8_t 
 lookup_table_baudrate_2bin( const baudRate_t baud_code ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_UART ; ++i )
-    if( lut_baudrate[ i ].code == baud_code )
-      return lut_baudrate[ i ].bin;
-  return 0xFF;
+  switch( baud_code ){
+    E22900T22S_LUT_UART( LUT_RETURN_BIN )
+    default: return 0xFF;
+  }
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 const char * 
 lookup_table_baudrate_2text( const baudRate_t baud_code ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_UART ; ++i )
-    if( lut_baudrate[ i ].code == baud_code )
-      return lut_baudrate[ i ].text;
-  return "";
+  uint8_t bin = lookup_table_baudrate_2bin( baud_code );
+  return 0xFF == bin ? "" : lut_baudrate[ bin ].text;
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 baudRate_t 
 lookup_table_baudrate_2code( const uint8_t baud_bin ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_UART ; ++i )
-    if( lut_baudrate[ i ].bin == baud_bin )
-      return lut_baudrate[ i ].code;
-  return 0xFF;
+  return baud_bin < E22900T22S_LUT_SIZE_UART ? lut_baudrate[ baud_bin ].code : 0xFF;
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 baudRate_t 
 lookup_table_baudrate_fromtext_2code( const char * baud_text ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_UART ; ++i )
-    if( !strcmp( lut_baudrate[ i ].text, baud_text ) )
-      return lut_baudrate[ i ].code;
-  return B9600;
+  uint8_t slot = lut_baudrate_slot[ E22900T22S_LUT_HASH( lookup_table_key( baud_text ) ) ];
+  if( !slot || strcmp( lut_baudrate[ slot - 1 ].text, baud_text ) )
+    return B9600;
+  return lut_baudrate[ slot - 1 ].code;
 }
 
-
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 uint8_t 
 lookup_table_parity_2bin( const parity_t parity_code ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_PARITY ; ++i )
-    if( lut_parity[ i ].code == parity_code )
-      return lut_parity[ i ].bin;
-  return 0xFF;
+  switch( parity_code ){
+    E22900T22S_LUT_PARITY( LUT_RETURN_BIN )
+    default: return 0xFF;
+  }
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 const char * 
 lookup_table_parity_2text( const parity_t parity_code ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_PARITY ; ++i )
-    if( lut_parity[ i ].code == parity_code )
-      return lut_parity[ i ].text;
-  return "";
+  uint8_t bin = lookup_table_parity_2bin( parity_code );
+  return 0xFF == bin ? "" : lut_parity[ bin ].text;
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 parity_t 
 lookup_table_parity_2code( const uint8_t parity_bin ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_PARITY ; ++i )
-    if( lut_parity[ i ].bin == parity_bin )
-      return lut_parity[ i ].code;
-  return 0xFF;
+  return parity_bin < E22900T22S_LUT_SIZE_PARITY ? lut_parity[ parity_bin ].code : 0xFF;
 }
 
-
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 parity_t 
 lookup_table_parity_fromtext_2code( const char * parity_text ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_PARITY ; ++i )
-    if( !strcmp( lut_parity[ i ].text, parity_text ) )
-      return lut_parity[ i ].code;
-  return BPARITY_NONE;
+  if( !parity_text[ 0 ] )
+    return BPARITY_NONE;
+  uint8_t slot = lut_parity_slot[ E22900T22S_LUT_HASH( parity_text[ 1 ] ) ];
+  if( !slot || strcmp( lut_parity[ slot - 1 ].text, parity_text ) )
+    return BPARITY_NONE;
+  return lut_parity[ slot - 1 ].code;
 }
 
-
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 uint8_t 
 lookup_table_airrate_2bin( const baudRate_t baud_code ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_AIRRATE ; ++i )
-    if( lut_airrate[ i ].code == baud_code )
-      return lut_airrate[ i ].bin;
-  return 0xFF;
+  switch( baud_code ){
+    E22900T22S_LUT_AIRRATE( LUT_RETURN_BIN )
+    default: return 0xFF;
+  }
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 const char * 
 lookup_table_airrate_2text( const baudRate_t baud_code ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_AIRRATE ; ++i )
-    if( lut_airrate[ i ].code == baud_code )
-      return lut_airrate[ i ].text;
-  return "";
+  uint8_t bin = lookup_table_airrate_2bin( baud_code );
+  return 0xFF == bin ? "" : lut_airrate[ bin ].text;
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
-baudRate_t
+baudRate_t 
 lookup_table_airrate_2code( const uint8_t baud_bin ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_AIRRATE ; ++i )
-    if( lut_airrate[ i ].bin == baud_bin )
-      return lut_airrate[ i ].code;
-  return 0xFF;
+  return baud_bin < E22900T22S_LUT_SIZE_AIRRATE ? lut_airrate[ baud_bin ].code : 0xFF;
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 baudRate_t 
 lookup_table_airrate_fromtext_2code( const char * baud_text ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_AIRRATE ; ++i )
-    if( !strcmp( lut_airrate[ i ].text, baud_text ) )
-      return lut_airrate[ i ].code;
-  return B9600;
+  uint8_t slot = lut_airrate_slot[ E22900T22S_LUT_HASH( lookup_table_key( baud_text ) ) ];
+  if( !slot || strcmp( lut_airrate[ slot - 1 ].text, baud_text ) )
+    return B9600;
+  return lut_airrate[ slot - 1 ].code;
 }
 
-
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 const char * 
 lookup_table_packet_2text( const e22900t22s_packet_size_t code ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_PACKET ; ++i )
-    if( lut_packetsize[ i ].code == code )
-      return lut_packetsize[ i ].text;
-  return "";
+  return (uint32_t) code < E22900T22S_LUT_SIZE_PACKET ? lut_packetsize[ code ].text : "";
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 e22900t22s_packet_size_t 
 lookup_table_packet_fromtext( const char * size_text ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_PACKET ; ++i )
-    if( !strcmp( lut_packetsize[ i ].text, size_text ) )
-      return lut_packetsize[ i ].code;
-  return E22900T22S_PACKET_32;
+  uint8_t slot = lut_packet_slot[ E22900T22S_LUT_HASH( lookup_table_key( size_text ) ) ];
+  if( !slot || strcmp( lut_packetsize[ slot - 1 ].text, size_text ) )
+    return E22900T22S_PACKET_32;
+  return lut_packetsize[ slot - 1 ].code;
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 const char * 
 lookup_table_power_2text( const e22900t22s_transmission_power_t code ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_POWER ; ++i )
-    if( lut_power[ i ].code == code )
-      return lut_power[ i ].text;
-  return "";
+  return (uint32_t) code < E22900T22S_LUT_SIZE_POWER ? lut_power[ code ].text : "";
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 e22900t22s_transmission_power_t 
 lookup_table_power_fromtext( const char * power_text ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_POWER ; ++i )
-    if( !strcmp( lut_power[ i ].text, power_text) )
-      return lut_power[ i ].code;
-  return E22900T22S_DBM_22;
+  uint8_t slot = lut_power_slot[ E22900T22S_LUT_HASH( lookup_table_key( power_text ) ) ];
+  if( !slot || strcmp( lut_power[ slot - 1 ].text, power_text ) )
+    return E22900T22S_DBM_22;
+  return lut_power[ slot - 1 ].code;
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 const char * 
 lookup_table_worcycle_2text( const e22900t22s_wor_cycle_t code ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_WORCYCLE ; ++i )
-    if( lut_worcycle[ i ].code == code )
-      return lut_worcycle[ i ].text;
-  return "";
+  return (uint32_t) code < E22900T22S_LUT_SIZE_WORCYCLE ? lut_worcycle[ code ].text : "";
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 e22900t22s_wor_cycle_t 
 lookup_table_worcycle_fromtext( const char * cycle_text ){
-  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_WORCYCLE ; ++i )
-    if( !strcmp( lut_worcycle[ i ].text, cycle_text) )
-      return lut_worcycle[ i ].code;
-  return E22900T22S_WOR_2000;
+  uint8_t slot = lut_worcycle_slot[ E22900T22S_LUT_HASH( lookup_table_key( cycle_text ) ) ];
+  if( !slot || strcmp( lut_worcycle[ slot - 1 ].text, cycle_text ) )
+    return E22900T22S_WOR_2000;
+  return lut_worcycle[ slot - 1 ].code;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+pack_registers( const e22900t22s_eeprom_t * cfg, uint8_t * reg ){
+  reg[ E22900T22S_MEM_ADDH ] = (uint8_t) (cfg->address >> 8) & 0xFF;
+  reg[ E22900T22S_MEM_ADDL ] = (uint8_t) cfg->address & 0xFF ;
+  reg[ E22900T22S_MEM_NETID ] = cfg->netid ;
+  reg[ E22900T22S_MEM_REG0 ] = (uint8_t) ((uint8_t) lookup_table_baudrate_2bin( cfg->baudrate ) << E22900T22S_SHF_UART   |
+                                          (uint8_t) lookup_table_parity_2bin( cfg->parity )     << E22900T22S_SHF_PARITY |
+                                          (uint8_t) lookup_table_airrate_2bin( cfg->airrate )   << E22900T22S_SHF_AIRDATA);
+  reg[ E22900T22S_MEM_REG1 ] = (uint8_t) ((uint8_t) cfg->packet_size   << E22900T22S_SHF_PKTSZ  |
+                                          (uint8_t) cfg->ambient_noise  << E22900T22S_SHF_AMBNS | 
+                                          (uint8_t) cfg->transmit_power << E22900T22S_SHF_POWER );
+  reg[ E22900T22S_MEM_REG2 ] = cfg->channel;
+  reg[ E22900T22S_MEM_REG3 ] = (uint8_t) ((uint8_t) cfg->rssi      << E22900T22S_SHF_RSSI  |
+                                          (uint8_t) cfg->fixed     << E22900T22S_SHF_FIXED | 
+                                          (uint8_t) cfg->repeater  << E22900T22S_SHF_REPLY |
+                                          (uint8_t) cfg->lbt       << E22900T22S_SHF_LBT   |
+                                          (uint8_t) cfg->wor       << E22900T22S_SHF_WOR   |
+                                          (uint8_t) cfg->wor_cycle << E22900T22S_SHF_WORCYC );
+  reg[ E22900T22S_MEM_CRYPTH ] = (uint8_t) (cfg->encryption >> 8) & 0xFF;
+  reg[ E22900T22S_MEM_CRYPTL ] = (uint8_t) cfg->encryption & 0xFF;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+unpack_registers( const uint8_t * reg, e22900t22s_eeprom_t * cfg ){
+  cfg->address = (uint16_t) (reg[ E22900T22S_MEM_ADDH ] << 8 | reg[ E22900T22S_MEM_ADDL ]);
+  cfg->netid = reg[ E22900T22S_MEM_NETID ];
+  cfg->baudrate = lookup_table_baudrate_2code( (reg[ E22900T22S_MEM_REG0 ] >> E22900T22S_SHF_UART) & (E22900T22S_LUT_SIZE_UART - 1) );
+  cfg->parity = lookup_table_parity_2code( (reg[ E22900T22S_MEM_REG0 ] >> E22900T22S_SHF_PARITY) & (E22900T22S_LUT_SIZE_PARITY - 1) );
+  cfg->airrate = lookup_table_airrate_2code( (reg[ E22900T22S_MEM_REG0 ] >> E22900T22S_SHF_AIRDATA) & (E22900T22S_LUT_SIZE_AIRRATE - 1) );
+  cfg->packet_size = (reg[ E22900T22S_MEM_REG1 ] >> E22900T22S_SHF_PKTSZ) & (E22900T22S_LUT_SIZE_PACKET - 1);
+  cfg->ambient_noise = (reg[ E22900T22S_MEM_REG1 ] >> E22900T22S_SHF_AMBNS) & 1; 
+  cfg->transmit_power = (reg[ E22900T22S_MEM_REG1 ] >> E22900T22S_SHF_POWER) & (E22900T22S_LUT_SIZE_POWER - 1); 
+  cfg->channel = reg[ E22900T22S_MEM_REG2 ];
+  cfg->rssi = (reg[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_RSSI) & 1;
+  cfg->fixed = (reg[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_FIXED) & 1;
+  cfg->repeater = (reg[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_REPLY) & 1;
+  cfg->lbt = (reg[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_LBT) & 1;
+  cfg->wor = (reg[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_WOR) & 1;
+  cfg->wor_cycle = (reg[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_WORCYC) & (E22900T22S_LUT_SIZE_WORCYCLE - 1);
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
@@ -652,33 +782,11 @@ e22900t22s_update_eeprom( e22900t22s_t * dev ){
   if( !check( dev ) )
     return -1;
 
-  uint8_t cfg[NAME_MAX];
+  uint8_t cfg[ E22900T22S_REG_BLOCK ], first, length;
+  if( !dirty_range( dev, cfg, &first, &length ) )
+    return 0;
 
-  // Overhead
-  cfg[ 0 ] = E22900T22S_SET_REG;           // Command  
-  cfg[ 1 ] = E22900T22S_MEM_ADDH;          // Starting address
-  cfg[ 2 ] = E22900T22S_MEM_CRYPTL + 1;    // Length
-  // Parameters
-  cfg[ E22900T22S_MEM_ADDH ] = (uint8_t) (dev->cfg.address >> 7) & 0xFF;
-  cfg[ E22900T22S_MEM_ADDL ] = (uint8_t) dev->cfg.address & 0xFF ;
-  cfg[ E22900T22S_MEM_NETID ] = dev->cfg.netid ;
-  cfg[ E22900T22S_MEM_REG0 ] = (uint8_t) ((uint8_t) lookup_table_baudrate_2bin( dev->cfg.baudrate ) << E22900T22S_SHF_UART   |
-                                          (uint8_t) lookup_table_parity_2bin( dev->cfg.parity )     << E22900T22S_SHF_PARITY |
-                                          (uint8_t) lookup_table_airrate_2bin( dev->cfg.airrate )   << E22900T22S_SHF_AIRDATA);
-  cfg[ E22900T22S_MEM_REG1 ] = (uint8_t) ((uint8_t) dev->cfg.packet_size   << E22900T22S_SHF_PKTSZ  |
-                                          (uint8_t) dev->cfg.ambient_noise  << E22900T22S_SHF_AMBNS | 
-                                          (uint8_t) dev->cfg.transmit_power << E22900T22S_SHF_POWER );
-  cfg[ E22900T22S_MEM_REG2 ] = dev->cfg.channel;
-  cfg[ E22900T22S_MEM_REG3 ] = (uint8_t) ((uint8_t) dev->cfg.rssi      << E22900T22S_SHF_RSSI  |
-                                          (uint8_t) dev->cfg.fixed     << E22900T22S_SHF_FIXED | 
-                                          (uint8_t) dev->cfg.repeater  << E22900T22S_SHF_REPLY |
-                                          (uint8_t) dev->cfg.lbt       << E22900T22S_SHF_LBT   |
-                                          (uint8_t) dev->cfg.wor       << E22900T22S_SHF_WOR   |
-                                          (uint8_t) dev->cfg.wor_cycle << E22900T22S_SHF_WORCYC );
-  cfg[ E22900T22S_MEM_CRYPTH ] = (uint8_t) (dev->cfg.encryption >> 7) & 0xFF;
-  cfg[ E22900T22S_MEM_CRYPTL ] = (uint8_t) dev->cfg.encryption & 0xFF;
-
-  uint8_t len = e22900t22s_write_register( E22900T22S_MEM_ADDH, E22900T22S_MEM_CRYPTL + 1, cfg, dev );
+  uint8_t len = e22900t22s_write_register( first, length, &cfg[ first ], dev );
   if( !len ){
     perror("e22900t22s_write_register");
     return -1;
@@ -687,46 +795,149 @@ e22900t22s_update_eeprom( e22900t22s_t * dev ){
   return 0;
 }
 
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t 
+e22900t22s_update_temporary( e22900t22s_t * dev ){
+  if( !check( dev ) )
+    return -1;
+
+  e22900t22s_transaction_t tr;
+  uint8_t cfg[ E22900T22S_REG_BLOCK ], first, length;
+  if( !temporary_range( dev, cfg, &first, &length ) )
+    return 0;
+
+  if( -1 == e22900t22s_transaction_begin( &tr, dev ) ||
+      -1 == e22900t22s_transaction_write_temporary( &tr, first, length, &cfg[ first ] ) ||
+      -1 == e22900t22s_transaction_commit( &tr ) ){
+    perror("e22900t22s_transaction");
+    return -1;
+  }
+
+  return 0;
+}
+
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int8_t 
 e22900t22s_get_config( e22900t22s_t * dev ){
-  uint8_t cfg[NAME_MAX];
-  uint8_t len = e22900t22s_read_register( E22900T22S_MEM_ADDH, E22900T22S_MEM_REG3 + 1, cfg, sizeof(cfg), dev );
-  //                                Start address__/                     / 
-  //                                                      Last address__/
-  if( !len ){
-    perror("e22900t22s_read_register");
-    return -1;
-  }
-
-  dev->cfg.address = (uint16_t) (cfg[ E22900T22S_MEM_ADDH ] << 8 | cfg[ E22900T22S_MEM_ADDL ]);
-  dev->cfg.netid = cfg[ E22900T22S_MEM_NETID ];
-  dev->cfg.baudrate = lookup_table_baudrate_2code( (cfg[ E22900T22S_MEM_REG0 ] >> E22900T22S_SHF_UART) & (E22900T22S_LUT_SIZE_UART - 1) );
-  dev->cfg.parity = lookup_table_parity_2code( (cfg[ E22900T22S_MEM_REG0 ] >> E22900T22S_SHF_PARITY) & (E22900T22S_LUT_SIZE_PARITY - 1) );
-  dev->cfg.airrate = lookup_table_airrate_2code( (cfg[ E22900T22S_MEM_REG0 ] >> E22900T22S_SHF_AIRDATA) & (E22900T22S_LUT_SIZE_AIRRATE - 1) );
-  dev->cfg.packet_size = (cfg[ E22900T22S_MEM_REG1 ] >> E22900T22S_SHF_PKTSZ) & (E22900T22S_LUT_SIZE_PACKET - 1);
-  dev->cfg.ambient_noise = (cfg[ E22900T22S_MEM_REG1 ] >> E22900T22S_SHF_AMBNS) & 1; 
-  dev->cfg.transmit_power = (cfg[ E22900T22S_MEM_REG1 ] >> E22900T22S_SHF_POWER) & (E22900T22S_LUT_SIZE_POWER - 1); 
-  dev->cfg.channel = cfg[ E22900T22S_MEM_REG2 ];
-  dev->cfg.rssi = (cfg[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_RSSI) & 1;
-  dev->cfg.fixed = (cfg[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_FIXED) & 1;
-  dev->cfg.repeater = (cfg[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_REPLY) & 1;
-  dev->cfg.lbt = (cfg[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_LBT) & 1;
-  dev->cfg.wor = (cfg[ E22900T22S_MEM_REG3 ] >> E22900T22S_SHF_WOR) & 1;
-  dev->cfg.wor_cycle = (cfg[ E22900T22S_SHF_WORCYC ] >> E22900T22S_SHF_WOR) & (E22900T22S_LUT_SIZE_WORCYCLE - 1);
-
-  len = e22900t22s_read_register( E22900T22S_MEM_PID, E22900T22S_PID_SIZE, cfg, sizeof(cfg), dev );
-  if( !len ){
-    perror("e22900t22s_read_register");
+  e22900t22s_transaction_t tr;
+  uint8_t cfg[ E22900T22S_MEM_REG3 + 1 ];
+  uint8_t pid[ E22900T22S_PID_SIZE ];
+
+  // Both blocks are read in the same configuration session
+  if( -1 == e22900t22s_transaction_begin( &tr, dev ) ||
+      -1 == e22900t22s_transaction_read( &tr, E22900T22S_MEM_ADDH, E22900T22S_MEM_REG3 + 1, cfg, sizeof(cfg) ) ||
+      //                                 Start address__/                     / 
+      //                                                      Last address__/
+      -1 == e22900t22s_transaction_read( &tr, E22900T22S_MEM_PID, E22900T22S_PID_SIZE, pid, sizeof(pid) ) ||
+      -1 == e22900t22s_transaction_commit( &tr ) ){
+    perror("e22900t22s_transaction");
     return -1;
   }
-  if( E22900T22S_PID_SIZE != len ){
-    printf("[%d] E22900T22S_PID_SIZE != len ...\n", getpid( ));
+
+  unpack_registers( cfg, &dev->cfg );
+  memcpy( dev->cfg.pid, pid, E22900T22S_PID_SIZE );
+
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t 
+e22900t22s_sync_config( e22900t22s_t * dev ){
+  if( !check( dev ) )
+    return -1;
+
+  e22900t22s_transaction_t tr;
+  uint8_t reg[ E22900T22S_REG_BLOCK ], first, length;
+  uint8_t cfg[ E22900T22S_MEM_REG3 + 1 ];
+  uint8_t pid[ E22900T22S_PID_SIZE ];
+
+  if( -1 == e22900t22s_transaction_begin( &tr, dev ) )
+    return -1;
+  if( dirty_range( dev, reg, &first, &length ) && -1 == e22900t22s_transaction_write( &tr, first, length, &reg[ first ] ) )
+    return -1;
+
+  // The write echo confirms the registers it covered, the others readable ones are read back only if the shadow does not hold them
+  const uint16_t readable = ( 1 << ( E22900T22S_MEM_REG3 + 1 ) ) - 1;
+  uint16_t confirmed = (uint16_t) ( dev->shadow.known | ( length ? ( ( 1 << length ) - 1 ) << first : 0 ) );
+  uint8_t readback = ( readable != ( confirmed & readable ) );
+  if( readback && -1 == e22900t22s_transaction_read( &tr, E22900T22S_MEM_ADDH, E22900T22S_MEM_REG3 + 1, cfg, sizeof(cfg) ) )
+    return -1;
+  if( !dev->shadow.pid && -1 == e22900t22s_transaction_read( &tr, E22900T22S_MEM_PID, E22900T22S_PID_SIZE, pid, sizeof(pid) ) )
+    return -1;
+
+  uint8_t pid_read = !dev->shadow.pid;
+  if( -1 == e22900t22s_transaction_commit( &tr ) ){
+    perror("e22900t22s_transaction");
+    return -1;
+  }
+
+  if( readback )
+    unpack_registers( cfg, &dev->cfg );
+  if( pid_read )
+    memcpy( dev->cfg.pid, pid, E22900T22S_PID_SIZE );
+
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t 
+e22900t22s_verify_config( e22900t22s_t * dev ){
+  if( !check( dev ) )
+    return -1;
+
+  e22900t22s_transaction_t tr;
+  uint8_t reg[ E22900T22S_REG_BLOCK ], first, length;
+  uint8_t cfg[ E22900T22S_MEM_REG3 + 1 ];
+  uint8_t pid[ E22900T22S_PID_SIZE ];
+
+  // A single read session, the exchange fills the shadow with what the module holds
+  if( -1 == e22900t22s_transaction_begin( &tr, dev ) )
     return -1;
+  if( -1 == e22900t22s_transaction_read( &tr, E22900T22S_MEM_ADDH, E22900T22S_MEM_REG3 + 1, cfg, sizeof(cfg) ) )
+    return -1;
+  uint8_t pid_read = !dev->shadow.pid;
+  if( pid_read && -1 == e22900t22s_transaction_read( &tr, E22900T22S_MEM_PID, E22900T22S_PID_SIZE, pid, sizeof(pid) ) )
+    return -1;
+  if( -1 == e22900t22s_transaction_commit( &tr ) ){
+    perror("e22900t22s_transaction");
+    return -1;
+  }
+  if( pid_read )
+    memcpy( dev->cfg.pid, pid, E22900T22S_PID_SIZE );
+
+  // The key registers cannot be read, without a configured key they are taken as programmed when everything else matches
+  if( !dirty_range( dev, reg, &first, &length ) || ( E22900T22S_MEM_CRYPTH <= first && !dev->cfg.encryption ) ){
+    dev->shadow.reg[ E22900T22S_MEM_CRYPTH ] = reg[ E22900T22S_MEM_CRYPTH ];
+    dev->shadow.reg[ E22900T22S_MEM_CRYPTL ] = reg[ E22900T22S_MEM_CRYPTL ];
+    dev->shadow.known |= ( 1 << E22900T22S_MEM_CRYPTH ) | ( 1 << E22900T22S_MEM_CRYPTL );
+    dev->shadow.dirty = 0;
+    return 0;
   }
 
-  memcpy( dev->cfg.pid, cfg, len );
+  if( -1 == e22900t22s_sync_config( dev ) )
+    return -1;
+  return 1;
+}
 
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+serial_line( const baudRate_t baudrate, const parity_t parity, const uint8_t rule, e22900t22s_t * dev ){
+  e22900t22s_state_t * state = &dev->state;
+
+  // Each setting is a tcsetattr, only the ones that differ from what is programmed are sent
+  if( !state->serial || state->baudrate != baudrate ){
+    serial_set_baudrate( baudrate, &dev->serial->sr );
+    state->baudrate = baudrate;
+  }
+  if( !state->serial || state->parity != parity ){
+    serial_set_parity( parity, &dev->serial->sr );
+    state->parity = parity;
+  }
+  if( !state->serial || state->rule != rule ){
+    serial_set_rule( rule, 0, &dev->serial->sr );
+    state->rule = rule;
+  }
+  state->serial = 1;
   return 0;
 }
 
@@ -736,53 +947,53 @@ e22900t22s_set_mode( const e22900t22s_mode_t mode , e22900t22s_t * dev ){
   if( !check( dev ) )
     return -1;
 
+  // Unknown modes fall back to normal, as the switch below does
+  const e22900t22s_mode_t target = E22900T22S_MODE_SLEEP < mode ? E22900T22S_MODE_NORMAL : mode;
+  uint8_t flag = ( E22900T22S_MODE_NORMAL == target || E22900T22S_MODE_WOR == target );
+
+  if( dev->state.mode == target ){
+    dev->state.elided ++;
+    if( flag )
+      return serial_line( dev->cfg.baudrate, dev->cfg.parity, 0, dev );
+    return serial_line( B9600, BPARITY_NONE, 100, dev );
+  }
+
   if( -1 == e22900t22s_while_busy( delay_us, dev ) ){
     perror("e22900t22s_while_busy");
     return -1;
   }
   
   int8_t ret = 0;
-  uint8_t flag = 0;
-  switch( mode ){
+  switch( target ){
     default:
     case E22900T22S_MODE_NORMAL:
-      ret = gpiod_digital_write( &dev->gpio.m0, 0 );
-      ret = gpiod_digital_write( &dev->gpio.m1, 0 );
-      flag = 1;
+      ret = gpiod_digital_write_pair( &dev->gpio.m0, &dev->gpio.m1, 0, 0 );
       break;
 
     case E22900T22S_MODE_WOR:
-      ret = gpiod_digital_write( &dev->gpio.m0, 1 );
-      ret = gpiod_digital_write( &dev->gpio.m1, 0 );
-      flag = 1;
+      ret = gpiod_digital_write_pair( &dev->gpio.m0, &dev->gpio.m1, 1, 0 );
       break;
 
     case E22900T22S_MODE_CONFIG:
-      ret = gpiod_digital_write( &dev->gpio.m0, 0 );
-      ret = gpiod_digital_write( &dev->gpio.m1, 1 );
+      ret = gpiod_digital_write_pair( &dev->gpio.m0, &dev->gpio.m1, 0, 1 );
       break;
 
     case E22900T22S_MODE_SLEEP:
-      ret = gpiod_digital_write( &dev->gpio.m0, 1 );
-      ret = gpiod_digital_write( &dev->gpio.m1, 1 );
+      ret = gpiod_digital_write_pair( &dev->gpio.m0, &dev->gpio.m1, 1, 1 );
       break;
   }
 
   if( -1 == ret ){
-    perror("gpiod_digital_write");
+    perror("gpiod_digital_write_pair");
     return -1;    
   }
+  dev->state.mode = (uint8_t) target;
+  dev->state.switches ++;
 
-  if( flag ){
-    serial_set_baudrate( dev->cfg.baudrate, &dev->serial->sr );
-    serial_set_parity( dev->cfg.parity, &dev->serial->sr );
-    serial_set_rule( 0, 0, &dev->serial->sr );
-  }
-  else{
-    serial_set_baudrate( B9600, &dev->serial->sr );
-    serial_set_parity( BPARITY_NONE, &dev->serial->sr );
-    serial_set_rule( 100, 0, &dev->serial->sr );
-  }
+  if( flag )
+    serial_line( dev->cfg.baudrate, dev->cfg.parity, 0, dev );
+  else
+    serial_line( B9600, BPARITY_NONE, 100, dev );
   
   // Recomendation by the datasheet
   usleep( 2e3 );
@@ -849,6 +1060,55 @@ gpiod_digital_write( gpiod_line2_t * gpio, uint8_t value ){
   return (int8_t) gpiod_line_set_value( gpio->ptr, !value ? 0 : 1 );
 }
 
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t 
+gpiod_pin_mode_pair( gpiod_chip2_t * chip, gpiod_line2_t * first, gpiod_line2_t * second ){
+  if( !chip || !first || !second ){
+    errno = EINVAL;
+    return -1;
+  }
+  first->ptr = gpiod_chip_get_line( chip->ptr, first->offset );
+  second->ptr = gpiod_chip_get_line( chip->ptr, second->offset );
+  if( !first->ptr || !second->ptr ){
+    gpiod_chip_close( chip->ptr );
+    return -1;
+  }
+
+  // Requested together so both outputs can later be changed with a single ioctl
+  struct gpiod_line_bulk bulk;
+  const int values[2] = { 0, 0 };
+  gpiod_line_bulk_init( &bulk );
+  gpiod_line_bulk_add( &bulk, first->ptr );
+  gpiod_line_bulk_add( &bulk, second->ptr );
+  if( -1 == gpiod_line_request_bulk_output( &bulk, "lora_driver", values ) ){
+    printf("[%d] gpiod_line_request_bulk_output: %d, %d ...\n", getpid( ), first->offset, second->offset );
+    gpiod_chip_close( chip->ptr );
+    return -1;
+  }
+
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t 
+gpiod_digital_write_pair( gpiod_line2_t * first, gpiod_line2_t * second, uint8_t first_value, uint8_t second_value ){
+  if( !first || !second ){
+    errno = EINVAL;
+    return -1;
+  }
+  if( !first->ptr || !second->ptr ){
+    errno = EBADF;
+    return -1;
+  }
+
+  struct gpiod_line_bulk bulk;
+  const int values[2] = { !first_value ? 0 : 1, !second_value ? 0 : 1 };
+  gpiod_line_bulk_init( &bulk );
+  gpiod_line_bulk_add( &bulk, first->ptr );
+  gpiod_line_bulk_add( &bulk, second->ptr );
+  return (int8_t) gpiod_line_set_value_bulk( &bulk, values );
+}
+
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int8_t 
 gpiod_digital_read( gpiod_line2_t * gpio ){
@@ -863,6 +1123,26 @@ gpiod_digital_read( gpiod_line2_t * gpio ){
   return (int8_t) gpiod_line_get_value( gpio->ptr );
 }
 
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t 
+gpiod_pin_events( gpiod_chip2_t * chip, gpiod_line2_t * gpio ){
+  if( !chip || !gpio ){
+    errno = EINVAL;
+    return -1;
+  }
+  gpio->ptr = gpiod_chip_get_line( chip->ptr, gpio->offset );
+  if( !gpio->ptr )
+    return -1;
+
+  // Unlike gpiod_pin_mode the chip is kept open on failure, so the caller can still request the line as a plain input
+  if( -1 == gpiod_line_request_rising_edge_events_flags( gpio->ptr, "lora_driver", GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_UP ) ){
+    gpio->ptr = NULL;
+    return -1;
+  }
+
+  return 0;
+}
+
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int8_t 
 e22900t22s_gpio_init( const char * chip_name, uint8_t m0, uint8_t m1, uint8_t aux, e22900t22s_t * dev ){
@@ -875,20 +1155,26 @@ e22900t22s_gpio_init( const char * chip_name, uint8_t m0, uint8_t m1, uint8_t au
     return -1;
   }
   dev->gpio.m0.offset = m0;
-  if( -1 == gpiod_pin_mode( &dev->gpio.chip, &dev->gpio.m0, 1 ) ){
-    perror("gpiod_pin_mode(m0)");
-    return -1;
-  }
   dev->gpio.m1.offset = m1;
-  if( -1 == gpiod_pin_mode( &dev->gpio.chip, &dev->gpio.m1, 1 ) ){
-    perror("gpiod_pin_mode(m1)");
+  if( -1 == gpiod_pin_mode_pair( &dev->gpio.chip, &dev->gpio.m0, &dev->gpio.m1 ) ){
+    perror("gpiod_pin_mode_pair(m0, m1)");
     return -1;
   }
+  // Both outputs start low, the module is in normal mode and the serial settings are still unknown
+  memset( &dev->state, 0, sizeof(e22900t22s_state_t) );
+  dev->state.mode = E22900T22S_MODE_NORMAL;
   dev->gpio.aux.offset = aux;
-  if( -1 == gpiod_pin_mode( &dev->gpio.chip, &dev->gpio.aux, 0 ) ){
-    perror("gpiod_pin_mode(aux)");
-    return -1;
+  memset( &dev->aux, 0, sizeof(e22900t22s_aux_t) );
+  if( -1 == gpiod_pin_events( &dev->gpio.chip, &dev->gpio.aux ) ){
+    // Kernel or chip without edge detection, falls back to polling the level
+    printf("[%d] AUX line without edge events, polling it instead ...\n", getpid( ) );
+    if( -1 == gpiod_pin_mode( &dev->gpio.chip, &dev->gpio.aux, 0 ) ){
+      perror("gpiod_pin_mode(aux)");
+      return -1;
+    }
   }
+  else
+    dev->aux.events = 1;
   return 0;
 }
 
@@ -967,130 +1253,222 @@ e22900t22s_print_config( uint8_t console, e22900t22s_t * dev ){
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
-uint8_t 
-e22900t22s_read_register( const uint8_t address, const uint8_t length, uint8_t * data, const uint8_t size, e22900t22s_t * dev ){
-  if( !data ){
-    errno = EINVAL;
-    return 0;
-  }
-  
+int8_t
+register_range( const uint8_t address, const uint8_t length ){
   for( uint16_t i = 0, tmp = (uint16_t) address ; i < 2 ; ++i ){
     if( ((0x08 < tmp) && (0x80 > tmp)) || (0x86 < tmp) ){
       errno = EADDRNOTAVAIL;
-      return 0;
+      return -1;
     }
-    tmp += length - 1;
+    tmp = (uint16_t) ( tmp + length - 1 );
   }
+  return 0;
+}
 
-  if( length > size ){
-    errno = EINVAL;
-    return 0;
-  }
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+register_exchange( e22900t22s_register_op_t * op, e22900t22s_t * dev ){
+  uint8_t buf[NAME_MAX], ret[NAME_MAX];
+  const uint8_t overhead = 3;
+  uint8_t write = E22900T22S_READ_REG != op->command;
 
-  if( -1 == e22900t22s_set_mode( E22900T22S_MODE_CONFIG, dev ) ){
-    perror("e22900t22s_set_mode");
-    return 0;
-  }
-  
-  if( -1 == e22900t22s_while_busy( delay_us, dev ) ){
-    perror("e22900t22s_while_busy");
-    return 0;
-  }
-  
-  uint8_t buf[NAME_MAX];
+  // Overhead
+  buf[ 0 ] = op->command;           // Command  
+  buf[ 1 ] = op->address;           // Starting address
+  buf[ 2 ] = op->length;            // Length
+  if( write )
+    memcpy( &buf[ overhead ], op->value, op->length );
 
-  // Overhead - Read Configuration memory block
-  buf[ 0 ] = E22900T22S_READ_REG;          // Command  
-  buf[ 1 ] = address;                      // Starting address
-  buf[ 2 ] = length;                       // Length
-  if( !serial_write( &dev->serial->sr, buf, 3 ) ){
+  if( !serial_write( &dev->serial->sr, buf, (size_t) ( overhead + ( write ? op->length : 0 ) ) ) ){
     perror("serial_write");
-    return 0;
+    return -1;
   }
   serial_flush( &dev->serial->sr );
-  
-  const uint8_t overhead = 3;
-  uint8_t buflen = overhead + length;
 
-  uint8_t len = (uint8_t) serial_read( (char *) buf, sizeof(buf), 0, buflen , &dev->serial->sr );
+  // Response: 0xC1 + address + length + value(length), the writes are echoed
+  uint8_t buflen = (uint8_t) ( overhead + op->length );
+  uint8_t len = (uint8_t) serial_read( (char *) ret, sizeof(ret), 0, buflen, &dev->serial->sr );
   if( len != buflen ){
     perror("serial_read - not same size");
-    return 0;
+    return -1;
   }
-   
-  memcpy( data, &buf[overhead], length );
 
-  if( -1 == e22900t22s_set_mode( E22900T22S_MODE_NORMAL, dev ) ){
-    perror("e22900t22s_set_mode");
-    return 0;
+  if( write ){
+    //                      __ Since first byte changes from C0 to C1
+    //                     /              _____ Since we are starting one index forward
+    if( 0 != memcmp( &ret[1], &buf[1], len - 1 ) ){
+      perror("serial_read - not match words");
+      return -1;
+    }
+  }
+  else
+    memcpy( op->data, &ret[ overhead ], op->length );
+
+  // The echo of a persistent write and a read both tell what the module holds, the encryption key always reads as 0
+  // A volatile write only changes what the module runs, and a read returns that running value
+  for( uint8_t i = 0 ; i < op->length && op->address + i < E22900T22S_REG_BLOCK ; ++i ){
+    const uint8_t reg = (uint8_t) ( op->address + i );
+    const uint16_t bit = (uint16_t) ( 1 << reg );
+    const uint8_t value = ret[ overhead + i ];
+
+    switch( op->command ){
+      case E22900T22S_SET_REG:
+        dev->shadow.reg[ reg ] = value;
+        dev->shadow.known |= bit;
+        dev->shadow.dirty &= (uint16_t) ~bit;
+        dev->shadow.temporary &= (uint16_t) ~bit;
+        break;
+      case E22900T22S_SET_TMP_REG:
+        dev->shadow.running[ reg ] = value;
+        dev->shadow.temporary |= bit;
+        if( ( dev->shadow.known & bit ) && dev->shadow.reg[ reg ] == value )
+          dev->shadow.temporary &= (uint16_t) ~bit;
+        break;
+      case E22900T22S_READ_REG:
+        if( E22900T22S_MEM_REG3 < reg )
+          break;
+        if( dev->shadow.temporary & bit )
+          dev->shadow.running[ reg ] = value;
+        else{
+          dev->shadow.reg[ reg ] = value;
+          dev->shadow.known |= bit;
+        }
+        break;
+      default:
+        break;
+    }
   }
+  if( E22900T22S_READ_REG == op->command && E22900T22S_MEM_PID == op->address )
+    dev->shadow.pid = 1;
 
-  return length;
+  return 0;
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
-uint8_t 
-e22900t22s_write_register( const uint8_t address, const uint8_t length, const uint8_t * data, e22900t22s_t * dev ){
-  if( !data ){
+int8_t
+e22900t22s_transaction_begin( e22900t22s_transaction_t * tr, e22900t22s_t * dev ){
+  if( !tr || !check( dev ) ){
     errno = EINVAL;
-    return 0;
+    return -1;
   }
+  tr->dev = dev;
+  tr->length = 0;
+  return 0;
+}
 
-  for( uint16_t i = 0, tmp = (uint16_t) address ; i < 2 ; ++i ){
-    if( ((0x08 < tmp) && (0x80 > tmp)) || (0x86 < tmp) ){
-      errno = EADDRNOTAVAIL;
-      return 0;
-    }
-    tmp += length - 1;
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_transaction_read( e22900t22s_transaction_t * tr, const uint8_t address, const uint8_t length, uint8_t * data, const uint8_t size ){
+  if( !tr || !data || length > size ){
+    errno = EINVAL;
+    return -1;
+  }
+  if( -1 == register_range( address, length ) )
+    return -1;
+  if( E22900T22S_TRANSACTION_OPS <= tr->length ){
+    errno = ENOSPC;
+    return -1;
   }
 
+  e22900t22s_register_op_t * op = &tr->op[ tr->length ++ ];
+  op->command = E22900T22S_READ_REG;
+  op->address = address;
+  op->length = length;
+  op->data = data;
+  return 0;
+}
 
-  if( -1 == e22900t22s_set_mode( E22900T22S_MODE_CONFIG, dev ) ){
-    perror("e22900t22s_set_mode");
-    return 0;
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+transaction_queue( e22900t22s_transaction_t * tr, const uint8_t command, const uint8_t address, const uint8_t length, const uint8_t * data ){
+  if( !tr || !data || sizeof( tr->op[0].value ) < length ){
+    errno = EINVAL;
+    return -1;
   }
-  
-  if( -1 == e22900t22s_while_busy( delay_us, dev ) ){
-    perror("e22900t22s_while_busy");
-    return 0;
+  if( -1 == register_range( address, length ) )
+    return -1;
+  if( E22900T22S_TRANSACTION_OPS <= tr->length ){
+    errno = ENOSPC;
+    return -1;
   }
-  
-  uint8_t buf[NAME_MAX], ret[NAME_MAX];
-  
-  // Overhead
-  buf[ 0 ] = E22900T22S_SET_REG;    // Command  
-  buf[ 1 ] = address;               // Starting address
-  buf[ 2 ] = length;                // Length
-  memcpy( &buf[3], data, length );
 
-  uint8_t buflen = 3 + length;
-  //      Overhead_/      \_ Length
+  e22900t22s_register_op_t * op = &tr->op[ tr->length ++ ];
+  op->command = command;
+  op->address = address;
+  op->length = length;
+  op->data = NULL;
+  memcpy( op->value, data, length );
+  return 0;
+}
 
-  if( !serial_write( &dev->serial->sr, buf, buflen ) ){
-    perror("serial_write");
-    return 0;
-  }
-  serial_flush( &dev->serial->sr );
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_transaction_write( e22900t22s_transaction_t * tr, const uint8_t address, const uint8_t length, const uint8_t * data ){
+  return transaction_queue( tr, E22900T22S_SET_REG, address, length, data );
+}
 
-  uint8_t len = (uint8_t) serial_read( (char *) ret, sizeof(ret), 0, buflen, &dev->serial->sr );
-  if( len != buflen ){
-    perror("serial_read - not same size");
-    return 0;
-  }
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_transaction_write_temporary( e22900t22s_transaction_t * tr, const uint8_t address, const uint8_t length, const uint8_t * data ){
+  return transaction_queue( tr, E22900T22S_SET_TMP_REG, address, length, data );
+}
 
-  //                      __ Since first byte changes from C0 to C1
-  //                     /              _____ Since we are starting one index forward
-  if( 0 != memcmp( &ret[1], &buf[1], len - 1 ) ){
-    perror("serial_read - not match words");
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_transaction_commit( e22900t22s_transaction_t * tr ){
+  if( !tr || !check( tr->dev ) ){
+    errno = EINVAL;
+    return -1;
+  }
+  if( !tr->length )
     return 0;
+
+  e22900t22s_t * dev = tr->dev;
+  if( -1 == e22900t22s_set_mode( E22900T22S_MODE_CONFIG, dev ) ){
+    perror("e22900t22s_set_mode");
+    return -1;
   }
 
+  int8_t ret = 0;
+  for( uint8_t i = 0 ; i < tr->length && !ret ; ++i ){
+    if( -1 == e22900t22s_while_busy( delay_us, dev ) ){
+      perror("e22900t22s_while_busy");
+      ret = -1;
+    }
+    else
+      ret = register_exchange( &tr->op[i], dev );
+  }
+  tr->length = 0;
 
+  // Back to normal even if an operation failed, the error is kept in errno
+  int err = errno;
   if( -1 == e22900t22s_set_mode( E22900T22S_MODE_NORMAL, dev ) ){
     perror("e22900t22s_set_mode");
-    return 0;
+    return -1;
   }
+  errno = err;
+  return ret;
+}
 
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t 
+e22900t22s_read_register( const uint8_t address, const uint8_t length, uint8_t * data, const uint8_t size, e22900t22s_t * dev ){
+  e22900t22s_transaction_t tr;
+  if( -1 == e22900t22s_transaction_begin( &tr, dev ) || -1 == e22900t22s_transaction_read( &tr, address, length, data, size ) )
+    return 0;
+  if( -1 == e22900t22s_transaction_commit( &tr ) )
+    return 0;
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t 
+e22900t22s_write_register( const uint8_t address, const uint8_t length, const uint8_t * data, e22900t22s_t * dev ){
+  e22900t22s_transaction_t tr;
+  if( -1 == e22900t22s_transaction_begin( &tr, dev ) || -1 == e22900t22s_transaction_write( &tr, address, length, data ) )
+    return 0;
+  if( -1 == e22900t22s_transaction_commit( &tr ) )
+    return 0;
   return length;
 }
 
@@ -1120,7 +1498,7 @@ e22900t22s_read_rssi_register( const uint8_t address, const uint8_t length, uint
     return 0;
   }
 
-  serial_set_rule( 100, 0, &dev->serial->sr );
+  serial_line( dev->cfg.baudrate, dev->cfg.parity, 100, dev );
 
   uint8_t buf[NAME_MAX];
 
@@ -1147,13 +1525,43 @@ e22900t22s_read_rssi_register( const uint8_t address, const uint8_t length, uint
     return 0;
   }
 
-  serial_set_rule( 0, 0, &dev->serial->sr );
+  serial_line( dev->cfg.baudrate, dev->cfg.parity, 0, dev );
    
   memcpy( data, &buf[overhead], length );
 
   return length;
 }
 
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_shared_mutex_init( pthread_mutex_t * lock ){
+  pthread_mutexattr_t attr;
+  int error = pthread_mutexattr_init( &attr );
+  if( error ){
+    errno = error;
+    return -1;
+  }
+  error = pthread_mutexattr_setpshared( &attr, PTHREAD_PROCESS_SHARED );
+  // The processes are killed on exit, one may be inside the lock when it happens
+  if( !error )
+    error = pthread_mutexattr_setrobust( &attr, PTHREAD_MUTEX_ROBUST );
+  if( !error )
+    error = pthread_mutex_init( lock, &attr );
+  pthread_mutexattr_destroy( &attr );
+  if( error ){
+    errno = error;
+    return -1;
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_shared_mutex_lock( pthread_mutex_t * lock ){
+  // The state guarded holds counters and windows that stay usable half updated, the lock is recovered instead of lost
+  if( EOWNERDEAD == pthread_mutex_lock( lock ) )
+    pthread_mutex_consistent( lock );
+}
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int8_t  
@@ -1162,17 +1570,124 @@ e22900t22s_while_busy( const uint32_t delay, e22900t22s_t * dev ){
     return -1;
 
   int8_t aux;
+  if( !dev->aux.events ){
+    while( !( aux = gpiod_digital_read( &dev->gpio.aux ) ) ){
+      if( -1 == aux ){
+        perror("gpiod_digital_read");
+        return -1;    
+      }
+      usleep( delay );
+    }
+    return 0;
+  }
+
+  struct timespec start, now;
+  const struct timespec timeout = { .tv_sec = 0, .tv_nsec = E22900T22S_AUX_WAIT_MS * 1000000L };
+  clock_gettime( CLOCK_MONOTONIC, &start );
+
+  // The level is always read again after an event or a timeout, stale edges queued while idle only cost one extra loop
   while( !( aux = gpiod_digital_read( &dev->gpio.aux ) ) ){
-    if( -1 == aux ){
-      perror("gpiod_digital_read");
-      return -1;    
+    int ret = gpiod_line_event_wait( dev->gpio.aux.ptr, &timeout );
+    if( -1 == ret ){
+      perror("gpiod_line_event_wait");
+      return -1;
+    }
+    if( 0 == ret )
+      continue;
+
+    struct gpiod_line_event event;
+    if( -1 == gpiod_line_event_read( dev->gpio.aux.ptr, &event ) ){
+      perror("gpiod_line_event_read");
+      return -1;
+    }
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    // Edges older than the wait are stale, the event timestamp uses the monotonic clock
+    int64_t edge = (int64_t) event.ts.tv_sec * 1000000000L + event.ts.tv_nsec;
+    if( edge < (int64_t) start.tv_sec * 1000000000L + start.tv_nsec )
+      continue;
+
+    int64_t latency = (int64_t) now.tv_sec * 1000000000L + now.tv_nsec - edge;
+    if( 0 <= latency && UINT32_MAX >= latency ){
+      dev->aux.wakes ++;
+      dev->aux.last_ns = (uint32_t) latency;
+      dev->aux.total_ns += (uint64_t) latency;
+      if( dev->aux.max_ns < dev->aux.last_ns )
+        dev->aux.max_ns = dev->aux.last_ns;
     }
-    usleep( delay );
   }
-  
+
+  if( -1 == aux ){
+    perror("gpiod_digital_read");
+    return -1;    
+  }
+
   return 0;
 }
 
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t 
+e22900t22s_is_busy( e22900t22s_t * dev ){
+  if( !check( dev ) )
+    return -1;
+
+  int8_t aux = gpiod_digital_read( &dev->gpio.aux );
+  if( -1 == aux ){
+    perror("gpiod_digital_read");
+    return -1;    
+  }
+  return aux ? 0 : 1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_send( const uint16_t address, const uint8_t channel, const uint8_t * payload, const size_t length, e22900t22s_t * dev ){
+  if( !check( dev ) || !dev->serial || !payload || !length || E22900T22S_CHANNEL_MAX < channel || E22900T22S_LUT_SIZE_PACKET <= (uint32_t) dev->cfg.packet_size ){
+    errno = EINVAL;
+    return 0;
+  }
+  if( !dev->cfg.fixed ){
+    errno = EOPNOTSUPP;
+    return 0;
+  }
+  // A longer write would be split by the module, and only the first packet would carry the header
+  if( length > (size_t) lut_packet_bytes[ dev->cfg.packet_size ] - E22900T22S_FIXED_HEADER ){
+    errno = EMSGSIZE;
+    return 0;
+  }
+
+  uint8_t header[ E22900T22S_FIXED_HEADER ] = { (uint8_t) ( address >> 8 ), (uint8_t) address, channel };
+  struct iovec iov[2] = {
+    { .iov_base = header, .iov_len = E22900T22S_FIXED_HEADER },
+    { .iov_base = (void *) payload, .iov_len = length },
+  };
+
+  int first = 0;
+  while( 2 > first ){
+    ssize_t written = writev( dev->serial->sr.fd, &iov[ first ], 2 - first );
+    if( -1 == written ){
+      if( EINTR == errno )
+        continue;
+      struct pollfd out = { .fd = dev->serial->sr.fd, .events = POLLOUT };
+      if( EAGAIN == errno && -1 != poll( &out, 1, -1 ) )
+        continue;
+      perror("writev");
+      return 0;
+    }
+
+    // A short write leaves the rest of the vector for the next call
+    size_t skip = (size_t) written;
+    while( 2 > first && skip >= iov[ first ].iov_len )
+      skip -= iov[ first++ ].iov_len;
+    if( 2 > first ){
+      iov[ first ].iov_base = (uint8_t *) iov[ first ].iov_base + skip;
+      iov[ first ].iov_len -= skip;
+    }
+  }
+
+  return length;
+}
+
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int8_t 
 e22900t22s_connect_mixip( const char * name, e22900t22s_mixip_t * config ){
@@ -1191,71 +1706,48 @@ e22900t22s_load_mixip_config( const char * filename, e22900t22s_mixip_t * config
     return -1;
   }
 
-  xmlDoc * docfile = xmlReadFile( filename, NULL, 0 );
-  if( !docfile ){
-    errno = EINVAL;
-    perror("xmlReadFile");
-    return -1;
-  }
-  
-  xmlNode * root_element = xmlDocGetRootElement(docfile);
-  if( !root_element ){
-    errno = EINVAL;
-    perror("xmlDocGetRootElement");
-    xmlFreeDoc( docfile );
+  e22900t22s_config_t loaded;
+  if( -1 == e22900t22s_load( filename, &loaded ) )
     return -1;
-  }
-
-  memset( config, 0, sizeof(e22900t22s_mixip_t) );
-
-  xmlNode * translator = NULL;
-
-  if( !strcmp( (char *) root_element->name, "e22900t22s" ) ){
-    for( xmlNode * current_node = root_element->children ; current_node != NULL ; current_node = current_node->next ){
-      if( XML_ELEMENT_NODE == current_node->type ){
-        if( !strcmp( (char *) current_node->name, "translator" ) )
-          translator = current_node;        
-      }        
-    }
-  }  
-
-  if( NULL != translator ){
-    xmlNode * slots = NULL;
-    xmlNode * srsize = NULL;
 
-    for( xmlNode * current_node = translator->children ; current_node != NULL ; current_node = current_node->next ){
-      if( XML_ELEMENT_NODE == current_node->type ){
-        if( !strcmp( (char *) current_node->name, "slots" ) )
-          slots = current_node;        
-        if( !strcmp( (char *) current_node->name, "srsize" ) )
-          srsize = current_node;        
-      }
-    }
-
-    if( NULL != slots )
-      config->tmp.size_rb = (uint8_t) atoi( (const char *) xmlNodeGetContent( slots ) );
-    else
-      config->tmp.size_rb = E22900T22S_DEF_RB; // Default value
-
-    if( NULL != srsize )
-      config->tmp.size_sls = (uint8_t) atoi( (const char *) xmlNodeGetContent( srsize ) );
-    else
-      config->tmp.size_sls = E22900T22S_DEF_SLS; // Default value
-  }
-
-  xmlFreeDoc( docfile );
-  xmlCleanupParser( );
+  *config = loaded.translator;
   return 0;  
 }
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int8_t 
-e22900t22s_update_mixip_config( const e22900t22s_mixip_t * config ){
+e22900t22s_update_mixip_config( e22900t22s_mixip_t * config, const e22900t22s_eeprom_t * radio ){
   if( !config ){
     errno = EINVAL;
     return -1;
   }  
 
+  if( radio ){
+    uint8_t airrate = lookup_table_airrate_2bin( radio->airrate );
+    if( 0xFF == airrate || E22900T22S_LUT_SIZE_PACKET <= (uint32_t) radio->packet_size ){
+      errno = EINVAL;
+      return -1;
+    }
+
+    // A segment fills one RF packet, so the module neither splits it over two preambles nor sends a short one
+    uint32_t packet = (uint32_t) lut_packet_bytes[ radio->packet_size ] - ( radio->fixed ? E22900T22S_MIXIP_HEADER : 0 );
+    uint32_t serial = packet + ( radio->rssi ? 1 : 0 );
+    uint32_t slots = lut_airrate_bps[ airrate ] / 8 * E22900T22S_MIXIP_WINDOW / 1000 / serial;
+    if( slots > E22900T22S_MODULE_BUFFER / serial )
+      slots = E22900T22S_MODULE_BUFFER / serial;
+    if( !slots )
+      slots = 1;
+
+    uint8_t srsize = (uint8_t) ( packet - E22900T22S_MIXIP_LIMITERS - ( config->crc ? E22900T22S_CRC_TRAILER : 0 ) - ( config->compress ? E22900T22S_CODEC_HEADER : 0 ) -
+                                 ( config->rohc ? E22900T22S_ROHC_HEADER : 0 ) - ( config->fec_repairs ? E22900T22S_FEC_HEADER : 0 ) -
+                                 ( config->arq ? E22900T22S_ARQ_HEADER : 0 ) );
+    if( srsize != config->tmp.size_sls || slots != config->tmp.size_rb )
+      printf("[%d] Translator aligned with %u [B] packets at %s [bps], srsize: %u -> %u, slots: %u -> %u\n", getpid( ), packet, lut_airrate[ airrate ].text,
+             config->tmp.size_sls, srsize, config->tmp.size_rb, slots );
+    config->tmp.size_sls = srsize;
+    config->tmp.size_rb = (uint8_t) slots;
+  }
+
   if( -1 == mixip_translator_ring_buffer_size( config->tmp.size_rb, config->ptr ) ){
     perror("mixip_translator_ring_buffer_size");
     return -1;
@@ -1302,35 +1794,46 @@ e22900t22s_get_rssi( e22900t22s_rssi_t * rssi, e22900t22s_t * dev ){
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 float 
 e22900t22s_get_noise_rssi( e22900t22s_t * dev, uint8_t tmp ){
-  if( 0 < tmp ){
+  if( !check( dev ) )
+    return 0;
+
+  // Only the volatile register is touched, and only if the ambient noise is not already enabled
+  const uint8_t enable = 0 < tmp && !dev->cfg.ambient_noise;
+  if( enable ){
     e22900t22s_set_ambient_noise( 1, dev );
-    int8_t ret = e22900t22s_update_eeprom( dev );
+    int8_t ret = e22900t22s_update_temporary( dev );
     if( -1 == ret ){
-      perror("e22900t22s_update_eeprom 1");
+      perror("e22900t22s_update_temporary 1");
+      e22900t22s_set_ambient_noise( 0, dev );
       errno = ECANCELED;
       return 0;
     }
   }
 
-  e22900t22s_rssi_t noise;
-  if( dev->cfg.ambient_noise ){
-    if( -1 == e22900t22s_get_rssi( &noise, dev ) ){
-      perror("e22900t22s_get_rssi");
-      errno = ECANCELED;
-      return 0;
-    }
+  if( !dev->cfg.ambient_noise ){
+    errno = EPERM;
+    return 0;
   }
 
-  if( 0 < tmp ){
+  e22900t22s_rssi_t noise;
+  int8_t sampled = e22900t22s_get_rssi( &noise, dev );
+  if( -1 == sampled )
+    perror("e22900t22s_get_rssi");
+
+  if( enable ){
     e22900t22s_set_ambient_noise( 0, dev );
-    int8_t ret = e22900t22s_update_eeprom( dev );
+    int8_t ret = e22900t22s_update_temporary( dev );
     if( -1 == ret ){
-      perror("e22900t22s_update_eeprom 2");
+      perror("e22900t22s_update_temporary 2");
       errno = ECANCELED;
       return 0;
     }
   }
 
+  if( -1 == sampled ){
+    errno = ECANCELED;
+    return 0;
+  }
   return noise.current;
 }
 
@@ -1341,6 +1844,17 @@ e22900t22s_get_signal_rssi( const uint8_t data ){
 }
 
 
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+static inline void
+segment_limiter( e22900t22s_mixip_segments_t * st, const size_t i ){
+  if( 1 == st->count ){  // If a limiter was already identified, so this byte must represent the EOF
+    st->segment[ st->length ++ ].end = i;
+    st->count = 0;
+  }
+  else
+    st->count ++;
+}
+
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int8_t 
 e22900t22s_identify_segments( const uint8_t * data, const size_t len, e22900t22s_mixip_segments_t * st ){
@@ -1348,37 +1862,72 @@ e22900t22s_identify_segments( const uint8_t * data, const size_t len, e22900t22s
     errno = EINVAL;
     return -1;
   }
-   
-  if( 1 == st->segment[ st->length ].count ){
-    memset( st, 0, sizeof(e22900t22s_mixip_segments_t) );
-    st->segment[0].count = 1;
-    st->length = 0;
-  }
-  else 
-    memset( st, 0, sizeof(e22900t22s_mixip_segments_t) );
 
+  st->length = 0;
+  st->first = 0;
 
-  const uint8_t limiter = 0x00;
-  for( size_t i = 0 ; i < len ; ++i ){
-    if( NSEG_MAX <= st->length + 1 ){
-      errno = ENOSPC;
+  // Every second limiter closes a segment, so the worst case is known before scanning and the loops never check the capacity
+  size_t needed = ( len + st->count ) / 2;
+  if( needed > st->capacity ){
+    size_t capacity = st->capacity ? st->capacity : NSEG_MAX;
+    while( capacity < needed )
+      capacity *= 2;
+
+    mixip_segments_t * segment = (mixip_segments_t *) realloc( st->segment, capacity * sizeof(mixip_segments_t) );
+    if( !segment ){
+      errno = ENOMEM;
       return -1;
     }
-      
-    if( limiter == data[i] ){
-      if( 1 == st->segment[ st->length ].count ){  // If a limiter was already identified, so this byte must represent the EOF
-        st->segment[ st->length ++ ].end = i;
-        if( i + 1 == len )
-          st->first = 1;
-      }
-      else
-        st->segment[ st->length ].count ++;
-    }
-  }
+    st->segment = segment;
+    st->capacity = capacity;
+  }
+
+  size_t i = 0;
+#if defined(__AVX2__)
+  const __m256i zero32 = _mm256_setzero_si256( );
+  for( ; i + 32 <= len ; i += 32 ){
+    uint32_t mask = (uint32_t) _mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_loadu_si256( (const __m256i *) &data[i] ), zero32 ) );
+    for( ; mask ; mask &= mask - 1 )
+      segment_limiter( st, i + (size_t) __builtin_ctz( mask ) );
+  }
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+  const __m128i zero16 = _mm_setzero_si128( );
+  for( ; i + 16 <= len ; i += 16 ){
+    uint32_t mask = (uint32_t) _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i *) &data[i] ), zero16 ) );
+    for( ; mask ; mask &= mask - 1 )
+      segment_limiter( st, i + (size_t) __builtin_ctz( mask ) );
+  }
+#elif defined(__ARM_NEON)
+  for( ; i + 16 <= len ; i += 16 ){
+    // NEON has no movemask, narrowing by 4 leaves one nibble per byte in a 64 bit word
+    uint8x16_t eq = vceqq_u8( vld1q_u8( &data[i] ), vdupq_n_u8( 0 ) );
+    uint64_t mask = vget_lane_u64( vreinterpret_u64_u8( vshrn_n_u16( vreinterpretq_u16_u8( eq ), 4 ) ), 0 ) & 0x8888888888888888ULL;
+    for( ; mask ; mask &= mask - 1 )
+      segment_limiter( st, i + (size_t) ( __builtin_ctzll( mask ) >> 2 ) );
+  }
+#endif
+
+  const uint8_t limiter = 0x00;
+  for( ; i < len ; ++i )
+    if( limiter == data[i] )
+      segment_limiter( st, i );
+
+  if( st->length && st->segment[ st->length - 1 ].end + 1 == len )
+    st->first = 1;
 
   return 0;
 }
 
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_free_segments( e22900t22s_mixip_segments_t * st ){
+  if( !st )
+    return;
+  free( st->segment );
+  memset( st, 0, sizeof(e22900t22s_mixip_segments_t) );
+}
+
 
 /***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
  * End file
@@ -0,0 +1,364 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s_adapt.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/adapt.h>
+#include <errno.h>
+#include <string.h>
+#include <math.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+uint32_t adapt_pack( const e22900t22s_adapt_msg_t * msg );
+void adapt_unpack( const uint32_t packed, e22900t22s_adapt_msg_t * msg );
+uint8_t adapt_check( const uint8_t * body );
+uint8_t adapt_switch( e22900t22s_adapt_t * adapt, const uint32_t now, const uint8_t airrate, const uint8_t packet, const uint8_t initiator );
+uint8_t adapt_revert( e22900t22s_adapt_t * adapt, const uint32_t now );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Tables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+// SNR the demodulator needs at each air rate (dB), the spreading factor drops as the air rate goes up
+static const float adapt_required[ E22900T22S_LUT_SIZE_AIRRATE ] = { -20.0f, -17.5f, -15.0f, -12.5f, -10.0f, -7.5f, -5.0f, -2.5f };
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t
+adapt_pack( const e22900t22s_adapt_msg_t * msg ){
+  return (uint32_t) msg->type << 24 | (uint32_t) msg->epoch << 16 | (uint32_t) msg->airrate << 8 | msg->packet;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+adapt_unpack( const uint32_t packed, e22900t22s_adapt_msg_t * msg ){
+  msg->type = (uint8_t) ( packed >> 24 );
+  msg->epoch = (uint8_t) ( packed >> 16 );
+  msg->airrate = (uint8_t) ( packed >> 8 );
+  msg->packet = (uint8_t) packed;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t
+adapt_check( const uint8_t * body ){
+  uint32_t sum = 0;
+  for( uint8_t i = 0 ; i < E22900T22S_ADAPT_BODY - 1 ; ++i )
+    sum += body[ i ];
+  return (uint8_t) ( sum % 255 + 1 );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t
+adapt_switch( e22900t22s_adapt_t * adapt, const uint32_t now, const uint8_t airrate, const uint8_t packet, const uint8_t initiator ){
+  adapt->previous_airrate = adapt->airrate;
+  adapt->previous_packet = adapt->packet;
+  adapt->airrate = airrate;
+  adapt->packet = packet;
+  adapt->state = E22900T22S_ADAPT_CONFIRMING;
+  adapt->initiator = initiator;
+  adapt->tries = 0;
+  adapt->wins = 0;
+  adapt->deadline = now + E22900T22S_ADAPT_CONFIRM;
+  adapt->silence = adapt->deadline + E22900T22S_ADAPT_SILENCE;
+  adapt->heard = 0;
+  __atomic_store_n( &adapt->samples, 0, __ATOMIC_RELAXED );
+  return E22900T22S_ADAPT_APPLY;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t
+adapt_revert( e22900t22s_adapt_t * adapt, const uint32_t now ){
+  uint8_t airrate = adapt->airrate, packet = adapt->packet;
+  adapt->airrate = adapt->previous_airrate;
+  adapt->packet = adapt->previous_packet;
+  adapt->previous_airrate = airrate;
+  adapt->previous_packet = packet;
+  adapt->silence = now + E22900T22S_ADAPT_SILENCE;
+  adapt->heard = 0;
+  __atomic_store_n( &adapt->samples, 0, __ATOMIC_RELAXED );
+  return E22900T22S_ADAPT_APPLY;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_adapt_init( e22900t22s_adapt_t * adapt, const e22900t22s_eeprom_t * cfg ){
+  if( !adapt || !cfg ){
+    errno = EINVAL;
+    return -1;
+  }
+
+  memset( adapt, 0, sizeof(e22900t22s_adapt_t) );
+  adapt->airrate = lookup_table_airrate_2bin( cfg->airrate );
+  if( E22900T22S_LUT_SIZE_AIRRATE <= adapt->airrate || E22900T22S_LUT_SIZE_PACKET <= (uint32_t) cfg->packet_size ){
+    errno = EINVAL;
+    return -1;
+  }
+  adapt->packet = (uint8_t) cfg->packet_size;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_adapt_sample( e22900t22s_adapt_t * adapt, const float SNR ){
+  // The first packet after a switch restarts the average, the SNR on the previous setting no longer applies
+  float snr = adapt->snr;
+  if( 0 == __atomic_fetch_add( &adapt->samples, 1, __ATOMIC_RELAXED ) )
+    snr = SNR;
+  else
+    snr += E22900T22S_ADAPT_ALPHA * ( SNR - snr );
+  __atomic_store( &adapt->snr, &snr, __ATOMIC_RELEASE );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_adapt_post( e22900t22s_adapt_t * adapt, const e22900t22s_adapt_msg_t * msg ){
+  __atomic_store_n( &adapt->inbox, adapt_pack( msg ), __ATOMIC_RELEASE );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+float
+e22900t22s_adapt_goodput( const uint8_t airrate, const e22900t22s_packet_size_t packet, const float snr ){
+  float size = (float) lut_packet_bytes[ packet ];
+  float success = 1.0f / ( 1.0f + expf( -( snr - adapt_required[ airrate ] ) / E22900T22S_ADAPT_SLOPE ) );
+  return (float) lut_airrate_bps[ airrate ] * size / ( size + E22900T22S_ADAPT_OVERHEAD ) * powf( success, size / 32.0f );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t
+e22900t22s_adapt_step( e22900t22s_adapt_t * adapt, const uint32_t now, e22900t22s_adapt_msg_t * msg ){
+  e22900t22s_adapt_msg_t in;
+  adapt_unpack( __atomic_exchange_n( &adapt->inbox, 0, __ATOMIC_ACQUIRE ), &in );
+
+  switch( in.type ){
+    case E22900T22S_ADAPT_PROPOSE:
+      if( E22900T22S_ADAPT_CONFIRMING == adapt->state )
+        break;
+      if( E22900T22S_ADAPT_PROPOSED == adapt->state ){
+        // Crossing proposals, both ends keep the most robust one, the slowest air rate and then the smallest packet
+        if( in.airrate > adapt->target_airrate || ( in.airrate == adapt->target_airrate && in.packet < adapt->target_packet ) )
+          break;
+        // The same setting was proposed by both, each takes the other proposal as the answer to its own
+        if( in.airrate == adapt->target_airrate && in.packet == adapt->target_packet ){
+          adapt->epoch = in.epoch > adapt->epoch ? in.epoch : adapt->epoch;
+          return adapt_switch( adapt, now, in.airrate, in.packet, 1 );
+        }
+      }
+
+      adapt->epoch = in.epoch;
+      *msg = in;
+      msg->type = E22900T22S_ADAPT_ACCEPT;
+      return E22900T22S_ADAPT_SEND | adapt_switch( adapt, now, in.airrate, in.packet, 0 );
+
+    case E22900T22S_ADAPT_ACCEPT:
+      if( E22900T22S_ADAPT_PROPOSED != adapt->state || in.epoch != adapt->epoch )
+        break;
+      return adapt_switch( adapt, now, adapt->target_airrate, adapt->target_packet, 1 );
+
+    case E22900T22S_ADAPT_ACK:
+      if( in.epoch != adapt->epoch || in.airrate != adapt->airrate || in.packet != adapt->packet )
+        break;
+
+      // The proposer keeps sending ACK until it hears one back, the peer answers every one of them
+      // When both proposed, the end that had not sent its own ACK yet answers the first one
+      uint8_t reply = !adapt->initiator || ( E22900T22S_ADAPT_CONFIRMING == adapt->state && !adapt->tries );
+      if( E22900T22S_ADAPT_CONFIRMING == adapt->state ){
+        adapt->state = E22900T22S_ADAPT_IDLE;
+        adapt->dwell = now + E22900T22S_ADAPT_DWELL;
+      }
+      if( reply ){
+        *msg = in;
+        return E22900T22S_ADAPT_SEND;
+      }
+      return 0;
+
+    default:
+      break;
+  }
+
+  msg->epoch = adapt->epoch;
+  switch( adapt->state ){
+    case E22900T22S_ADAPT_PROPOSED:
+      if( now < adapt->deadline )
+        return 0;
+      if( adapt->tries >= E22900T22S_ADAPT_RETRIES ){
+        adapt->state = E22900T22S_ADAPT_IDLE;
+        adapt->dwell = now + E22900T22S_ADAPT_DWELL;
+        return 0;
+      }
+      adapt->tries++;
+      adapt->deadline = now + E22900T22S_ADAPT_WAIT;
+      msg->type = E22900T22S_ADAPT_PROPOSE;
+      msg->airrate = adapt->target_airrate;
+      msg->packet = adapt->target_packet;
+      return E22900T22S_ADAPT_SEND;
+
+    case E22900T22S_ADAPT_CONFIRMING:
+      if( now >= adapt->deadline ){
+        adapt->state = E22900T22S_ADAPT_IDLE;
+        adapt->dwell = now + E22900T22S_ADAPT_DWELL;
+
+        // Anything received on the new setting was sent by the peer after it switched too
+        if( __atomic_load_n( &adapt->samples, __ATOMIC_RELAXED ) )
+          return 0;
+        return adapt_revert( adapt, now );
+      }
+      if( !adapt->initiator )
+        return 0;
+      adapt->tries++;
+      msg->type = E22900T22S_ADAPT_ACK;
+      msg->airrate = adapt->airrate;
+      msg->packet = adapt->packet;
+      return E22900T22S_ADAPT_SEND;
+
+    default:
+    case E22900T22S_ADAPT_IDLE:
+      break;
+  }
+
+  uint32_t samples = __atomic_load_n( &adapt->samples, __ATOMIC_RELAXED );
+
+  // The end that proposed the setting has heard nothing new on it for long, the peer is on the other one
+  if( now >= adapt->silence ){
+    uint32_t heard = adapt->heard;
+    adapt->heard = samples;
+    adapt->silence = now + E22900T22S_ADAPT_SILENCE;
+    if( adapt->initiator && samples == heard )
+      return adapt_revert( adapt, now );
+  }
+
+  if( now < adapt->dwell || samples < E22900T22S_ADAPT_SAMPLES )
+    return 0;
+
+  float snr;
+  __atomic_load( &adapt->snr, &snr, __ATOMIC_ACQUIRE );
+
+  uint8_t airrate = adapt->airrate, packet = adapt->packet;
+  float current = e22900t22s_adapt_goodput( adapt->airrate, (e22900t22s_packet_size_t) adapt->packet, snr ), best = current;
+  for( uint8_t a = 0 ; a < E22900T22S_LUT_SIZE_AIRRATE ; ++a )
+    for( uint8_t p = 0 ; p < E22900T22S_LUT_SIZE_PACKET ; ++p ){
+      float goodput = e22900t22s_adapt_goodput( a, (e22900t22s_packet_size_t) p, snr );
+      if( goodput > best ){
+        best = goodput;
+        airrate = a;
+        packet = p;
+      }
+    }
+
+  // Hysteresis, the winner has to beat the current setting by a margin and stay the same for a few evaluations
+  if( best < E22900T22S_ADAPT_GAIN * current || airrate != adapt->target_airrate || packet != adapt->target_packet ){
+    adapt->target_airrate = airrate;
+    adapt->target_packet = packet;
+    adapt->wins = best < E22900T22S_ADAPT_GAIN * current ? 0 : 1;
+  }
+  else
+    adapt->wins++;
+
+  if( adapt->wins < E22900T22S_ADAPT_HOLD )
+    return 0;
+
+  adapt->wins = 0;
+  adapt->epoch = (uint8_t) ( adapt->epoch % 255 + 1 );
+  adapt->state = E22900T22S_ADAPT_PROPOSED;
+  adapt->tries = 1;
+  adapt->deadline = now + E22900T22S_ADAPT_WAIT;
+  msg->type = E22900T22S_ADAPT_PROPOSE;
+  msg->epoch = adapt->epoch;
+  msg->airrate = airrate;
+  msg->packet = packet;
+  return E22900T22S_ADAPT_SEND;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_adapt_publish( e22900t22s_adapt_t * adapt ){
+  // Only the loop process writes it, the count tells the readers apart two switches to the same setting
+  uint32_t changes = ( __atomic_load_n( &adapt->applied, __ATOMIC_RELAXED ) >> 16 ) + 1;
+  __atomic_store_n( &adapt->applied, changes << 16 | (uint32_t) adapt->airrate << 8 | adapt->packet, __ATOMIC_RELEASE );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t
+e22900t22s_adapt_refresh( const e22900t22s_adapt_t * adapt, uint32_t * seen, e22900t22s_eeprom_t * cfg ){
+  uint32_t applied = __atomic_load_n( &adapt->applied, __ATOMIC_ACQUIRE );
+  if( applied == *seen )
+    return 0;
+  *seen = applied;
+  cfg->airrate = lut_airrate[ ( applied >> 8 ) & 0xFF ].code;
+  cfg->packet_size = lut_packetsize[ applied & 0xFF ].code;
+  return 1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_adapt_frame( const e22900t22s_adapt_msg_t * msg, uint8_t * frame ){
+  // Every field is kept away from zero, the segment limiter
+  uint8_t * body = &frame[ 1 ];
+  memcpy( body, E22900T22S_ADAPT_MAGIC, 3 );
+  body[ 3 ] = msg->type;
+  body[ 4 ] = msg->epoch;
+  body[ 5 ] = (uint8_t) ( msg->airrate + 1 );
+  body[ 6 ] = (uint8_t) ( msg->packet + 1 );
+  body[ 7 ] = adapt_check( body );
+  frame[ 0 ] = 0x00;
+  frame[ E22900T22S_ADAPT_FRAME - 1 ] = 0x00;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_adapt_parse( const uint8_t * data, const size_t len, e22900t22s_adapt_msg_t * msg ){
+  if( !data || !msg || E22900T22S_ADAPT_FRAME != len )
+    return 0;
+
+  const uint8_t * body = &data[ 1 ];
+  if( data[ 0 ] || data[ len - 1 ] || memcmp( body, E22900T22S_ADAPT_MAGIC, 3 ) || adapt_check( body ) != body[ 7 ] )
+    return 0;
+  if( !body[ 4 ] || !body[ 5 ] || body[ 5 ] > E22900T22S_LUT_SIZE_AIRRATE || !body[ 6 ] || body[ 6 ] > E22900T22S_LUT_SIZE_PACKET )
+    return 0;
+
+  switch( body[ 3 ] ){
+    case E22900T22S_ADAPT_PROPOSE:
+    case E22900T22S_ADAPT_ACCEPT:
+    case E22900T22S_ADAPT_ACK:
+      break;
+    default:
+      return 0;
+  }
+
+  msg->type = body[ 3 ];
+  msg->epoch = body[ 4 ];
+  msg->airrate = (uint8_t) ( body[ 5 ] - 1 );
+  msg->packet = (uint8_t) ( body[ 6 ] - 1 );
+  return 1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
@@ -0,0 +1,146 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s_airtime.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/airtime.h>
+#include <string.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+void duty_refill( e22900t22s_bucket_t * bucket, const uint16_t rate, const uint64_t now );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Tables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+// ERC Recommendation 70-03 annex 1, the carriers 850.125 MHz + n x 1 MHz fall in the first sub-bands
+static const e22900t22s_subband_t subbands[ E22900T22S_SUBBANDS ] = {
+  { "h1.3", 863000, 865000, 10 },
+  { "h1.4", 865000, 868000, 100 },
+  { "g1",   868000, 868600, 100 },
+  { "g2",   868700, 869200, 10 },
+  { "g3",   869400, 869650, 1000 },
+  { "g4",   869700, 870000, 100 },
+  { "none", 0,      0,      E22900T22S_DUTY_FULL },
+};
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t
+e22900t22s_airtime( const e22900t22s_eeprom_t * cfg, const size_t len, uint64_t * busy ){
+  uint8_t airrate = lookup_table_airrate_2bin( cfg->airrate );
+  if( E22900T22S_LUT_SIZE_AIRRATE <= airrate || E22900T22S_LUT_SIZE_PACKET <= (uint32_t) cfg->packet_size )
+    return 0;
+
+  uint64_t size = lut_packet_bytes[ cfg->packet_size ];
+  uint64_t packets = len ? ( len + size - 1 ) / size : 0;
+  uint64_t bytes = len + packets * E22900T22S_AIRTIME_OVERHEAD;
+  uint64_t airtime = bytes * 8 * 1000000 / lut_airrate_bps[ airrate ];
+  if( cfg->wor && (uint32_t) cfg->wor_cycle < E22900T22S_LUT_SIZE_WORCYCLE )
+    airtime += packets * lut_worcycle_ms[ cfg->wor_cycle ] * 1000;
+
+  if( busy )
+    *busy = airtime + ( cfg->lbt ? packets * E22900T22S_AIRTIME_LBT : 0 );
+  return airtime;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t
+e22900t22s_subband( const uint8_t channel ){
+  uint32_t carrier = E22900T22S_BASE_KHZ + (uint32_t) channel * 1000;
+  for( uint8_t i = 0 ; i < E22900T22S_SUBBANDS - 1 ; ++i )
+    if( carrier >= subbands[ i ].low && carrier < subbands[ i ].high )
+      return i;
+  return E22900T22S_SUBBANDS - 1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+const e22900t22s_subband_t *
+e22900t22s_subband_info( const uint8_t band ){
+  return band < E22900T22S_SUBBANDS ? &subbands[ band ] : NULL;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+duty_refill( e22900t22s_bucket_t * bucket, const uint16_t rate, const uint64_t now ){
+  int64_t capacity = (int64_t) rate * E22900T22S_DUTY_WINDOW * 1000000 / E22900T22S_DUTY_FULL;
+  if( now > bucket->last ){
+    bucket->tokens += (int64_t) ( ( now - bucket->last ) / 1000 * rate / E22900T22S_DUTY_FULL );
+    bucket->last = now;
+  }
+  if( bucket->tokens > capacity )
+    bucket->tokens = capacity;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_duty_init( e22900t22s_duty_t * duty, const uint64_t now ){
+  memset( duty, 0, sizeof(e22900t22s_duty_t) );
+  for( uint8_t i = 0 ; i < E22900T22S_SUBBANDS ; ++i ){
+    duty->bucket[ i ].tokens = (int64_t) subbands[ i ].duty * E22900T22S_DUTY_WINDOW * 1000000 / E22900T22S_DUTY_FULL;
+    duty->bucket[ i ].last = now;
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t
+e22900t22s_duty_reserve( e22900t22s_duty_t * duty, const uint8_t band, const uint64_t airtime, const uint64_t now ){
+  duty->airtime += airtime;
+  if( band >= E22900T22S_SUBBANDS - 1 )
+    return 0;
+
+  e22900t22s_bucket_t * bucket = &duty->bucket[ band ];
+  duty_refill( bucket, subbands[ band ].duty, now );
+  bucket->tokens -= (int64_t) airtime;
+  if( bucket->tokens >= 0 )
+    return 0;
+
+  // The debt is paid back at the rate the bucket refills
+  uint64_t wait = (uint64_t) -bucket->tokens * E22900T22S_DUTY_FULL / subbands[ band ].duty;
+  duty->delayed += wait;
+  duty->held++;
+  return wait;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t
+e22900t22s_duty_budget( e22900t22s_duty_t * duty, const uint8_t band, const uint64_t now ){
+  if( band >= E22900T22S_SUBBANDS - 1 )
+    return UINT64_MAX;
+
+  e22900t22s_bucket_t * bucket = &duty->bucket[ band ];
+  duty_refill( bucket, subbands[ band ].duty, now );
+  return bucket->tokens > 0 ? (uint64_t) bucket->tokens : 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
@@ -0,0 +1,474 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s_arq.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/arq.h>
+#include <e22900t22s/airtime.h>
+#include <errno.h>
+#include <string.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define ARQ_MS          1000000ULL                   // Nanoseconds in a millisecond
+#define ARQ_SLOT( s )   ( (s) % E22900T22S_ARQ_WINDOW )
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+uint16_t arq_distance( const uint16_t to, const uint16_t from );
+void arq_sample( e22900t22s_arq_t * arq, const uint64_t rtt );
+void arq_acked( e22900t22s_arq_t * arq, e22900t22s_arq_slot_t * slot, const uint64_t now );
+void arq_slide( e22900t22s_arq_t * arq );
+int8_t arq_sequence( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+void arq_ack( e22900t22s_arq_t * arq, const uint8_t * body, const size_t len, const uint64_t now );
+int8_t arq_advance( e22900t22s_arq_t * arq, const uint8_t skip, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+uint64_t arq_hold( const e22900t22s_arq_t * arq );
+int8_t arq_expire( e22900t22s_arq_t * arq, const uint64_t now, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+int8_t arq_segment( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint16_t
+arq_distance( const uint16_t to, const uint16_t from ){
+  return (uint16_t) ( ( to - from ) & ( E22900T22S_ARQ_SEQUENCES - 1 ) );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_arq_init( e22900t22s_arq_t * arq, const e22900t22s_eeprom_t * cfg, const uint16_t capacity ){
+  if( !arq || !cfg || !capacity ){
+    errno = EINVAL;
+    return -1;
+  }
+  memset( arq, 0, sizeof(e22900t22s_arq_t) );
+  arq->capacity = capacity;
+
+  // The state lives in shared memory, the lock has to hold across the processes
+  if( -1 == e22900t22s_shared_mutex_init( &arq->lock ) )
+    return -1;
+
+  e22900t22s_arq_tune( arq, cfg );
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_arq_tune( e22900t22s_arq_t * arq, const e22900t22s_eeprom_t * cfg ){
+  size_t packet = lut_packet_bytes[ cfg->packet_size ];
+  size_t window = 2u * arq->capacity / packet;
+  if( window < E22900T22S_ARQ_WINDOW_MIN )
+    window = E22900T22S_ARQ_WINDOW_MIN;
+  if( window > E22900T22S_ARQ_WINDOW )
+    window = E22900T22S_ARQ_WINDOW;
+
+  // A segment, its acknowledgement held back by the spacing for up to another packet, and the turnaround
+  uint64_t spacing = e22900t22s_airtime( cfg, packet, NULL ) * 1000;
+  uint64_t floor = 2 * spacing + e22900t22s_airtime( cfg, E22900T22S_ARQ_FRAME, NULL ) * 1000 +
+                   ( E22900T22S_ARQ_TURNAROUND + E22900T22S_ARQ_TICK ) * ARQ_MS;
+  // The samples of the previous air rate say nothing of the new one, the estimator starts over
+  uint64_t rto = floor + e22900t22s_airtime( cfg, arq->capacity, NULL ) * 1000;
+  if( rto > E22900T22S_ARQ_RTO_MAX * 1000 * ARQ_MS )
+    rto = E22900T22S_ARQ_RTO_MAX * 1000 * ARQ_MS;
+
+  e22900t22s_shared_mutex_lock( &arq->lock );
+  arq->window = (uint8_t) window;
+  arq->floor = floor;
+  arq->spacing = spacing;
+  arq->srtt = arq->rttvar = 0;
+  arq->rto = rto;
+  pthread_mutex_unlock( &arq->lock );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+arq_sample( e22900t22s_arq_t * arq, const uint64_t rtt ){
+  // RFC 6298, with the air time of a round trip as lower bound instead of one second
+  if( !arq->srtt ){
+    arq->srtt = rtt;
+    arq->rttvar = rtt / 2;
+  }
+  else{
+    uint64_t delta = arq->srtt > rtt ? arq->srtt - rtt : rtt - arq->srtt;
+    arq->rttvar = ( 3 * arq->rttvar + delta ) / 4;
+    arq->srtt = ( 7 * arq->srtt + rtt ) / 8;
+  }
+  // The variation is never under the tick, the acknowledgement waits up to one in the loop process of the peer
+  arq->rto = arq->srtt + ( 4 * arq->rttvar > E22900T22S_ARQ_TICK * ARQ_MS ? 4 * arq->rttvar : E22900T22S_ARQ_TICK * ARQ_MS );
+  if( arq->rto < arq->floor )
+    arq->rto = arq->floor;
+  if( arq->rto > E22900T22S_ARQ_RTO_MAX * 1000 * ARQ_MS )
+    arq->rto = E22900T22S_ARQ_RTO_MAX * 1000 * ARQ_MS;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+arq_acked( e22900t22s_arq_t * arq, e22900t22s_arq_slot_t * slot, const uint64_t now ){
+  if( !slot->used || slot->acked )
+    return;
+  slot->acked = 1;
+  arq->acked++;
+  // Karn, an acknowledgement of a segment sent more than once does not tell which copy it answers
+  if( 1 == slot->tries && now > slot->sent )
+    arq_sample( arq, now - slot->sent );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+arq_slide( e22900t22s_arq_t * arq ){
+  while( arq->base != arq->next && arq->slot[ ARQ_SLOT( arq->base ) ].acked ){
+    arq->slot[ ARQ_SLOT( arq->base ) ].used = 0;
+    arq->base = (uint16_t) ( ( arq->base + 1 ) % E22900T22S_ARQ_SEQUENCES );
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t
+e22900t22s_arq_wait( e22900t22s_arq_t * arq, const uint8_t * data, const size_t len ){
+  // Every whole segment has two limiters
+  size_t count = 0;
+  for( size_t i = e22900t22s_segment_limiter( data, 0, len ) ; i < len ; i = e22900t22s_segment_limiter( data, i + 1, len ) )
+    ++count;
+  count /= 2;
+
+  e22900t22s_shared_mutex_lock( &arq->lock );
+  size_t needed = count < arq->window ? count : arq->window;
+  size_t flight = arq_distance( arq->next, arq->base );
+  size_t room = arq->window > flight ? arq->window - flight : 0;
+  pthread_mutex_unlock( &arq->lock );
+  return room >= needed ? 0 : E22900T22S_ARQ_TICK * ARQ_MS;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+arq_sequence( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  (void) rssi;
+  (void) with_rssi;
+  e22900t22s_arq_t * arq = (e22900t22s_arq_t *) stage;
+  if( *length + len + E22900T22S_ARQ_HEADER + 2 > size ){
+    errno = ENOBUFS;
+    return -1;
+  }
+  if( len + E22900T22S_ARQ_HEADER > E22900T22S_ARQ_SEGMENT ){
+    errno = EMSGSIZE;
+    return -1;
+  }
+
+  // A segment without room in the window goes without sequence number
+  out[ (*length)++ ] = 0x00;
+  uint8_t * header = &out[ *length ];
+  header[0] = header[1] = E22900T22S_ARQ_PLAIN;
+  *length += E22900T22S_ARQ_HEADER;
+  memcpy( &out[ *length ], body, len );
+  *length += len;
+  out[ (*length)++ ] = 0x00;
+  if( arq_distance( arq->next, arq->base ) >= arq->window )
+    return 0;
+
+  header[0] = (uint8_t) ( 0x80 | arq->next >> 7 );
+  header[1] = (uint8_t) ( 0x80 | ( arq->next & 0x7F ) );
+  e22900t22s_arq_slot_t * slot = &arq->slot[ ARQ_SLOT( arq->next ) ];
+  slot->used = 1;
+  slot->acked = slot->lost = 0;
+  slot->tries = 1;
+  slot->sent = arq->now;
+  slot->length = (uint16_t) ( len + E22900T22S_ARQ_HEADER );
+  memcpy( slot->data, header, slot->length );
+  arq->next = (uint16_t) ( ( arq->next + 1 ) % E22900T22S_ARQ_SEQUENCES );
+  arq->sent++;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_arq_pack( e22900t22s_arq_t * arq, const uint8_t * data, const size_t len, const uint64_t now, uint8_t * out, const size_t size ){
+  if( !arq || !data || !out ){
+    errno = EINVAL;
+    return 0;
+  }
+
+  // A segment still open at the end of `data` waits for the write that closes it, the copy kept for the retransmissions is whole
+  e22900t22s_shared_mutex_lock( &arq->lock );
+  arq->now = now;
+  size_t length = e22900t22s_segment_walk( &arq->writer, data, len, 0, NULL, arq_sequence, arq, out, size );
+  pthread_mutex_unlock( &arq->lock );
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+arq_ack( e22900t22s_arq_t * arq, const uint8_t * body, const size_t len, const uint64_t now ){
+  if( len < 3 || !( body[1] & 0x80 ) || !( body[2] & 0x80 ) )
+    return;
+  uint16_t expected = (uint16_t) ( ( body[1] & 0x3F ) << 7 | ( body[2] & 0x7F ) );
+  uint16_t flight = arq_distance( arq->next, arq->base );
+  uint16_t cumulative = arq_distance( expected, arq->base );
+  // An acknowledgement older than the window, or of segments never sent, is stale
+  if( cumulative > flight )
+    return;
+
+  for( uint16_t k = 0 ; k < cumulative ; ++k )
+    arq_acked( arq, &arq->slot[ ARQ_SLOT( arq->base + k ) ], now );
+
+  // Bit b of the bitmap is segment `expected + 1 + b`, 7 bits per byte
+  size_t highest = 0;
+  for( size_t b = 0 ; 3 + b / 7 < len ; ++b ){
+    uint8_t byte = body[ 3 + b / 7 ];
+    if( !( byte & 0x80 ) )
+      break;
+    if( !( byte >> ( b % 7 ) & 1u ) )
+      continue;
+    size_t offset = cumulative + 1 + b;
+    if( offset >= flight )
+      break;
+    arq_acked( arq, &arq->slot[ ARQ_SLOT( arq->base + offset ) ], now );
+    highest = b + 1;
+  }
+
+  // The segments missing before the last one acknowledged are lost, they go again unless they were just sent
+  uint64_t recent = arq->srtt ? arq->srtt : arq->floor;
+  for( size_t k = 0 ; k < highest ; ++k ){
+    e22900t22s_arq_slot_t * slot = &arq->slot[ ARQ_SLOT( arq->base + cumulative + k ) ];
+    if( slot->used && !slot->acked && now - slot->sent >= recent )
+      slot->lost = 1;
+  }
+  arq_slide( arq );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_arq_poll( e22900t22s_arq_t * arq, const uint64_t now, uint8_t * out, const size_t size, uint32_t * abandoned ){
+  size_t length = 0;
+  uint32_t given = 0;
+
+  e22900t22s_shared_mutex_lock( &arq->lock );
+  // One acknowledgement per packet on the air at most, the later segments are reported by the next one
+  if( arq->pending && now >= arq->acknowledged + arq->spacing && size >= E22900T22S_ARQ_FRAME ){
+    out[ length++ ] = 0x00;
+    out[ length++ ] = E22900T22S_ARQ_ACK;
+    out[ length++ ] = (uint8_t) ( 0x80 | arq->expected >> 7 );
+    out[ length++ ] = (uint8_t) ( 0x80 | ( arq->expected & 0x7F ) );
+    // The segments waiting after the gap, the empty bytes at the end are left out
+    for( uint64_t bitmap = arq->held >> 1 ; bitmap ; bitmap >>= 7 )
+      out[ length++ ] = (uint8_t) ( 0x80 | ( bitmap & 0x7F ) );
+    out[ length++ ] = 0x00;
+    arq->pending = 0;
+    arq->acknowledged = now;
+    arq->acks++;
+  }
+
+  uint16_t flight = arq_distance( arq->next, arq->base );
+  for( uint16_t k = 0 ; k < flight ; ++k ){
+    e22900t22s_arq_slot_t * slot = &arq->slot[ ARQ_SLOT( arq->base + k ) ];
+    if( !slot->used || slot->acked )
+      continue;
+    uint8_t backoff = slot->tries - 1u > E22900T22S_ARQ_BACKOFF ? E22900T22S_ARQ_BACKOFF : (uint8_t) ( slot->tries - 1u );
+    if( !slot->lost && now < slot->sent + ( arq->rto << backoff ) )
+      continue;
+    if( slot->tries >= E22900T22S_ARQ_RETRIES ){
+      slot->acked = 1;
+      arq->abandoned++;
+      given++;
+      continue;
+    }
+    if( length + slot->length + 2 > size )
+      break;
+    out[ length++ ] = 0x00;
+    memcpy( &out[ length ], slot->data, slot->length );
+    length += slot->length;
+    out[ length++ ] = 0x00;
+    slot->tries++;
+    slot->sent = now;
+    slot->lost = 0;
+    arq->resent++;
+  }
+  arq_slide( arq );
+  pthread_mutex_unlock( &arq->lock );
+
+  if( abandoned )
+    *abandoned = given;
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+arq_advance( e22900t22s_arq_t * arq, const uint8_t skip, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  // Moves past `expected`, then hands every segment that only waited for it
+  if( skip )
+    arq->skipped++;
+  while( 1 ){
+    arq->expected = (uint16_t) ( ( arq->expected + 1 ) % E22900T22S_ARQ_SEQUENCES );
+    arq->held >>= 1;
+    if( !( arq->held & 1u ) )
+      return 0;
+    uint8_t s = ARQ_SLOT( arq->expected );
+    if( -1 == e22900t22s_segment_emit( arq->held_data[s], arq->held_length[s], arq->held_rssi[s], with_rssi, out, length, size ) )
+      return -1;
+    arq->delivered++;
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t
+arq_hold( const e22900t22s_arq_t * arq ){
+  // The time the sender takes to give a segment up, every timeout with its backoff
+  uint64_t hold = 0;
+  for( uint8_t t = 0 ; t < E22900T22S_ARQ_RETRIES ; ++t )
+    hold += arq->rto << ( t > E22900T22S_ARQ_BACKOFF ? E22900T22S_ARQ_BACKOFF : t );
+  return hold;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+arq_expire( e22900t22s_arq_t * arq, const uint64_t now, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  if( !arq->held || now - arq->gap <= arq_hold( arq ) )
+    return 0;
+
+  // Only the oldest gap is given up, the segments behind a later one arrived later and wait a full hold again
+  uint32_t delivered = arq->delivered;
+  while( arq->held && delivered == arq->delivered )
+    if( -1 == arq_advance( arq, 1, with_rssi, out, length, size ) )
+      return -1;
+  arq->gap = now;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+arq_segment( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  e22900t22s_arq_t * arq = (e22900t22s_arq_t *) stage;
+  if( len && E22900T22S_ARQ_ACK == body[0] ){
+    arq_ack( arq, body, len, arq->now );
+    return 0;
+  }
+  if( len >= E22900T22S_ARQ_HEADER && E22900T22S_ARQ_PLAIN == body[0] && E22900T22S_ARQ_PLAIN == body[1] )
+    return e22900t22s_segment_emit( &body[ E22900T22S_ARQ_HEADER ], len - E22900T22S_ARQ_HEADER, rssi, with_rssi, out, length, size );
+  // Anything else without sequence number, as the frames of the rate controller, goes up as it is
+  if( len < E22900T22S_ARQ_HEADER || 0x80 != ( body[0] & 0xC0 ) || !( body[1] & 0x80 ) )
+    return e22900t22s_segment_emit( body, len, rssi, with_rssi, out, length, size );
+
+  uint16_t seq = (uint16_t) ( ( body[0] & 0x3F ) << 7 | ( body[1] & 0x7F ) );
+  uint16_t d = arq_distance( seq, arq->expected );
+  arq->pending = 1;
+  if( d >= E22900T22S_ARQ_SEQUENCES / 2 ){
+    arq->duplicates++;
+    return 0;
+  }
+
+  // A segment past the window means the sender gave up the ones the window still waits for
+  while( d >= E22900T22S_ARQ_WINDOW ){
+    if( -1 == arq_advance( arq, 1, with_rssi, out, length, size ) )
+      return -1;
+    d = arq_distance( seq, arq->expected );
+  }
+
+  if( !d ){
+    if( -1 == e22900t22s_segment_emit( &body[ E22900T22S_ARQ_HEADER ], len - E22900T22S_ARQ_HEADER, rssi, with_rssi, out, length, size ) )
+      return -1;
+    arq->delivered++;
+    if( -1 == arq_advance( arq, 0, with_rssi, out, length, size ) )
+      return -1;
+    if( arq->held )
+      arq->gap = arq->now;
+  }
+  else if( arq->held >> d & 1u )
+    arq->duplicates++;
+  else{
+    uint8_t s = ARQ_SLOT( seq );
+    memcpy( arq->held_data[s], &body[ E22900T22S_ARQ_HEADER ], len - E22900T22S_ARQ_HEADER );
+    arq->held_length[s] = (uint16_t) ( len - E22900T22S_ARQ_HEADER );
+    arq->held_rssi[s] = rssi;
+    if( !arq->held )
+      arq->gap = arq->now;
+    arq->held |= 1ULL << d;
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_arq_unpack( e22900t22s_arq_t * arq, const uint8_t * data, const size_t len, const uint8_t rssi, const uint64_t now, uint8_t * out, const size_t size ){
+  if( !arq || !data || !out ){
+    errno = EINVAL;
+    return 0;
+  }
+
+  e22900t22s_shared_mutex_lock( &arq->lock );
+  arq->now = now;
+
+  // The segments the loop process let go are older than anything received now
+  size_t length = arq->released_length;
+  if( length > size ){
+    pthread_mutex_unlock( &arq->lock );
+    errno = ENOBUFS;
+    return 0;
+  }
+  memcpy( out, arq->released, length );
+  arq->released_length = 0;
+
+  // The segment is only handled with its RSSI byte, it might be handed over much later
+  errno = 0;
+  size_t walked = e22900t22s_segment_walk( &arq->reader, data, len, rssi, NULL, arq_segment, arq, &out[ length ], size - length );
+  int8_t ret = !walked && errno ? -1 : 0;
+  length += walked;
+
+  // The loop process gives the gaps up on its tick, a read past the hold does not wait for it
+  if( -1 != ret )
+    ret = arq_expire( arq, now, rssi, out, &length, size );
+  pthread_mutex_unlock( &arq->lock );
+  return -1 == ret ? 0 : length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t
+e22900t22s_arq_expire( e22900t22s_arq_t * arq, const uint8_t rssi, const uint64_t now ){
+  uint32_t released = 0;
+  e22900t22s_shared_mutex_lock( &arq->lock );
+  if( !arq->released_length ){
+    uint32_t delivered = arq->delivered;
+    // The buffer holds a full window, the most a gap can let go
+    if( -1 != arq_expire( arq, now, rssi, arq->released, &arq->released_length, sizeof(arq->released) ) )
+      released = arq->delivered - delivered;
+  }
+  pthread_mutex_unlock( &arq->lock );
+  return released;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_arq_bound( const e22900t22s_arq_t * arq, const size_t len ){
+  // The segments waiting in the window come out with the received bytes, after the ones the loop process let go
+  return len + arq->reader.length + E22900T22S_ARQ_WINDOW * ( E22900T22S_ARQ_SEGMENT + 3 ) + sizeof(arq->released);
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
@@ -0,0 +1,328 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s_codec.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/codec.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define CODEC_HASH( w )    ( ( ( (uint32_t) (w)[0] << 16 | (uint32_t) (w)[1] << 8 | (uint32_t) (w)[2] ) * 2654435761U ) >> ( 32 - E22900T22S_CODEC_HASH_BITS ) )
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+uint64_t codec_cpu( void );
+size_t codec_lz( e22900t22s_codec_t * codec, const uint8_t * body, const size_t len, uint8_t * out );
+int8_t codec_unpacked( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+int8_t codec_packed( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t
+codec_cpu( void ){
+  struct timespec now;
+  clock_gettime( CLOCK_THREAD_CPUTIME_ID, &now );
+  return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_codec_init( e22900t22s_codec_t * codec ){
+  memset( codec, 0, sizeof(e22900t22s_codec_t) );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_codec_dictionary( e22900t22s_codec_t * codec, const char * filename ){
+  if( !codec || !filename ){
+    errno = EINVAL;
+    return -1;
+  }
+
+  FILE * file = fopen( filename, "rb" );
+  if( !file ){
+    perror("fopen");
+    return -1;
+  }
+  // The end of the dictionary is the closest to the segment, the shortest distances
+  long length = -1;
+  if( 0 == fseek( file, 0, SEEK_END ) )
+    length = ftell( file );
+  if( length > E22900T22S_CODEC_DICTIONARY )
+    fseek( file, length - E22900T22S_CODEC_DICTIONARY, SEEK_SET );
+  else
+    rewind( file );
+  size_t read = length > 0 ? fread( codec->window, 1, E22900T22S_CODEC_DICTIONARY, file ) : 0;
+  fclose( file );
+  if( -1 == length ){
+    perror("ftell");
+    return -1;
+  }
+
+  codec->dictionary = (uint16_t) read;
+  memset( codec->head, 0, sizeof(codec->head) );
+  for( uint16_t p = 0 ; p + 2 < codec->dictionary ; ++p ){
+    uint32_t h = CODEC_HASH( &codec->window[ p ] );
+    codec->prev[ p ] = codec->head[ h ];
+    codec->head[ h ] = (uint16_t) ( p + 1 );
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+codec_lz( e22900t22s_codec_t * codec, const uint8_t * body, const size_t len, uint8_t * out ){
+  // The dictionary chains are copied, the segment positions are added on top of them
+  uint16_t head[ 1 << E22900T22S_CODEC_HASH_BITS ];
+  uint16_t prev[ E22900T22S_CODEC_DICTIONARY + E22900T22S_CODEC_SEGMENT ];
+  memcpy( head, codec->head, sizeof(head) );
+  memcpy( prev, codec->prev, codec->dictionary * sizeof(uint16_t) );
+
+  uint8_t * window = codec->window;
+  size_t start = codec->dictionary;
+  size_t end = start + len;
+  memcpy( &window[ start ], body, len );
+
+  size_t length = 0;
+  out[ length++ ] = codec->dictionary ? E22900T22S_CODEC_DICT : E22900T22S_CODEC_LZ;
+
+  size_t p = start;
+  while( p < end ){
+    size_t best = 0, distance = 0;
+    if( p + E22900T22S_CODEC_MIN_MATCH <= end ){
+      size_t limit = end - p < E22900T22S_CODEC_MAX_MATCH ? end - p : E22900T22S_CODEC_MAX_MATCH;
+      uint16_t candidate = head[ CODEC_HASH( &window[ p ] ) ];
+      for( uint8_t depth = 0 ; candidate && depth < E22900T22S_CODEC_DEPTH ; ++depth ){
+        size_t c = (size_t) candidate - 1;
+        size_t match = 0;
+        while( match < limit && window[ c + match ] == window[ p + match ] )
+          ++match;
+        if( match > best ){
+          best = match;
+          distance = p - c;
+          if( match == limit )
+            break;
+        }
+        candidate = prev[ c ];
+      }
+    }
+
+    size_t step = best >= E22900T22S_CODEC_MIN_MATCH ? best : 1;
+    for( size_t k = 0 ; k < step && p + k + 2 < end ; ++k ){
+      uint32_t h = CODEC_HASH( &window[ p + k ] );
+      prev[ p + k ] = head[ h ];
+      head[ h ] = (uint16_t) ( p + k + 1 );
+    }
+
+    // Every byte written is kept away from 0x00, the literals are segment bytes and the match fields are offset by 1
+    if( best >= E22900T22S_CODEC_MIN_MATCH ){
+      if( length + 4 >= len + E22900T22S_CODEC_HEADER )
+        return 0;
+      out[ length++ ] = E22900T22S_CODEC_ESCAPE;
+      out[ length++ ] = (uint8_t) ( best - 3 );
+      out[ length++ ] = (uint8_t) ( ( distance >> 7 ) + 1 );
+      out[ length++ ] = (uint8_t) ( ( distance & 0x7F ) + 1 );
+    }
+    else if( E22900T22S_CODEC_ESCAPE == window[ p ] ){
+      if( length + 2 >= len + E22900T22S_CODEC_HEADER )
+        return 0;
+      out[ length++ ] = E22900T22S_CODEC_ESCAPE;
+      out[ length++ ] = 0x01;
+    }
+    else{
+      if( length + 1 >= len + E22900T22S_CODEC_HEADER )
+        return 0;
+      out[ length++ ] = window[ p ];
+    }
+    p += step;
+  }
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_codec_compress( e22900t22s_codec_t * codec, const uint8_t * body, const size_t len, uint8_t * out ){
+  uint64_t cpu = codec_cpu( );
+
+  // A 0x00 in the body would come out as a limiter, the segment is not what the coder expects
+  size_t length = 0;
+  if( len >= E22900T22S_CODEC_MIN_MATCH && len <= E22900T22S_CODEC_SEGMENT && !memchr( body, 0x00, len ) )
+    length = codec_lz( codec, body, len, out );
+  if( !length ){
+    out[ 0 ] = E22900T22S_CODEC_RAW;
+    memcpy( &out[ 1 ], body, len );
+    length = len + E22900T22S_CODEC_HEADER;
+    codec->stored++;
+  }
+
+  codec->segments++;
+  codec->raw += len;
+  codec->coded += length;
+  codec->cpu_ns += codec_cpu( ) - cpu;
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+e22900t22s_codec_expand( const e22900t22s_codec_t * codec, const uint8_t * body, const size_t len, uint8_t * out, const size_t size ){
+  if( !len )
+    return -1;
+
+  switch( body[ 0 ] ){
+    case E22900T22S_CODEC_RAW:
+      if( len - 1 > size )
+        return -1;
+      memcpy( out, &body[ 1 ], len - 1 );
+      return (int) ( len - 1 );
+    case E22900T22S_CODEC_DICT:
+      if( !codec->dictionary )
+        return -1;
+      break;
+    case E22900T22S_CODEC_LZ:
+      break;
+    default:
+      return -1;
+  }
+
+  // The matches reach back into the dictionary, so it is placed in front of the output
+  uint8_t window[ E22900T22S_CODEC_DICTIONARY + E22900T22S_CODEC_SEGMENT ];
+  size_t start = E22900T22S_CODEC_DICT == body[ 0 ] ? codec->dictionary : 0;
+  size_t end = start + ( size < E22900T22S_CODEC_SEGMENT ? size : E22900T22S_CODEC_SEGMENT );
+  memcpy( window, codec->window, start );
+
+  size_t p = start;
+  for( size_t i = 1 ; i < len ; ){
+    if( E22900T22S_CODEC_ESCAPE != body[ i ] ){
+      if( p >= end )
+        return -1;
+      window[ p++ ] = body[ i++ ];
+      continue;
+    }
+    if( i + 1 < len && 0x01 == body[ i + 1 ] ){
+      if( p >= end )
+        return -1;
+      window[ p++ ] = E22900T22S_CODEC_ESCAPE;
+      i += 2;
+      continue;
+    }
+    if( i + 3 >= len )
+      return -1;
+    size_t match = (size_t) body[ i + 1 ] + 3;
+    size_t distance = ( (size_t) ( body[ i + 2 ] - 1 ) << 7 ) | (size_t) ( body[ i + 3 ] - 1 );
+    if( !distance || distance > p || p + match > end )
+      return -1;
+    // Byte by byte, a match can overlap the bytes it produces
+    for( size_t k = 0 ; k < match ; ++k, ++p )
+      window[ p ] = window[ p - distance ];
+    i += 4;
+  }
+
+  memcpy( out, &window[ start ], p - start );
+  return (int) ( p - start );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+codec_packed( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  (void) rssi;
+  (void) with_rssi;
+  if( *length + len + E22900T22S_CODEC_HEADER + 2 > size ){
+    errno = ENOBUFS;
+    return -1;
+  }
+  out[ (*length)++ ] = 0x00;
+  *length += e22900t22s_codec_compress( (e22900t22s_codec_t *) stage, body, len, &out[ *length ] );
+  out[ (*length)++ ] = 0x00;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_codec_pack( e22900t22s_codec_t * codec, const uint8_t * data, const size_t len, uint8_t * out, const size_t size ){
+  if( !codec || !data || !out ){
+    errno = EINVAL;
+    return 0;
+  }
+  // A segment still open at the end of `data` waits for the write that closes it, it is coded whole
+  return e22900t22s_segment_walk( &codec->writer, data, len, 0, NULL, codec_packed, codec, out, size );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_codec_bound( const e22900t22s_codec_t * codec, const size_t len ){
+  // A segment takes at least 4 bytes, the limiters, the codec byte and one more
+  size_t total = len + codec->reader.length;
+  return total + ( total / 4 + 1 ) * ( E22900T22S_CODEC_SEGMENT + 2 );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+codec_unpacked( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  e22900t22s_codec_t * codec = (e22900t22s_codec_t *) stage;
+  if( *length + E22900T22S_CODEC_SEGMENT + 3 > size ){
+    errno = ENOBUFS;
+    return -1;
+  }
+  // The body expands right after its SOF, a segment that does not expand is dropped with its RSSI byte
+  int expanded = e22900t22s_codec_expand( codec, body, len, &out[ *length + 1 ], E22900T22S_CODEC_SEGMENT );
+  if( -1 == expanded ){
+    codec->errors++;
+    return 0;
+  }
+  out[ *length ] = 0x00;
+  *length += (size_t) expanded + 1;
+  out[ (*length)++ ] = 0x00;
+  if( with_rssi )
+    out[ (*length)++ ] = rssi;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_codec_unpack( e22900t22s_codec_t * codec, const uint8_t * data, const size_t len, const uint8_t rssi, uint8_t * out, const size_t size ){
+  if( !codec || !data || !out ){
+    errno = EINVAL;
+    return 0;
+  }
+  uint64_t cpu = codec_cpu( );
+  size_t length = e22900t22s_segment_walk( &codec->reader, data, len, rssi, NULL, codec_unpacked, codec, out, size );
+  codec->cpu_ns += codec_cpu( ) - cpu;
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
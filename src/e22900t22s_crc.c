@@ -0,0 +1,267 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s_crc.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/crc.h>
+#include <errno.h>
+#include <string.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__linux__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define CRC32C_POLY    0x82F63B78U          // Castagnoli polynomial, reflected
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+void crc_encode( const uint32_t crc, uint8_t * trailer );
+int8_t crc_decode( const uint8_t * trailer, uint32_t * crc );
+int8_t crc_check( void * stage, const uint8_t * body, const size_t len );
+int8_t crc_sealed( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+int8_t crc_passed( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+void crc_setup( void );
+uint32_t crc_sliced( uint32_t crc, const uint8_t * data, const size_t len );
+#if defined(__x86_64__) || defined(__i386__)
+uint32_t crc_sse42( uint32_t crc, const uint8_t * data, const size_t len );
+#elif ( defined(__aarch64__) && defined(__linux__) ) || defined(__ARM_FEATURE_CRC32)
+uint32_t crc_armv8( uint32_t crc, const uint8_t * data, const size_t len );
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+static uint32_t crc_table[8][256];                   // Slicing-by-8, `crc_table[k]` advances a byte k positions further
+static pthread_once_t crc_once = PTHREAD_ONCE_INIT;
+static uint32_t ( * crc_run )( uint32_t, const uint8_t *, const size_t ) = crc_sliced;  // Picked once by `crc_setup`, for the CPU the driver runs on
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+crc_setup( void ){
+  for( uint32_t i = 0 ; i < 256 ; ++i ){
+    uint32_t crc = i;
+    for( uint8_t bit = 0 ; bit < 8 ; ++bit )
+      crc = crc & 1 ? ( crc >> 1 ) ^ CRC32C_POLY : crc >> 1;
+    crc_table[0][i] = crc;
+  }
+  for( uint32_t i = 0 ; i < 256 ; ++i )
+    for( uint8_t k = 1 ; k < 8 ; ++k )
+      crc_table[k][i] = ( crc_table[k - 1][i] >> 8 ) ^ crc_table[0][ crc_table[k - 1][i] & 0xFF ];
+
+  // The instructions are checked on the CPU itself, the same build runs on machines with and without them
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init( );
+  if( __builtin_cpu_supports("sse4.2") )
+    crc_run = crc_sse42;
+#elif defined(__aarch64__) && defined(__linux__)
+  if( getauxval( AT_HWCAP ) & HWCAP_CRC32 )
+    crc_run = crc_armv8;
+#elif defined(__ARM_FEATURE_CRC32)
+  crc_run = crc_armv8;
+#endif
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t
+crc_sliced( uint32_t crc, const uint8_t * data, const size_t len ){
+  size_t i = 0;
+  for( ; i + 8 <= len ; i += 8 ){
+    // The bytes are combined one by one, so the tables work on any byte order
+    uint32_t low = crc ^ ( (uint32_t) data[i] | (uint32_t) data[i + 1] << 8 | (uint32_t) data[i + 2] << 16 | (uint32_t) data[i + 3] << 24 );
+    crc = crc_table[7][ low & 0xFF ] ^ crc_table[6][ ( low >> 8 ) & 0xFF ] ^ crc_table[5][ ( low >> 16 ) & 0xFF ] ^ crc_table[4][ low >> 24 ] ^
+          crc_table[3][ data[i + 4] ] ^ crc_table[2][ data[i + 5] ] ^ crc_table[1][ data[i + 6] ] ^ crc_table[0][ data[i + 7] ];
+  }
+  for( ; i < len ; ++i )
+    crc = ( crc >> 8 ) ^ crc_table[0][ ( crc ^ data[i] ) & 0xFF ];
+  return crc;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+__attribute__((target("sse4.2")))
+uint32_t
+crc_sse42( uint32_t crc, const uint8_t * data, const size_t len ){
+  size_t i = 0;
+#if defined(__x86_64__)
+  uint64_t wide = crc;
+  for( ; i + 8 <= len ; i += 8 ){
+    uint64_t word;
+    memcpy( &word, &data[i], sizeof(word) );
+    wide = _mm_crc32_u64( wide, word );
+  }
+  crc = (uint32_t) wide;
+#else
+  for( ; i + 4 <= len ; i += 4 ){
+    uint32_t word;
+    memcpy( &word, &data[i], sizeof(word) );
+    crc = _mm_crc32_u32( crc, word );
+  }
+#endif
+  for( ; i < len ; ++i )
+    crc = _mm_crc32_u8( crc, data[i] );
+  return crc;
+}
+#elif ( defined(__aarch64__) && defined(__linux__) ) || defined(__ARM_FEATURE_CRC32)
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+#if !defined(__ARM_FEATURE_CRC32)
+__attribute__((target("+crc")))
+#endif
+uint32_t
+crc_armv8( uint32_t crc, const uint8_t * data, const size_t len ){
+  size_t i = 0;
+  for( ; i + 8 <= len ; i += 8 ){
+    uint64_t word;
+    memcpy( &word, &data[i], sizeof(word) );
+    crc = __crc32cd( crc, word );
+  }
+  for( ; i < len ; ++i )
+    crc = __crc32cb( crc, data[i] );
+  return crc;
+}
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t
+e22900t22s_crc32c( const uint8_t * data, const size_t len ){
+  pthread_once( &crc_once, crc_setup );
+  return ~crc_run( 0xFFFFFFFFU, data, len );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t
+e22900t22s_crc32c_sliced( const uint8_t * data, const size_t len ){
+  pthread_once( &crc_once, crc_setup );
+  return ~crc_sliced( 0xFFFFFFFFU, data, len );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+crc_encode( const uint32_t crc, uint8_t * trailer ){
+  for( uint8_t k = 0 ; k < E22900T22S_CRC_TRAILER ; ++k )
+    trailer[k] = (uint8_t) ( 0x80 | ( ( crc >> ( 7 * k ) ) & 0x7F ) );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+crc_decode( const uint8_t * trailer, uint32_t * crc ){
+  *crc = 0;
+  for( uint8_t k = 0 ; k < E22900T22S_CRC_TRAILER ; ++k ){
+    if( !( trailer[k] & 0x80 ) )
+      return -1;
+    *crc |= (uint32_t) ( trailer[k] & 0x7F ) << ( 7 * k );
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+crc_check( void * stage, const uint8_t * body, const size_t len ){
+  e22900t22s_crc_state_t * state = (e22900t22s_crc_state_t *) stage;
+  uint32_t crc;
+  if( len >= E22900T22S_CRC_TRAILER && -1 != crc_decode( &body[ len - E22900T22S_CRC_TRAILER ], &crc ) &&
+      crc == e22900t22s_crc32c( body, len - E22900T22S_CRC_TRAILER ) )
+    return 0;
+
+  // Anything shorter than a trailer is the RSSI byte between two segments, met again while looking for the next SOF
+  if( len >= E22900T22S_CRC_TRAILER )
+    state->dropped++;
+  return E22900T22S_SEGMENT_RESYNC;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+crc_sealed( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  (void) stage;
+  (void) rssi;
+  (void) with_rssi;
+  if( *length + len + E22900T22S_CRC_TRAILER + 2 > size ){
+    errno = ENOBUFS;
+    return -1;
+  }
+  out[ (*length)++ ] = 0x00;
+  memcpy( &out[ *length ], body, len );
+  *length += len;
+  crc_encode( e22900t22s_crc32c( body, len ), &out[ *length ] );
+  *length += E22900T22S_CRC_TRAILER;
+  out[ (*length)++ ] = 0x00;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+crc_passed( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  e22900t22s_crc_state_t * state = (e22900t22s_crc_state_t *) stage;
+  state->passed++;
+  return e22900t22s_segment_emit( body, len - E22900T22S_CRC_TRAILER, rssi, with_rssi, out, length, size );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_crc_seal( e22900t22s_crc_state_t * state, const uint8_t * data, const size_t len, uint8_t * out, const size_t size ){
+  if( !state || !data || !out ){
+    errno = EINVAL;
+    return 0;
+  }
+  // A segment still open at the end of `data` waits for the write that closes it, its trailer needs the whole body
+  return e22900t22s_segment_walk( &state->writer, data, len, 0, NULL, crc_sealed, state, out, size );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_crc_verify( e22900t22s_crc_state_t * state, const uint8_t * data, const size_t len, const uint8_t rssi, uint8_t * out, const size_t size ){
+  if( !state || !data || !out ){
+    errno = EINVAL;
+    return 0;
+  }
+  return e22900t22s_segment_walk( &state->reader, data, len, rssi, crc_check, crc_passed, state, out, size );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_crc_bound( const e22900t22s_crc_state_t * state, const size_t len ){
+  // Every segment takes at least its two limiters, the ones held from the previous buffers come out with this one
+  size_t total = len + state->writer.length + state->reader.length;
+  return total + ( total / 2 + 2 ) * ( E22900T22S_CRC_TRAILER + 3 );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
@@ -0,0 +1,527 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s_fec.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/fec.h>
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define FEC_POLY    0x11D                   // x^8 + x^4 + x^3 + x^2 + 1, 2 generates the field
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+void fec_tables( void );
+uint8_t fec_mul( const uint8_t a, const uint8_t b );
+uint8_t fec_inv( const uint8_t a );
+void fec_nibbles( const uint8_t c, uint8_t * low, uint8_t * high );
+#if defined(__x86_64__) || defined(__i386__)
+size_t fec_ssse3( uint8_t * dst, const uint8_t * src, const uint8_t * low, const uint8_t * high, const size_t len );
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+size_t fec_neon( uint8_t * dst, const uint8_t * src, const uint8_t * low, const uint8_t * high, const size_t len );
+#endif
+int8_t fec_close( e22900t22s_fec_t * fec, uint8_t * out, size_t * length, const size_t size );
+int8_t fec_source( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+int8_t fec_outside( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+void fec_recover( e22900t22s_fec_t * fec );
+int8_t fec_release( e22900t22s_fec_t * fec, const uint8_t finish, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+int8_t fec_segment( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+static uint8_t fec_exp[ 512 ];                      // Powers of 2, twice over so a sum of two logarithms needs no modulo
+static uint8_t fec_log[ 256 ];
+static uint8_t fec_cauchy[ E22900T22S_FEC_REPAIRS ][ E22900T22S_FEC_SOURCES ];  // Coefficient of every source in every repair
+static pthread_once_t fec_once = PTHREAD_ONCE_INIT;
+static size_t ( * fec_wide )( uint8_t *, const uint8_t *, const uint8_t *, const uint8_t *, const size_t ) = NULL;  // Picked once by `fec_tables`, for the CPU the driver runs on, NULL without vector instructions
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+fec_tables( void ){
+  uint16_t x = 1;
+  for( uint16_t i = 0 ; i < 255 ; ++i ){
+    fec_exp[ i ] = fec_exp[ i + 255 ] = (uint8_t) x;
+    fec_log[ x ] = (uint8_t) i;
+    x = (uint16_t) ( x << 1 );
+    if( x & 0x100 )
+      x ^= FEC_POLY;
+  }
+  // 1 / (x_j + y_i), with x_j above every source index, every square part of the matrix can be inverted
+  for( uint8_t j = 0 ; j < E22900T22S_FEC_REPAIRS ; ++j )
+    for( uint8_t i = 0 ; i < E22900T22S_FEC_SOURCES ; ++i )
+      fec_cauchy[ j ][ i ] = fec_inv( (uint8_t) ( ( E22900T22S_FEC_SOURCES + j ) ^ i ) );
+
+  // SSSE3 is checked on the CPU itself, the same build runs on machines with and without it, AArch64 always has NEON
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init( );
+  if( __builtin_cpu_supports("ssse3") )
+    fec_wide = fec_ssse3;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  fec_wide = fec_neon;
+#endif
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t
+fec_mul( const uint8_t a, const uint8_t b ){
+  return a && b ? fec_exp[ fec_log[ a ] + fec_log[ b ] ] : 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t
+fec_inv( const uint8_t a ){
+  return fec_exp[ 255 - fec_log[ a ] ];
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+fec_nibbles( const uint8_t c, uint8_t * low, uint8_t * high ){
+  // c * x = c * (x & 0x0F) + c * (x & 0xF0), two lookups of 16 entries, the width of a byte shuffle
+  for( uint8_t x = 0 ; x < 16 ; ++x ){
+    low[ x ] = fec_mul( c, x );
+    high[ x ] = fec_mul( c, (uint8_t) ( x << 4 ) );
+  }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+__attribute__((target("ssse3")))
+size_t
+fec_ssse3( uint8_t * dst, const uint8_t * src, const uint8_t * low, const uint8_t * high, const size_t len ){
+  const __m128i tlow = _mm_loadu_si128( (const __m128i *) low );
+  const __m128i thigh = _mm_loadu_si128( (const __m128i *) high );
+  const __m128i mask = _mm_set1_epi8( 0x0F );
+  size_t i = 0;
+  for( ; i + 16 <= len ; i += 16 ){
+    __m128i s = _mm_loadu_si128( (const __m128i *) &src[i] );
+    __m128i p = _mm_xor_si128( _mm_shuffle_epi8( tlow, _mm_and_si128( s, mask ) ), _mm_shuffle_epi8( thigh, _mm_and_si128( _mm_srli_epi64( s, 4 ), mask ) ) );
+    _mm_storeu_si128( (__m128i *) &dst[i], _mm_xor_si128( _mm_loadu_si128( (const __m128i *) &dst[i] ), p ) );
+  }
+  return i;
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+fec_neon( uint8_t * dst, const uint8_t * src, const uint8_t * low, const uint8_t * high, const size_t len ){
+  const uint8x16_t tlow = vld1q_u8( low );
+  const uint8x16_t thigh = vld1q_u8( high );
+  const uint8x16_t mask = vdupq_n_u8( 0x0F );
+  size_t i = 0;
+  for( ; i + 16 <= len ; i += 16 ){
+    uint8x16_t s = vld1q_u8( &src[i] );
+    uint8x16_t p = veorq_u8( vqtbl1q_u8( tlow, vandq_u8( s, mask ) ), vqtbl1q_u8( thigh, vshrq_n_u8( s, 4 ) ) );
+    vst1q_u8( &dst[i], veorq_u8( vld1q_u8( &dst[i] ), p ) );
+  }
+  return i;
+}
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_fec_mul_add( uint8_t * dst, const uint8_t * src, const uint8_t c, const size_t len ){
+  if( !c )
+    return;
+  pthread_once( &fec_once, fec_tables );
+
+  uint8_t low[16], high[16];
+  fec_nibbles( c, low, high );
+  for( size_t i = fec_wide ? fec_wide( dst, src, low, high, len ) : 0 ; i < len ; ++i )
+    dst[i] ^= low[ src[i] & 0x0F ] ^ high[ src[i] >> 4 ];
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_fec_mul_add_narrow( uint8_t * dst, const uint8_t * src, const uint8_t c, const size_t len ){
+  pthread_once( &fec_once, fec_tables );
+
+  uint8_t low[16], high[16];
+  fec_nibbles( c, low, high );
+  for( size_t i = 0 ; i < len ; ++i )
+    dst[i] ^= low[ src[i] & 0x0F ] ^ high[ src[i] >> 4 ];
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_fec_init( e22900t22s_fec_t * fec, const uint8_t block, const uint8_t repairs ){
+  if( !fec || !block || block > E22900T22S_FEC_SOURCES || !repairs || repairs > E22900T22S_FEC_REPAIRS ){
+    errno = EINVAL;
+    return -1;
+  }
+  pthread_once( &fec_once, fec_tables );
+  memset( fec, 0, sizeof(e22900t22s_fec_t) );
+  fec->block = block;
+  fec->repairs = repairs;
+  fec->encoder.block = 1;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_fec_tune( e22900t22s_fec_t * fec, const e22900t22s_eeprom_t * cfg ){
+  size_t block = ( (size_t) fec->block + fec->repairs ) * ( E22900T22S_FEC_SYMBOL + E22900T22S_FEC_HEADER + 2 );
+  fec->hold = 2 * e22900t22s_airtime( cfg, block, NULL ) * 1000;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+fec_close( e22900t22s_fec_t * fec, uint8_t * out, size_t * length, const size_t size ){
+  e22900t22s_fec_encoder_t * encoder = &fec->encoder;
+  if( !encoder->sources )
+    return 0;
+
+  // A short block keeps the share of repairs of a full one, so every segment is as protected
+  uint8_t repairs = (uint8_t) ( ( fec->repairs * encoder->sources + fec->block - 1 ) / fec->block );
+  size_t symbol = (size_t) encoder->longest + 1;
+  for( uint8_t j = 0 ; j < repairs ; ++j ){
+    if( *length + symbol + E22900T22S_FEC_HEADER + 2 > size ){
+      errno = ENOBUFS;
+      return -1;
+    }
+    uint8_t repair[ E22900T22S_FEC_SYMBOL ];
+    memset( repair, 0, symbol );
+    for( uint8_t i = 0 ; i < encoder->sources ; ++i )
+      e22900t22s_fec_mul_add( repair, encoder->symbol[i], fec_cauchy[j][i], symbol );
+
+    out[ (*length)++ ] = 0x00;
+    out[ (*length)++ ] = encoder->block;
+    out[ (*length)++ ] = (uint8_t) ( E22900T22S_FEC_REPAIR | ( j + 1 ) );
+    out[ (*length)++ ] = encoder->sources;
+    *length += e22900t22s_segment_stuff( repair, symbol, &out[ *length ] );
+    out[ (*length)++ ] = 0x00;
+    fec->repaired++;
+  }
+
+  encoder->block = (uint8_t) ( 255 == encoder->block ? 1 : encoder->block + 1 );
+  encoder->sources = 0;
+  encoder->longest = 0;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+fec_source( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  (void) rssi;
+  (void) with_rssi;
+  e22900t22s_fec_t * fec = (e22900t22s_fec_t *) stage;
+  e22900t22s_fec_encoder_t * encoder = &fec->encoder;
+  if( len >= E22900T22S_FEC_SYMBOL ){
+    errno = EMSGSIZE;
+    return -1;
+  }
+  if( *length + len + 4 > size ){
+    errno = ENOBUFS;
+    return -1;
+  }
+  out[ (*length)++ ] = 0x00;
+  out[ (*length)++ ] = encoder->block;
+  out[ (*length)++ ] = (uint8_t) ( encoder->sources + 1 );
+  memcpy( &out[ *length ], body, len );
+  *length += len;
+  out[ (*length)++ ] = 0x00;
+
+  uint8_t * symbol = encoder->symbol[ encoder->sources++ ];
+  symbol[0] = (uint8_t) len;
+  memcpy( &symbol[1], body, len );
+  memset( &symbol[ 1 + len ], 0, E22900T22S_FEC_SYMBOL - 1 - len );
+  if( len > encoder->longest )
+    encoder->longest = (uint8_t) len;
+  fec->sources++;
+  if( encoder->sources == fec->block )
+    return fec_close( fec, out, length, size );
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_fec_pack( e22900t22s_fec_t * fec, const uint8_t * data, const size_t len, const uint8_t flush, uint8_t * out, const size_t size ){
+  if( !fec || !data || !out ){
+    errno = EINVAL;
+    return 0;
+  }
+
+  // A segment still open at the end of `data` waits for the write that closes it, a source is coded whole
+  errno = 0;
+  size_t length = e22900t22s_segment_walk( &fec->encoder.walker, data, len, 0, NULL, fec_source, fec, out, size );
+  if( !length && errno )
+    return 0;
+  if( flush && -1 == fec_close( fec, out, &length, size ) )
+    return 0;
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+fec_outside( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  (void) stage;
+  (void) rssi;
+  (void) with_rssi;
+  if( *length + len + 4 > size ){
+    errno = ENOBUFS;
+    return -1;
+  }
+  // The block byte is only there to keep the layout of the other segments
+  out[ (*length)++ ] = 0x00;
+  out[ (*length)++ ] = E22900T22S_FEC_PLAIN;
+  out[ (*length)++ ] = E22900T22S_FEC_PLAIN;
+  memcpy( &out[ *length ], body, len );
+  *length += len;
+  out[ (*length)++ ] = 0x00;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_fec_plain( e22900t22s_fec_t * fec, const uint8_t * data, const size_t len, uint8_t * out, const size_t size ){
+  if( !fec || !data || !out ){
+    errno = EINVAL;
+    return 0;
+  }
+  return e22900t22s_segment_walk( &fec->encoder.plain, data, len, 0, NULL, fec_outside, fec, out, size );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_fec_pack_bound( const e22900t22s_fec_t * fec, const size_t len ){
+  // Every segment takes at least its two limiters, each one may close a block, the open block adds its sources
+  size_t segments = len / 2 + 1 + fec->encoder.sources;
+  size_t held = (size_t) fec->encoder.walker.length + 2;
+  size_t blocks = segments / fec->block + 1;
+  return len + held + segments * 2 + blocks * fec->repairs * ( E22900T22S_FEC_SYMBOL + E22900T22S_FEC_HEADER + 2 );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+fec_recover( e22900t22s_fec_t * fec ){
+  e22900t22s_fec_decoder_t * decoder = &fec->decoder;
+  if( !decoder->sources )
+    return;
+
+  uint8_t missing[ E22900T22S_FEC_REPAIRS ], rows[ E22900T22S_FEC_REPAIRS ];
+  uint8_t lost = 0, found = 0;
+  for( uint8_t i = 0 ; i < decoder->sources ; ++i )
+    if( !( decoder->have >> i & 1u ) ){
+      if( lost == E22900T22S_FEC_REPAIRS )
+        return;
+      missing[ lost++ ] = i;
+    }
+  for( uint8_t j = 0 ; j < E22900T22S_FEC_REPAIRS && found < lost ; ++j )
+    if( decoder->repaired >> j & 1u )
+      rows[ found++ ] = j;
+  if( !lost || found < lost )
+    return;
+
+  // The sources received are taken out of the repairs, what is left is the lost sources times a square Cauchy matrix
+  size_t symbol = decoder->length;
+  for( uint8_t r = 0 ; r < lost ; ++r )
+    for( uint8_t i = 0 ; i < decoder->sources ; ++i )
+      if( decoder->have >> i & 1u )
+        e22900t22s_fec_mul_add( decoder->repair[ rows[r] ], decoder->symbol[i], fec_cauchy[ rows[r] ][i], symbol );
+
+  uint8_t matrix[ E22900T22S_FEC_REPAIRS ][ E22900T22S_FEC_REPAIRS ], inverse[ E22900T22S_FEC_REPAIRS ][ E22900T22S_FEC_REPAIRS ];
+  memset( inverse, 0, sizeof(inverse) );
+  for( uint8_t r = 0 ; r < lost ; ++r ){
+    for( uint8_t m = 0 ; m < lost ; ++m )
+      matrix[r][m] = fec_cauchy[ rows[r] ][ missing[m] ];
+    inverse[r][r] = 1;
+  }
+  // Gauss-Jordan, a Cauchy matrix always has a pivot
+  for( uint8_t c = 0 ; c < lost ; ++c ){
+    uint8_t pivot = c;
+    while( pivot < lost && !matrix[ pivot ][c] )
+      ++pivot;
+    if( pivot == lost )
+      return;
+    for( uint8_t m = 0 ; m < lost ; ++m ){
+      uint8_t t = matrix[c][m]; matrix[c][m] = matrix[ pivot ][m]; matrix[ pivot ][m] = t;
+      t = inverse[c][m]; inverse[c][m] = inverse[ pivot ][m]; inverse[ pivot ][m] = t;
+    }
+    uint8_t scale = fec_inv( matrix[c][c] );
+    for( uint8_t m = 0 ; m < lost ; ++m ){
+      matrix[c][m] = fec_mul( matrix[c][m], scale );
+      inverse[c][m] = fec_mul( inverse[c][m], scale );
+    }
+    for( uint8_t r = 0 ; r < lost ; ++r ){
+      uint8_t factor = matrix[r][c];
+      if( r == c || !factor )
+        continue;
+      for( uint8_t m = 0 ; m < lost ; ++m ){
+        matrix[r][m] ^= fec_mul( factor, matrix[c][m] );
+        inverse[r][m] ^= fec_mul( factor, inverse[c][m] );
+      }
+    }
+  }
+
+  for( uint8_t m = 0 ; m < lost ; ++m ){
+    uint8_t * source = decoder->symbol[ missing[m] ];
+    memset( source, 0, E22900T22S_FEC_SYMBOL );
+    for( uint8_t r = 0 ; r < lost ; ++r )
+      e22900t22s_fec_mul_add( source, decoder->repair[ rows[r] ], inverse[m][r], symbol );
+    // A body longer than the block, or holding a limiter, means the segments did not belong together
+    if( source[0] >= symbol || memchr( &source[1], 0x00, source[0] ) ){
+      fec->errors++;
+      continue;
+    }
+    decoder->have |= 1u << missing[m];
+    decoder->rssi[ missing[m] ] = decoder->rssi_repair;
+    fec->recovered++;
+  }
+  decoder->repaired = 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+fec_release( e22900t22s_fec_t * fec, const uint8_t finish, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  e22900t22s_fec_decoder_t * decoder = &fec->decoder;
+  // Until the first repair tells the sources, the block ends at the last source received
+  uint8_t end = decoder->sources;
+  if( !end )
+    for( uint8_t i = 0 ; i < E22900T22S_FEC_SOURCES ; ++i )
+      if( decoder->have >> i & 1u )
+        end = (uint8_t) ( i + 1 );
+
+  while( decoder->next < end ){
+    uint8_t i = decoder->next;
+    if( !( decoder->have >> i & 1u ) ){
+      if( !finish )
+        break;
+      fec->lost++;
+    }
+    else if( -1 == e22900t22s_segment_emit( &decoder->symbol[i][1], decoder->symbol[i][0], decoder->rssi[i], with_rssi, out, length, size ) )
+      return -1;
+    decoder->next++;
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+fec_segment( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  e22900t22s_fec_t * fec = (e22900t22s_fec_t *) stage;
+  e22900t22s_fec_decoder_t * decoder = &fec->decoder;
+  if( len < 2 ){
+    fec->errors++;
+    return 0;
+  }
+  if( E22900T22S_FEC_PLAIN == body[1] )
+    return e22900t22s_segment_emit( &body[2], len - 2, rssi, with_rssi, out, length, size );
+
+  // The first segment of another block ends the one gathered, its gaps are given up
+  if( body[0] != decoder->block ){
+    if( decoder->block && -1 == fec_release( fec, 1, with_rssi, out, length, size ) )
+      return -1;
+    decoder->block = body[0];
+    decoder->first = fec->now;
+    decoder->sources = decoder->length = decoder->next = 0;
+    decoder->have = 0;
+    decoder->repaired = 0;
+  }
+
+  if( body[1] & E22900T22S_FEC_REPAIR ){
+    uint8_t j = (uint8_t) ( ( body[1] & ~E22900T22S_FEC_REPAIR ) - 1 );
+    uint8_t sources = len > 2 ? body[2] : 0;
+    if( j >= E22900T22S_FEC_REPAIRS || !sources || sources > E22900T22S_FEC_SOURCES || ( decoder->sources && sources != decoder->sources ) ){
+      fec->errors++;
+      return 0;
+    }
+    int symbol = e22900t22s_segment_unstuff( &body[3], len - 3, decoder->repair[j], E22900T22S_FEC_SYMBOL );
+    if( symbol < 1 || ( decoder->length && symbol != decoder->length ) ){
+      fec->errors++;
+      return 0;
+    }
+    decoder->sources = sources;
+    decoder->length = (uint8_t) symbol;
+    decoder->repaired = (uint16_t) ( decoder->repaired | 1u << j );
+    decoder->rssi_repair = rssi;
+    fec->repaired++;
+  }
+  else{
+    uint8_t i = (uint8_t) ( body[1] - 1 );
+    if( i >= E22900T22S_FEC_SOURCES || len - 2 >= E22900T22S_FEC_SYMBOL ){
+      fec->errors++;
+      return 0;
+    }
+    if( !( decoder->have >> i & 1u ) ){
+      uint8_t * symbol = decoder->symbol[i];
+      symbol[0] = (uint8_t) ( len - 2 );
+      memcpy( &symbol[1], &body[2], len - 2 );
+      memset( &symbol[ len - 1 ], 0, E22900T22S_FEC_SYMBOL - ( len - 1 ) );
+      decoder->have |= 1u << i;
+      decoder->rssi[i] = rssi;
+      fec->sources++;
+    }
+  }
+
+  fec_recover( fec );
+  return fec_release( fec, 0, with_rssi, out, length, size );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_fec_unpack( e22900t22s_fec_t * fec, const uint8_t * data, const size_t len, const uint8_t rssi, const uint64_t now, uint8_t * out, const size_t size ){
+  if( !fec || !data || !out ){
+    errno = EINVAL;
+    return 0;
+  }
+  fec->now = now;
+  // The segment is only handled with its RSSI byte, a source might be handed over much later
+  errno = 0;
+  size_t length = e22900t22s_segment_walk( &fec->decoder.walker, data, len, rssi, NULL, fec_segment, fec, out, size );
+  if( !length && errno )
+    return 0;
+
+  // The next block may never come, a block held past the deadline gives its gaps up
+  if( fec->hold && fec->decoder.block && now - fec->decoder.first > fec->hold && -1 == fec_release( fec, 1, rssi, out, &length, size ) )
+    return 0;
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_fec_bound( const e22900t22s_fec_t * fec, const size_t len ){
+  // The sources waiting in the block, and the ones recovered, come out with the received bytes
+  return len + fec->decoder.walker.length + 2 * E22900T22S_FEC_SOURCES * ( E22900T22S_FEC_SYMBOL + 3 );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
@@ -0,0 +1,215 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s_metrics.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/metrics.h>
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+int8_t metrics_path( const char * name, char * path, const size_t size );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+metrics_path( const char * name, char * path, const size_t size ){
+  if( !name || !path ){
+    errno = EINVAL;
+    return -1;
+  }
+  int len = snprintf( path, size, E22900T22S_METRICS_SHM, name );
+  if( 0 > len || (size_t) len >= size ){
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_noise_init( e22900t22s_noise_t * noise, const float No ){
+  memset( noise, 0, sizeof(e22900t22s_noise_t) );
+  noise->sample[ 0 ] = No;
+  noise->index = 1;
+  noise->count = 1;
+  noise->interval = E22900T22S_NOISE_INTERVAL_MIN;
+  noise->floor = No;
+  noise->No = No;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+float
+e22900t22s_noise_update( e22900t22s_noise_t * noise, const float sample ){
+  noise->sample[ noise->index ] = sample;
+  noise->index = (uint8_t) ( ( noise->index + 1 ) % E22900T22S_NOISE_WINDOW );
+  if( noise->count < E22900T22S_NOISE_WINDOW )
+    noise->count++;
+
+  noise->floor = noise->sample[ 0 ];
+  for( uint8_t i = 1 ; i < noise->count ; ++i )
+    if( noise->sample[ i ] < noise->floor )
+      noise->floor = noise->sample[ i ];
+
+  float distance = sample - noise->No;
+  if( distance > E22900T22S_NOISE_THRESHOLD || distance < -E22900T22S_NOISE_THRESHOLD )
+    noise->interval = E22900T22S_NOISE_INTERVAL_MIN;
+  else if( noise->interval < E22900T22S_NOISE_INTERVAL_MAX )
+    noise->interval = (uint16_t) ( noise->interval * 2 );
+
+  noise->No += E22900T22S_NOISE_ALPHA * ( noise->floor - noise->No );
+  return noise->No;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_noise_publish( e22900t22s_log_t * logs, const float No ){
+  __atomic_store( &logs->No, &No, __ATOMIC_RELEASE );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+float
+e22900t22s_noise_current( const e22900t22s_log_t * logs ){
+  float No;
+  __atomic_load( &logs->No, &No, __ATOMIC_ACQUIRE );
+  return No;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+e22900t22s_metrics_ring_t *
+e22900t22s_metrics_open( const char * name, const uint8_t create ){
+  char path[NAME_MAX];
+  if( -1 == metrics_path( name, path, sizeof(path) ) )
+    return NULL;
+
+  int fd = shm_open( path, create ? O_CREAT | O_RDWR : O_RDONLY, 0644 );
+  if( -1 == fd )
+    return NULL;
+
+  if( create && -1 == ftruncate( fd, sizeof( e22900t22s_metrics_ring_t ) ) ){
+    close( fd );
+    return NULL;
+  }
+
+  e22900t22s_metrics_ring_t * ring = (e22900t22s_metrics_ring_t *) mmap( NULL, sizeof( e22900t22s_metrics_ring_t ), create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0 );
+  close( fd );
+  if( MAP_FAILED == ring )
+    return NULL;
+
+  if( create ){
+    memset( ring, 0, sizeof( e22900t22s_metrics_ring_t ) );
+    ring->slots = E22900T22S_METRICS_SLOTS;
+    __atomic_store_n( &ring->magic, E22900T22S_METRICS_MAGIC, __ATOMIC_RELEASE );
+  }
+  else if( E22900T22S_METRICS_MAGIC != __atomic_load_n( &ring->magic, __ATOMIC_ACQUIRE ) || E22900T22S_METRICS_SLOTS != ring->slots ){
+    munmap( ring, sizeof( e22900t22s_metrics_ring_t ) );
+    errno = ENODATA;
+    return NULL;
+  }
+
+  return ring;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_metrics_push( e22900t22s_metrics_ring_t * ring, const e22900t22s_rx_metric_t * metric ){
+  if( !ring || !metric )
+    return;
+
+  uint64_t pos = ring->head;
+  e22900t22s_metrics_slot_t * slot = &ring->slot[ pos & ( E22900T22S_METRICS_SLOTS - 1 ) ];
+
+  // Odd sequence while the slot is being written, so a reader copying it at the same time notices
+  __atomic_store_n( &slot->seq, 2 * pos + 1, __ATOMIC_RELAXED );
+  __atomic_thread_fence( __ATOMIC_RELEASE );
+  slot->metric = *metric;
+  __atomic_store_n( &slot->seq, 2 * pos + 2, __ATOMIC_RELEASE );
+  __atomic_store_n( &ring->head, pos + 1, __ATOMIC_RELEASE );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_metrics_pop( const e22900t22s_metrics_ring_t * ring, e22900t22s_metrics_reader_t * reader, e22900t22s_rx_metric_t * metric ){
+  if( !ring || !reader || !metric ){
+    errno = EINVAL;
+    return -1;
+  }
+
+  for( ;; ){
+    uint64_t head = __atomic_load_n( &ring->head, __ATOMIC_ACQUIRE );
+    if( reader->cursor >= head )
+      return 0;
+
+    if( head - reader->cursor > E22900T22S_METRICS_SLOTS ){
+      reader->lost += head - E22900T22S_METRICS_SLOTS - reader->cursor;
+      reader->cursor = head - E22900T22S_METRICS_SLOTS;
+    }
+
+    const e22900t22s_metrics_slot_t * slot = &ring->slot[ reader->cursor & ( E22900T22S_METRICS_SLOTS - 1 ) ];
+    uint64_t seq = __atomic_load_n( &slot->seq, __ATOMIC_ACQUIRE );
+    memcpy( metric, &slot->metric, sizeof( e22900t22s_rx_metric_t ) );
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
+
+    // Same even sequence before and after the copy, and the one expected for this position, means the copy is not torn
+    uint8_t valid = ( 2 * reader->cursor + 2 == seq ) && ( seq == __atomic_load_n( &slot->seq, __ATOMIC_RELAXED ) );
+    reader->cursor ++;
+    if( valid )
+      return 1;
+    reader->lost ++;
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_metrics_close( e22900t22s_metrics_ring_t * ring, const char * name ){
+  if( !ring ){
+    errno = EINVAL;
+    return -1;
+  }
+  if( -1 == munmap( ring, sizeof( e22900t22s_metrics_ring_t ) ) )
+    return -1;
+
+  if( name ){
+    char path[NAME_MAX];
+    if( -1 == metrics_path( name, path, sizeof(path) ) )
+      return -1;
+    return (int8_t) shm_unlink( path );
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
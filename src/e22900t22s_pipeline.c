@@ -0,0 +1,176 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s_pipeline.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/pipeline.h>
+#include <string.h>
+#include <errno.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_pipeline_init( e22900t22s_pipeline_t * pipeline, const uint16_t capacity ){
+  memset( pipeline, 0, sizeof(e22900t22s_pipeline_t) );
+  pipeline->capacity = capacity;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_pipeline_queued( const e22900t22s_pipeline_t * pipeline, const e22900t22s_eeprom_t * cfg, const uint64_t now ){
+  if( pipeline->empty <= now )
+    return 0;
+
+  // The time left on the air is turned back into bytes at the drain rate of a full buffer
+  uint64_t full = e22900t22s_airtime( cfg, pipeline->capacity, NULL );
+  if( !full )
+    return pipeline->capacity;
+  uint64_t queued = ( pipeline->empty - now ) / 1000 * pipeline->capacity / full;
+  return queued > pipeline->capacity ? pipeline->capacity : (size_t) queued;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_pipeline_idle( e22900t22s_pipeline_t * pipeline, const uint64_t now ){
+  if( pipeline->empty > now ){
+    pipeline->empty = now;
+    pipeline->resyncs++;
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_pipeline_push( e22900t22s_pipeline_t * pipeline, const e22900t22s_eeprom_t * cfg, const size_t len, const uint64_t now ){
+  uint64_t airtime = e22900t22s_airtime( cfg, len, NULL );
+  if( !pipeline->start )
+    pipeline->start = now;
+  pipeline->empty = ( pipeline->empty > now ? pipeline->empty : now ) + airtime * 1000;
+  pipeline->bytes += len;
+  pipeline->airtime += airtime;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t
+e22900t22s_pipeline_room( const e22900t22s_pipeline_t * pipeline, const e22900t22s_eeprom_t * cfg, const size_t len, const uint64_t now ){
+  size_t queued = e22900t22s_pipeline_queued( pipeline, cfg, now );
+  if( queued + len <= pipeline->capacity )
+    return 0;
+
+  // Waits for the excess to go on the air, a write bigger than the buffer waits for it to empty
+  size_t excess = len > pipeline->capacity ? queued : queued + len - pipeline->capacity;
+  return e22900t22s_airtime( cfg, excess, NULL );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+float
+e22900t22s_pipeline_goodput( const e22900t22s_pipeline_t * pipeline, const e22900t22s_eeprom_t * cfg, const uint64_t now, float * ratio ){
+  uint64_t end = pipeline->empty > now ? pipeline->empty : now;
+  if( !pipeline->start || end <= pipeline->start ){
+    if( ratio )
+      *ratio = 0;
+    return 0;
+  }
+
+  float goodput = (float) pipeline->bytes * 8.0f * 1e9f / (float) ( end - pipeline->start );
+  if( ratio ){
+    uint8_t airrate = lookup_table_airrate_2bin( cfg->airrate );
+    *ratio = airrate < E22900T22S_LUT_SIZE_AIRRATE ? goodput / (float) lut_airrate_bps[ airrate ] : 0;
+  }
+  return goodput;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_transmit_init( e22900t22s_transmit_t * transmit, const uint16_t capacity, const uint64_t now ){
+  if( !transmit || !capacity ){
+    errno = EINVAL;
+    return -1;
+  }
+  memset( transmit, 0, sizeof(e22900t22s_transmit_t) );
+  e22900t22s_duty_init( &transmit->duty, now );
+  e22900t22s_pipeline_init( &transmit->pipeline, capacity );
+  return e22900t22s_shared_mutex_init( &transmit->lock );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t
+e22900t22s_transmit_reserve( e22900t22s_transmit_t * transmit, const e22900t22s_eeprom_t * cfg, const size_t len, const uint64_t now, uint64_t * airtime ){
+  uint64_t spent = e22900t22s_airtime( cfg, len, NULL );
+  if( airtime )
+    *airtime = spent;
+
+  e22900t22s_shared_mutex_lock( &transmit->lock );
+  uint64_t wait = e22900t22s_duty_reserve( &transmit->duty, e22900t22s_subband( cfg->channel ), spent, now );
+  pthread_mutex_unlock( &transmit->lock );
+  return wait;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t
+e22900t22s_transmit_budget( e22900t22s_transmit_t * transmit, const e22900t22s_eeprom_t * cfg, const uint64_t now ){
+  e22900t22s_shared_mutex_lock( &transmit->lock );
+  uint64_t budget = e22900t22s_duty_budget( &transmit->duty, e22900t22s_subband( cfg->channel ), now );
+  pthread_mutex_unlock( &transmit->lock );
+  return budget;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_transmit_queued( e22900t22s_transmit_t * transmit, const e22900t22s_eeprom_t * cfg, const uint64_t now ){
+  e22900t22s_shared_mutex_lock( &transmit->lock );
+  size_t queued = e22900t22s_pipeline_queued( &transmit->pipeline, cfg, now );
+  pthread_mutex_unlock( &transmit->lock );
+  return queued;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_transmit_push( e22900t22s_transmit_t * transmit, const e22900t22s_eeprom_t * cfg, const size_t len, const uint8_t idle, const uint64_t now ){
+  e22900t22s_shared_mutex_lock( &transmit->lock );
+  if( idle )
+    e22900t22s_pipeline_idle( &transmit->pipeline, now );
+  e22900t22s_pipeline_push( &transmit->pipeline, cfg, len, now );
+  pthread_mutex_unlock( &transmit->lock );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t
+e22900t22s_transmit_room( e22900t22s_transmit_t * transmit, const e22900t22s_eeprom_t * cfg, const size_t len, const uint64_t now ){
+  e22900t22s_shared_mutex_lock( &transmit->lock );
+  uint64_t wait = e22900t22s_pipeline_room( &transmit->pipeline, cfg, len, now );
+  if( wait ){
+    transmit->pipeline.stalls++;
+    transmit->pipeline.stalled += wait;
+  }
+  pthread_mutex_unlock( &transmit->lock );
+  return wait;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
@@ -0,0 +1,526 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s_reactor.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/reactor.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+// The event data carries the module and the source, so no lookup is needed when it fires
+#define REACTOR_TAG( index, source )    ( (uint64_t) (index) << 8 | (uint64_t) (source) )
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+uint64_t reactor_now( void );
+int8_t reactor_watch( e22900t22s_reactor_t * reactor, const int op, const int fd, const uint32_t events, const uint8_t index, const e22900t22s_source_t source );
+int8_t reactor_arm( const int timer, const uint64_t when );
+int8_t reactor_blocking( e22900t22s_device_t * device, const uint8_t blocking );
+int8_t reactor_transmit( e22900t22s_reactor_t * reactor, const uint8_t index );
+size_t reactor_reply( e22900t22s_device_t * device, const uint8_t * data, const size_t length, uint8_t * kept );
+void reactor_count( e22900t22s_device_t * device, const uint8_t * data, const size_t length );
+int8_t reactor_receive( e22900t22s_reactor_t * reactor, const uint8_t index );
+int8_t reactor_idle( e22900t22s_reactor_t * reactor, const uint8_t index );
+int8_t reactor_noise( e22900t22s_reactor_t * reactor, const uint8_t index );
+void reactor_release( e22900t22s_reactor_t * reactor, e22900t22s_device_t * device );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t
+reactor_now( void ){
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+reactor_watch( e22900t22s_reactor_t * reactor, const int op, const int fd, const uint32_t events, const uint8_t index, const e22900t22s_source_t source ){
+  struct epoll_event event = { .events = events, .data.u64 = REACTOR_TAG( index, source ) };
+  if( -1 == epoll_ctl( reactor->epoll, op, fd, &event ) ){
+    perror("epoll_ctl");
+    return -1;
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+reactor_arm( const int timer, const uint64_t when ){
+  // An absolute time already past fires right away, 0 would disarm the timer
+  struct itimerspec spec = { .it_interval = { 0, 0 }, .it_value = { .tv_sec = (time_t) ( when / 1000000000ULL ), .tv_nsec = (long) ( when % 1000000000ULL ) } };
+  if( !when )
+    spec.it_value.tv_nsec = 1;
+  if( -1 == timerfd_settime( timer, TFD_TIMER_ABSTIME, &spec, NULL ) ){
+    perror("timerfd_settime");
+    return -1;
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+reactor_blocking( e22900t22s_device_t * device, const uint8_t blocking ){
+  int fd = device->dev.serial->sr.fd;
+  int flags = fcntl( fd, F_GETFL );
+  if( -1 == flags || -1 == fcntl( fd, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK ) ){
+    perror("fcntl");
+    return -1;
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+reactor_transmit( e22900t22s_reactor_t * reactor, const uint8_t index ){
+  e22900t22s_device_t * device = &reactor->device[ index ];
+  e22900t22s_t * dev = &device->dev;
+
+  // The module answers the RSSI command first, the writes resume with its reply
+  if( device->sampling )
+    return 0;
+
+  while( device->count ){
+    e22900t22s_tx_t * tx = &device->queue[ device->head ];
+    uint64_t now = reactor_now( );
+
+    // The air time is taken once, the write then waits on the timer until the sub-band has paid it back
+    if( !tx->charged ){
+      uint64_t wait = e22900t22s_duty_reserve( &device->duty, e22900t22s_subband( dev->cfg.channel ), e22900t22s_airtime( &dev->cfg, tx->length, NULL ), now );
+      tx->charged = 1;
+      tx->ready = now + wait * 1000;
+    }
+    if( tx->ready > now )
+      return reactor_arm( device->tx_timer, tx->ready );
+
+    // A write only starts when it fits in the module buffer, AUX or the timer start it again
+    if( !tx->done ){
+      uint64_t wait = e22900t22s_pipeline_room( &device->pipeline, &dev->cfg, tx->length, now );
+      if( wait )
+        return reactor_arm( device->tx_timer, now + wait * 1000 );
+    }
+
+    ssize_t written = write( dev->serial->sr.fd, &tx->data[ tx->done ], (size_t) ( tx->length - tx->done ) );
+    if( -1 == written ){
+      if( EINTR == errno )
+        continue;
+      if( EAGAIN != errno ){
+        perror("write");
+        return -1;
+      }
+      if( !device->writable ){
+        device->writable = 1;
+        return reactor_watch( reactor, EPOLL_CTL_MOD, dev->serial->sr.fd, EPOLLIN | EPOLLOUT, index, E22900T22S_SOURCE_SERIAL );
+      }
+      return 0;
+    }
+
+    tx->done = (uint16_t) ( tx->done + written );
+    if( tx->done < tx->length )
+      continue;
+
+    e22900t22s_pipeline_push( &device->pipeline, &dev->cfg, tx->length, now );
+    device->logs.n_sent++;
+    device->head = ( device->head + 1 ) & ( E22900T22S_TX_QUEUE - 1 );
+    device->count--;
+  }
+
+  if( device->writable ){
+    device->writable = 0;
+    return reactor_watch( reactor, EPOLL_CTL_MOD, dev->serial->sr.fd, EPOLLIN, index, E22900T22S_SOURCE_SERIAL );
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+reactor_reply( e22900t22s_device_t * device, const uint8_t * data, const size_t length, uint8_t * kept ){
+  // The reply comes in the data stream, the bytes matching its header are held until it is complete or proven to be data
+  const uint8_t header[ E22900T22S_NOISE_REPLY - 1 ] = { 0xC1, E22900T22S_CURR_RSSI, 1 };
+  size_t k = 0;
+  for( size_t i = 0 ; i < length ; ++i ){
+    if( !device->sampling ){
+      kept[ k++ ] = data[ i ];
+      continue;
+    }
+    if( E22900T22S_NOISE_REPLY - 1 == device->replied ){
+      device->sampling = 0;
+      device->replied = 0;
+      e22900t22s_noise_publish( &device->logs, e22900t22s_noise_update( &device->noise, e22900t22s_get_signal_rssi( data[ i ] ) ) );
+      continue;
+    }
+    if( data[ i ] == header[ device->replied ] ){
+      device->replied++;
+      continue;
+    }
+    memcpy( &kept[ k ], header, device->replied );
+    k += device->replied;
+    device->replied = data[ i ] == header[ 0 ];
+    if( !device->replied )
+      kept[ k++ ] = data[ i ];
+  }
+  return k;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+reactor_count( e22900t22s_device_t * device, const uint8_t * data, const size_t length ){
+  // A segment counts at its EOF, a limiter right after the SOF opens it again, the RSSI byte after the EOF is no limiter
+  for( size_t i = 0 ; i < length ; ++i ){
+    if( device->awaiting ){
+      device->awaiting = 0;
+      continue;
+    }
+    if( data[ i ] ){
+      device->filled = device->open;
+      continue;
+    }
+    if( device->open && device->filled ){
+      device->open = device->filled = 0;
+      device->awaiting = device->dev.cfg.rssi;
+      device->logs.n_received++;
+    }
+    else
+      device->open = 1;
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+reactor_receive( e22900t22s_reactor_t * reactor, const uint8_t index ){
+  e22900t22s_device_t * device = &reactor->device[ index ];
+  uint8_t chunk[ E22900T22S_RX_CHUNK ];
+  uint8_t kept[ E22900T22S_RX_CHUNK + E22900T22S_NOISE_REPLY ];
+  for( ; ; ){
+    ssize_t length = read( device->dev.serial->sr.fd, chunk, sizeof(chunk) );
+    if( -1 == length ){
+      if( EINTR == errno )
+        continue;
+      if( EAGAIN == errno )
+        return 0;
+      perror("read");
+      return -1;
+    }
+    if( 0 == length )
+      return 0;
+
+    uint8_t sampling = device->sampling;
+    size_t data = reactor_reply( device, chunk, (size_t) length, kept );
+    reactor_count( device, kept, data );
+    if( data && device->receive )
+      device->receive( device, kept, data, device->user );
+
+    // The reply came, the next sample is due after the interval and the writes held for it go
+    if( sampling && !device->sampling &&
+        ( -1 == reactor_arm( device->noise_timer, reactor_now( ) + (uint64_t) device->noise.interval * 1000000000ULL ) || -1 == reactor_transmit( reactor, index ) ) )
+      return -1;
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+reactor_idle( e22900t22s_reactor_t * reactor, const uint8_t index ){
+  e22900t22s_device_t * device = &reactor->device[ index ];
+
+  // Every queued edge is consumed, the level decides
+  struct gpiod_line_event event;
+  if( -1 == gpiod_line_event_read( device->dev.gpio.aux.ptr, &event ) ){
+    perror("gpiod_line_event_read");
+    return -1;
+  }
+
+  int8_t busy = e22900t22s_is_busy( &device->dev );
+  if( -1 == busy )
+    return -1;
+  if( !busy )
+    e22900t22s_pipeline_idle( &device->pipeline, reactor_now( ) );
+  return reactor_transmit( reactor, index );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+reactor_noise( e22900t22s_reactor_t * reactor, const uint8_t index ){
+  e22900t22s_device_t * device = &reactor->device[ index ];
+  uint64_t expirations;
+  if( -1 == read( device->noise_timer, &expirations, sizeof(expirations) ) && EAGAIN != errno ){
+    perror("read");
+    return -1;
+  }
+
+  // No reply in time, the bytes held for its header were data and the writes go again
+  uint64_t now = reactor_now( );
+  if( device->sampling ){
+    const uint8_t header[ E22900T22S_NOISE_REPLY - 1 ] = { 0xC1, E22900T22S_CURR_RSSI, 1 };
+    if( device->replied ){
+      reactor_count( device, header, device->replied );
+      if( device->receive )
+        device->receive( device, header, device->replied, device->user );
+    }
+    device->sampling = 0;
+    device->replied = 0;
+    if( -1 == reactor_arm( device->noise_timer, now + (uint64_t) device->noise.interval * 1000000000ULL ) )
+      return -1;
+    return reactor_transmit( reactor, index );
+  }
+
+  // The RSSI command shares the UART with the data, it waits for the writes to drain
+  if( device->count || e22900t22s_pipeline_queued( &device->pipeline, &device->dev.cfg, now ) )
+    return reactor_arm( device->noise_timer, now + (uint64_t) E22900T22S_NOISE_INTERVAL_MIN * 1000000000ULL );
+
+  // The ambient noise stays enabled from the registration, the command works in the normal mode
+  const uint8_t command[ E22900T22S_NOISE_COMMAND ] = { 0xC0, 0xC1, 0xC2, 0xC3, E22900T22S_CURR_RSSI, 1 };
+  ssize_t written;
+  while( -1 == ( written = write( device->dev.serial->sr.fd, command, sizeof(command) ) ) && EINTR == errno );
+  if( -1 == written && EAGAIN != errno ){
+    perror("write");
+    return -1;
+  }
+  if( sizeof(command) != written )
+    return reactor_arm( device->noise_timer, now + (uint64_t) E22900T22S_NOISE_INTERVAL_MIN * 1000000000ULL );
+
+  device->sampling = 1;
+  device->replied = 0;
+  return reactor_arm( device->noise_timer, now + (uint64_t) E22900T22S_NOISE_WAIT * 1000000ULL );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+reactor_release( e22900t22s_reactor_t * reactor, e22900t22s_device_t * device ){
+  // Closing the timers removes them from the epoll set, the serial port and the AUX line stay open
+  epoll_ctl( reactor->epoll, EPOLL_CTL_DEL, device->dev.serial->sr.fd, NULL );
+  if( -1 != device->aux )
+    epoll_ctl( reactor->epoll, EPOLL_CTL_DEL, device->aux, NULL );
+  if( -1 != device->noise_timer )
+    close( device->noise_timer );
+  if( -1 != device->tx_timer )
+    close( device->tx_timer );
+  device->aux = device->noise_timer = device->tx_timer = -1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_reactor_init( e22900t22s_reactor_t * reactor ){
+  if( !reactor ){
+    errno = EINVAL;
+    return -1;
+  }
+  memset( reactor, 0, sizeof(e22900t22s_reactor_t) );
+  reactor->epoll = epoll_create1( EPOLL_CLOEXEC );
+  if( -1 == reactor->epoll ){
+    perror("epoll_create1");
+    return -1;
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_reactor_add( e22900t22s_reactor_t * reactor, serial_manager_t * serial, const e22900t22s_config_t * config, e22900t22s_receive_t receive, void * user ){
+  if( !reactor || !serial || !config ){
+    errno = EINVAL;
+    return -1;
+  }
+  if( E22900T22S_DEVICES <= reactor->count ){
+    errno = ENOSPC;
+    return -1;
+  }
+
+  uint8_t index = reactor->count;
+  e22900t22s_device_t * device = &reactor->device[ index ];
+  memset( device, 0, sizeof(e22900t22s_device_t) );
+  device->dev.serial = serial;
+  device->receive = receive;
+  device->user = user;
+  device->aux = device->noise_timer = device->tx_timer = -1;
+
+  if( -1 == e22900t22s_set_pinout( &config->pinout, &device->dev ) ){
+    perror("Configuring the pins");
+    return -1;
+  }
+  if( -1 == e22900t22s_set_config( &config->eeprom, 0, &device->dev ) || -1 == e22900t22s_verify_config( &device->dev ) ){
+    perror("Configuring the module");
+    e22900t22s_gpio_close( &device->dev );
+    return -1;
+  }
+
+  // The ambient noise is left enabled in the volatile registers, the samples of the reactor need no mode switch
+  if( !device->dev.cfg.ambient_noise ){
+    e22900t22s_set_ambient_noise( 1, &device->dev );
+    if( -1 == e22900t22s_update_temporary( &device->dev ) ){
+      perror("Enabling the ambient noise");
+      e22900t22s_gpio_close( &device->dev );
+      return -1;
+    }
+  }
+  device->logs.No = e22900t22s_get_noise_rssi( &device->dev, 0 );
+  e22900t22s_noise_init( &device->noise, device->logs.No );
+  uint64_t now = reactor_now( );
+  e22900t22s_duty_init( &device->duty, now );
+  e22900t22s_pipeline_init( &device->pipeline, E22900T22S_MODULE_BUFFER );
+
+  device->noise_timer = timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC );
+  device->tx_timer = timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC );
+  if( -1 == device->noise_timer || -1 == device->tx_timer ){
+    perror("timerfd_create");
+    reactor_release( reactor, device );
+    e22900t22s_gpio_close( &device->dev );
+    return -1;
+  }
+
+  // Without edge events the pipeline only follows its estimate
+  if( device->dev.aux.events )
+    device->aux = gpiod_line_event_get_fd( device->dev.gpio.aux.ptr );
+
+  if( -1 == reactor_blocking( device, 0 ) ||
+      -1 == reactor_watch( reactor, EPOLL_CTL_ADD, serial->sr.fd, EPOLLIN, index, E22900T22S_SOURCE_SERIAL ) ||
+      -1 == reactor_watch( reactor, EPOLL_CTL_ADD, device->noise_timer, EPOLLIN, index, E22900T22S_SOURCE_NOISE ) ||
+      -1 == reactor_watch( reactor, EPOLL_CTL_ADD, device->tx_timer, EPOLLIN, index, E22900T22S_SOURCE_TX ) ||
+      ( -1 != device->aux && -1 == reactor_watch( reactor, EPOLL_CTL_ADD, device->aux, EPOLLIN, index, E22900T22S_SOURCE_AUX ) ) ||
+      -1 == reactor_arm( device->noise_timer, now + (uint64_t) device->noise.interval * 1000000000ULL ) ){
+    reactor_release( reactor, device );
+    reactor_blocking( device, 1 );
+    e22900t22s_gpio_close( &device->dev );
+    return -1;
+  }
+
+  reactor->count++;
+  return (int8_t) index;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_reactor_send( e22900t22s_reactor_t * reactor, const uint8_t index, const uint8_t * data, const size_t length ){
+  if( !reactor || index >= reactor->count || !data || !length || E22900T22S_TX_SLOT < length ){
+    errno = EINVAL;
+    return -1;
+  }
+
+  e22900t22s_device_t * device = &reactor->device[ index ];
+  if( E22900T22S_TX_QUEUE == device->count ){
+    errno = EAGAIN;
+    return -1;
+  }
+
+  e22900t22s_tx_t * tx = &device->queue[ ( device->head + device->count ) & ( E22900T22S_TX_QUEUE - 1 ) ];
+  memcpy( tx->data, data, length );
+  tx->length = (uint16_t) length;
+  tx->done = 0;
+  tx->charged = 0;
+  device->count++;
+
+  // Only the head of the queue can go, the others follow from the reactor
+  return 1 == device->count ? reactor_transmit( reactor, index ) : 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+e22900t22s_reactor_run( e22900t22s_reactor_t * reactor, const int timeout ){
+  if( !reactor ){
+    errno = EINVAL;
+    return -1;
+  }
+
+  struct epoll_event events[ E22900T22S_REACTOR_EVENTS ];
+  int ready = epoll_wait( reactor->epoll, events, E22900T22S_REACTOR_EVENTS, timeout );
+  if( -1 == ready ){
+    if( EINTR == errno )
+      return 0;
+    perror("epoll_wait");
+    return -1;
+  }
+
+  for( int i = 0 ; i < ready ; ++i ){
+    uint8_t index = (uint8_t) ( events[ i ].data.u64 >> 8 );
+    e22900t22s_device_t * device = &reactor->device[ index ];
+    int8_t ret = 0;
+
+    switch( (e22900t22s_source_t) ( events[ i ].data.u64 & 0xFF ) ){
+      case E22900T22S_SOURCE_SERIAL:
+        if( events[ i ].events & ( EPOLLIN | EPOLLERR | EPOLLHUP ) )
+          ret = reactor_receive( reactor, index );
+        if( -1 != ret && events[ i ].events & EPOLLOUT )
+          ret = reactor_transmit( reactor, index );
+        break;
+      case E22900T22S_SOURCE_AUX:
+        ret = reactor_idle( reactor, index );
+        break;
+      case E22900T22S_SOURCE_NOISE:
+        ret = reactor_noise( reactor, index );
+        break;
+      case E22900T22S_SOURCE_TX:{
+        uint64_t expirations;
+        if( -1 == read( device->tx_timer, &expirations, sizeof(expirations) ) && EAGAIN != errno ){
+          perror("read");
+          return -1;
+        }
+        ret = reactor_transmit( reactor, index );
+        break;
+      }
+      default:
+        break;
+    }
+    if( -1 == ret )
+      return -1;
+  }
+  return ready;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_reactor_close( e22900t22s_reactor_t * reactor ){
+  if( !reactor ){
+    errno = EINVAL;
+    return -1;
+  }
+
+  int8_t ret = 0;
+  for( uint8_t i = 0 ; i < reactor->count ; ++i ){
+    e22900t22s_device_t * device = &reactor->device[ i ];
+    reactor_release( reactor, device );
+    if( -1 == reactor_blocking( device, 1 ) || -1 == e22900t22s_gpio_close( &device->dev ) )
+      ret = -1;
+  }
+  close( reactor->epoll );
+  reactor->count = 0;
+  return ret;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
@@ -0,0 +1,346 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s_rohc.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/rohc.h>
+#include <errno.h>
+#include <string.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define ROHC_UDP_PROTOCOL  17
+#define ROHC_IPV4_VERSION  0x45                     // Version 4, header of 5 words, no options
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+uint8_t rohc_crc3( const uint8_t * data, const size_t len );
+void rohc_rebuild( const uint8_t * reference, const uint16_t id, const uint16_t checksum, const size_t payload, uint8_t * headers );
+e22900t22s_rohc_context_t * rohc_find( e22900t22s_rohc_t * rohc, const uint8_t * headers, uint8_t * cid );
+size_t rohc_compress( e22900t22s_rohc_t * rohc, const uint8_t * body, const size_t len, uint8_t * out );
+int rohc_expand( e22900t22s_rohc_t * rohc, const uint8_t * body, const size_t len, uint8_t * out, const size_t size );
+int8_t rohc_unpacked( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+int8_t rohc_packed( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t
+rohc_crc3( const uint8_t * data, const size_t len ){
+  // x^3 + x + 1, least significant bit first, as the 3 bit CRC of ROHC
+  uint8_t crc = 0x07;
+  for( size_t i = 0 ; i < len ; ++i )
+    for( uint8_t bit = 0 ; bit < 8 ; ++bit ){
+      uint8_t feedback = (uint8_t) ( ( crc ^ ( data[i] >> bit ) ) & 0x01 );
+      crc = (uint8_t) ( crc >> 1 );
+      if( feedback )
+        crc ^= 0x06;
+    }
+  return crc;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+rohc_rebuild( const uint8_t * reference, const uint16_t id, const uint16_t checksum, const size_t payload, uint8_t * headers ){
+  // Lengths and the IP checksum follow from the datagram, the UDP checksum is only kept by flows that use it
+  memcpy( headers, reference, E22900T22S_ROHC_HEADERS );
+  size_t total = E22900T22S_ROHC_HEADERS + payload;
+  headers[2] = (uint8_t) ( total >> 8 );
+  headers[3] = (uint8_t) total;
+  headers[4] = (uint8_t) ( id >> 8 );
+  headers[5] = (uint8_t) id;
+  headers[10] = headers[11] = 0;
+  uint32_t sum = 0;
+  for( uint8_t i = 0 ; i < E22900T22S_ROHC_IPV4 ; i += 2 )
+    sum += (uint32_t) headers[i] << 8 | headers[ i + 1 ];
+  while( sum >> 16 )
+    sum = ( sum & 0xFFFF ) + ( sum >> 16 );
+  headers[10] = (uint8_t) ( ~sum >> 8 );
+  headers[11] = (uint8_t) ~sum;
+  size_t udp = E22900T22S_ROHC_UDP + payload;
+  headers[24] = (uint8_t) ( udp >> 8 );
+  headers[25] = (uint8_t) udp;
+  uint8_t used = reference[26] | reference[27];
+  headers[26] = used ? (uint8_t) ( checksum >> 8 ) : 0;
+  headers[27] = used ? (uint8_t) checksum : 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+e22900t22s_rohc_context_t *
+rohc_find( e22900t22s_rohc_t * rohc, const uint8_t * headers, uint8_t * cid ){
+  // The flow is the addresses and the ports, 12 bytes in a row from the IP source
+  const uint8_t * flow = &headers[12];
+  uint32_t hash = 2166136261U;
+  for( uint8_t i = 0 ; i < 12 ; ++i )
+    hash = ( hash ^ flow[i] ) * 16777619U;
+
+  uint8_t start = (uint8_t) ( hash % E22900T22S_ROHC_CONTEXTS );
+  uint8_t chosen = start;
+  for( uint8_t k = 0 ; k < E22900T22S_ROHC_CONTEXTS ; ++k ){
+    uint8_t slot = (uint8_t) ( ( start + k ) % E22900T22S_ROHC_CONTEXTS );
+    e22900t22s_rohc_context_t * context = &rohc->compressor[ slot ];
+    if( context->used && 0 == memcmp( &context->headers[12], flow, 12 ) ){
+      *cid = slot;
+      context->stamp = ++rohc->clock;
+      return context;
+    }
+    // A free slot is taken before any flow is replaced, otherwise the least recently used
+    if( !context->used ){
+      if( rohc->compressor[ chosen ].used )
+        chosen = slot;
+    }
+    else if( rohc->compressor[ chosen ].used && context->stamp < rohc->compressor[ chosen ].stamp )
+      chosen = slot;
+  }
+
+  e22900t22s_rohc_context_t * context = &rohc->compressor[ chosen ];
+  context->used = 1;
+  context->startup = E22900T22S_ROHC_STARTUP;
+  context->packets = 0;
+  context->stamp = ++rohc->clock;
+  *cid = chosen;
+  return context;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+rohc_compress( e22900t22s_rohc_t * rohc, const uint8_t * body, const size_t len, uint8_t * out ){
+  // The segment is only touched if stuffing its datagram again gives it back byte for byte, so the receiver restores it exactly
+  uint8_t datagram[ E22900T22S_ROHC_SEGMENT ];
+  uint8_t stuffed[ E22900T22S_ROHC_SEGMENT + 4 ];
+  int length = len <= E22900T22S_ROHC_SEGMENT ? e22900t22s_segment_unstuff( body, len, datagram, sizeof(datagram) ) : -1;
+  if( length < E22900T22S_ROHC_HEADERS || ROHC_IPV4_VERSION != datagram[0] || ROHC_UDP_PROTOCOL != datagram[9] ||
+      len != e22900t22s_segment_stuff( datagram, (size_t) length, stuffed ) || memcmp( stuffed, body, len ) ){
+    rohc->passed++;
+    out[0] = E22900T22S_ROHC_RAW;
+    memcpy( &out[1], body, len );
+    return len + 1;
+  }
+
+  uint8_t cid;
+  e22900t22s_rohc_context_t * context = rohc_find( rohc, datagram, &cid );
+  size_t payload = (size_t) length - E22900T22S_ROHC_HEADERS;
+  uint16_t id = (uint16_t) ( datagram[4] << 8 | datagram[5] );
+  uint16_t step = (uint16_t) ( id - ( context->headers[4] << 8 | context->headers[5] ) );
+  uint8_t kind = step < E22900T22S_ROHC_WINDOW ? E22900T22S_ROHC_CO8 : E22900T22S_ROHC_CO16;
+
+  // Full headers when the context starts, once in a while, or when a field the context keeps has changed
+  uint8_t headers[ E22900T22S_ROHC_HEADERS ];
+  rohc_rebuild( context->headers, id, (uint16_t) ( datagram[26] << 8 | datagram[27] ), payload, headers );
+  if( context->startup ){
+    context->startup--;
+    kind = E22900T22S_ROHC_IR;
+  }
+  else if( !( context->packets % E22900T22S_ROHC_REFRESH ) || memcmp( headers, datagram, E22900T22S_ROHC_HEADERS ) )
+    kind = E22900T22S_ROHC_IR;
+  context->packets++;
+
+  uint8_t packet[ E22900T22S_ROHC_SEGMENT + 1 ];
+  size_t p = 0;
+  packet[ p++ ] = (uint8_t) ( kind << 6 | cid << 3 | rohc_crc3( datagram, E22900T22S_ROHC_HEADERS ) );
+  if( E22900T22S_ROHC_IR == kind ){
+    memcpy( &packet[p], datagram, E22900T22S_ROHC_HEADERS );
+    p += E22900T22S_ROHC_HEADERS;
+    rohc->refreshes++;
+  }
+  else{
+    if( E22900T22S_ROHC_CO16 == kind )
+      packet[ p++ ] = datagram[4];
+    packet[ p++ ] = datagram[5];
+    if( context->headers[26] | context->headers[27] ){
+      packet[ p++ ] = datagram[26];
+      packet[ p++ ] = datagram[27];
+    }
+  }
+  memcpy( context->headers, datagram, E22900T22S_ROHC_HEADERS );
+  rohc->datagrams++;
+  rohc->headers_in += E22900T22S_ROHC_HEADERS;
+  rohc->headers_out += p;
+
+  memcpy( &packet[p], &datagram[ E22900T22S_ROHC_HEADERS ], payload );
+  p += payload;
+  out[0] = E22900T22S_ROHC_COBS;
+  return e22900t22s_segment_stuff( packet, p, &out[1] ) + 1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+rohc_expand( e22900t22s_rohc_t * rohc, const uint8_t * body, const size_t len, uint8_t * out, const size_t size ){
+  if( !len )
+    return -1;
+  if( E22900T22S_ROHC_RAW == body[0] ){
+    if( len - 1 > size )
+      return -1;
+    memcpy( out, &body[1], len - 1 );
+    return (int) ( len - 1 );
+  }
+  if( E22900T22S_ROHC_COBS != body[0] )
+    return -1;
+
+  uint8_t packet[ E22900T22S_ROHC_SEGMENT + 1 ];
+  int length = e22900t22s_segment_unstuff( &body[1], len - 1, packet, sizeof(packet) );
+  if( length < 2 )
+    return -1;
+  uint8_t kind = packet[0] >> 6;
+  e22900t22s_rohc_context_t * context = &rohc->decompressor[ ( packet[0] >> 3 ) & 0x07 ];
+
+  uint8_t datagram[ E22900T22S_ROHC_SEGMENT + E22900T22S_ROHC_HEADERS + 1 ];
+  size_t p = 1;
+  if( E22900T22S_ROHC_IR == kind ){
+    if( (size_t) length < 1 + E22900T22S_ROHC_HEADERS )
+      return -1;
+    memcpy( datagram, &packet[1], E22900T22S_ROHC_HEADERS );
+    p += E22900T22S_ROHC_HEADERS;
+  }
+  else if( E22900T22S_ROHC_CO8 == kind || E22900T22S_ROHC_CO16 == kind ){
+    // Without the full headers of the flow there is nothing to restore from, the next refresh brings them
+    if( !context->used )
+      return -1;
+    uint16_t id;
+    if( E22900T22S_ROHC_CO16 == kind ){
+      if( 3 > length )
+        return -1;
+      id = (uint16_t) ( packet[1] << 8 | packet[2] );
+      p += 2;
+    }
+    else{
+      // The 8 bits are the next value after the reference that ends with them
+      uint16_t reference = (uint16_t) ( context->headers[4] << 8 | context->headers[5] );
+      id = (uint16_t) ( reference + (uint8_t) ( packet[1] - (uint8_t) reference ) );
+      p += 1;
+    }
+    uint16_t checksum = 0;
+    if( context->headers[26] | context->headers[27] ){
+      if( p + 2 > (size_t) length )
+        return -1;
+      checksum = (uint16_t) ( packet[p] << 8 | packet[ p + 1 ] );
+      p += 2;
+    }
+    rohc_rebuild( context->headers, id, checksum, (size_t) length - p, datagram );
+  }
+  else
+    return -1;
+
+  // A context that restores wrong headers is not trusted again until full headers come, 3 bits let one bad packet in 8 through
+  if( ( packet[0] & 0x07 ) != rohc_crc3( datagram, E22900T22S_ROHC_HEADERS ) ){
+    if( E22900T22S_ROHC_IR != kind )
+      context->used = 0;
+    return -1;
+  }
+  size_t total = E22900T22S_ROHC_HEADERS + (size_t) length - p;
+  if( total > E22900T22S_ROHC_SEGMENT || total + 2 > size )
+    return -1;
+  memcpy( &datagram[ E22900T22S_ROHC_HEADERS ], &packet[p], (size_t) length - p );
+
+  context->used = 1;
+  memcpy( context->headers, datagram, E22900T22S_ROHC_HEADERS );
+  rohc->datagrams++;
+  rohc->refreshes += E22900T22S_ROHC_IR == kind;
+  rohc->headers_in += E22900T22S_ROHC_HEADERS;
+  rohc->headers_out += p;
+  return (int) e22900t22s_segment_stuff( datagram, total, out );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_rohc_init( e22900t22s_rohc_t * rohc ){
+  memset( rohc, 0, sizeof(e22900t22s_rohc_t) );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+rohc_packed( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  (void) rssi;
+  (void) with_rssi;
+  if( *length + len + E22900T22S_ROHC_HEADER + 2 > size ){
+    errno = ENOBUFS;
+    return -1;
+  }
+  out[ (*length)++ ] = 0x00;
+  *length += rohc_compress( (e22900t22s_rohc_t *) stage, body, len, &out[ *length ] );
+  out[ (*length)++ ] = 0x00;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_rohc_pack( e22900t22s_rohc_t * rohc, const uint8_t * data, const size_t len, uint8_t * out, const size_t size ){
+  if( !rohc || !data || !out ){
+    errno = EINVAL;
+    return 0;
+  }
+  // A segment still open at the end of `data` waits for the write that closes it, only a whole datagram has headers to compress
+  return e22900t22s_segment_walk( &rohc->writer, data, len, 0, NULL, rohc_packed, rohc, out, size );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_rohc_bound( const e22900t22s_rohc_t * rohc, const size_t len ){
+  // A segment takes at least 4 bytes, the limiters, the marker and one more, and gets back at most the headers
+  size_t total = len + rohc->reader.length;
+  return total + ( total / 4 + 1 ) * ( E22900T22S_ROHC_HEADERS + 2 );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+rohc_unpacked( void * stage, const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  e22900t22s_rohc_t * rohc = (e22900t22s_rohc_t *) stage;
+  if( *length + E22900T22S_ROHC_SEGMENT + 5 > size ){
+    errno = ENOBUFS;
+    return -1;
+  }
+  // The datagram is restored right after its SOF, a segment that can not be restored is dropped with its RSSI byte
+  int restored = rohc_expand( rohc, body, len, &out[ *length + 1 ], E22900T22S_ROHC_SEGMENT + 2 );
+  if( -1 == restored ){
+    rohc->errors++;
+    return 0;
+  }
+  out[ *length ] = 0x00;
+  *length += (size_t) restored + 1;
+  out[ (*length)++ ] = 0x00;
+  if( with_rssi )
+    out[ (*length)++ ] = rssi;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_rohc_unpack( e22900t22s_rohc_t * rohc, const uint8_t * data, const size_t len, const uint8_t rssi, uint8_t * out, const size_t size ){
+  if( !rohc || !data || !out ){
+    errno = EINVAL;
+    return 0;
+  }
+  return e22900t22s_segment_walk( &rohc->reader, data, len, rssi, NULL, rohc_unpacked, rohc, out, size );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
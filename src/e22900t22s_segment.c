@@ -0,0 +1,173 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s_segment.c
+ * 
+ * @version   1.0
+ *
+ * @date      17-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/segment.h>
+#include <errno.h>
+#include <string.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_segment_limiter( const uint8_t * data, const size_t from, const size_t len ){
+  const uint8_t * limiter = from < len ? (const uint8_t *) memchr( &data[ from ], 0x00, len - from ) : NULL;
+  return limiter ? (size_t) ( limiter - data ) : len;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_segment_stuff( const uint8_t * data, const size_t len, uint8_t * out ){
+  // COBS, every run of non zero bytes is led by its length plus one, the zero after it is implied
+  size_t code = 0;
+  size_t length = 1;
+  uint8_t run = 1;
+  for( size_t i = 0 ; i < len ; ++i ){
+    if( data[i] ){
+      out[ length++ ] = data[i];
+      if( 0xFF != ++run )
+        continue;
+    }
+    out[ code ] = run;
+    code = length++;
+    run = 1;
+  }
+  out[ code ] = run;
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+e22900t22s_segment_unstuff( const uint8_t * data, const size_t len, uint8_t * out, const size_t size ){
+  size_t length = 0;
+  for( size_t i = 0 ; i < len ; ){
+    uint8_t run = data[ i++ ];
+    if( !run || i + run - 1u > len || length + run > size )
+      return -1;
+    memcpy( &out[ length ], &data[i], run - 1u );
+    length += run - 1u;
+    i += run - 1u;
+    if( 0xFF != run && i < len )
+      out[ length++ ] = 0x00;
+  }
+  return (int) length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_segment_emit( const uint8_t * body, const size_t len, const uint8_t rssi, const uint8_t with_rssi, uint8_t * out, size_t * length, const size_t size ){
+  if( *length + len + 3 > size ){
+    errno = ENOBUFS;
+    return -1;
+  }
+  out[ (*length)++ ] = 0x00;
+  memcpy( &out[ *length ], body, len );
+  *length += len;
+  out[ (*length)++ ] = 0x00;
+  if( with_rssi )
+    out[ (*length)++ ] = rssi;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+e22900t22s_segment_walk( e22900t22s_segment_walker_t * walker, const uint8_t * data, const size_t len, const uint8_t rssi, e22900t22s_segment_check_t check,
+                         e22900t22s_segment_handler_t handler, void * stage, uint8_t * out, const size_t size ){
+  if( !walker || !data || !handler || !out ){
+    errno = EINVAL;
+    return 0;
+  }
+
+  size_t length = 0;
+  size_t i = 0;
+  while( i < len ){
+    // The segment is only handed over with its RSSI byte, it might come in the next buffer
+    if( walker->awaiting ){
+      walker->awaiting = 0;
+      int8_t ret = handler( stage, walker->body, walker->length, data[ i++ ], 1, out, &length, size );
+      walker->length = 0;
+      if( -1 == ret )
+        return 0;
+      continue;
+    }
+
+    // Only a limiter opens a segment, the bytes before it belong to none
+    if( !walker->open ){
+      size_t sof = e22900t22s_segment_limiter( data, i, len );
+      walker->stray += (uint32_t) ( sof - i );
+      if( sof >= len )
+        break;
+      walker->open = 1;
+      walker->length = 0;
+      i = sof + 1;
+      continue;
+    }
+
+    size_t eof = e22900t22s_segment_limiter( data, i, len );
+    size_t chunk = ( eof < len ? eof : len ) - i;
+    if( walker->overlong || walker->length + chunk > sizeof(walker->body) )
+      walker->overlong = 1;
+    else{
+      memcpy( &walker->body[ walker->length ], &data[ i ], chunk );
+      walker->length = (uint16_t) ( walker->length + chunk );
+    }
+    if( eof >= len )
+      break;
+    i = eof + 1;
+
+    if( walker->overlong ){
+      walker->overlong = walker->open = 0;
+      walker->length = 0;
+      walker->dropped++;
+      continue;
+    }
+    // Two limiters in a row, the second one opens the segment
+    if( !walker->length )
+      continue;
+    // A limiter corrupted inside a body cut it short, the real segment might start at this EOF
+    if( check && E22900T22S_SEGMENT_RESYNC == check( stage, walker->body, walker->length ) ){
+      walker->length = 0;
+      continue;
+    }
+
+    walker->open = 0;
+    if( rssi ){
+      walker->awaiting = 1;
+      continue;
+    }
+    int8_t ret = handler( stage, walker->body, walker->length, 0, 0, out, &length, size );
+    walker->length = 0;
+    if( -1 == ret )
+      return 0;
+  }
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
\ No newline at end of file
@@ -0,0 +1,283 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      e22900t22s_trace.c
+ * 
+ * @version   1.0
+ *
+ * @date      16-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *  
+ * @author    Fábio D. Pacheco, 
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ * 
+ * @note      Manuals:
+ * 
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/trace.h>
+#include <e22900t22s/core.h>
+#include <e22900t22s/airtime.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+void trace_pid_reset( void );
+void trace_stop( int signum );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+static pid_t                 trace_pid = 0;        // Cached pid of the producer, getpid( ) is a system call on every call
+static pid_t                 trace_owner = 0;      // Process that forked the drain
+static volatile sig_atomic_t trace_running = 0;    // Cleared by SIGTERM in the drain process
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+trace_pid_reset( void ){
+  trace_pid = 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+trace_stop( int signum ){
+  (void) signum;
+  trace_running = 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+e22900t22s_trace_t *
+e22900t22s_trace_init( const e22900t22s_trace_level_t level ){
+  e22900t22s_trace_t * trace = (e22900t22s_trace_t *) mmap( NULL, sizeof( e22900t22s_trace_t ), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0 );
+  if( MAP_FAILED == trace )
+    return NULL;
+
+  memset( trace, 0, sizeof( e22900t22s_trace_t ) );
+  trace->level = level;
+  for( uint32_t i = 0 ; i < E22900T22S_TRACE_SLOTS ; ++i )
+    trace->slot[i].seq = i;
+
+  static uint8_t registered = 0;
+  if( !registered ){
+    if( 0 != pthread_atfork( NULL, NULL, trace_pid_reset ) ){
+      munmap( trace, sizeof( e22900t22s_trace_t ) );
+      errno = ENOMEM;
+      return NULL;
+    }
+    registered = 1;
+  }
+  return trace;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+e22900t22s_trace( e22900t22s_trace_t * trace, const e22900t22s_trace_level_t level, const e22900t22s_trace_event_t event, const uint16_t index,
+                  const float Pr, const float SNR, const float No, const uint32_t counter ){
+  if( !trace || (uint32_t) level > __atomic_load_n( &trace->level, __ATOMIC_RELAXED ) )
+    return;
+
+  struct timespec ts;
+  clock_gettime( CLOCK_REALTIME, &ts );
+  if( !trace_pid )
+    trace_pid = getpid( );
+
+  // Bounded multi-producer queue, the slot sequence equals the position when it is free to be claimed
+  e22900t22s_trace_slot_t * slot;
+  uint32_t pos = __atomic_load_n( &trace->head, __ATOMIC_RELAXED );
+  for( ;; ){
+    slot = &trace->slot[ pos & ( E22900T22S_TRACE_SLOTS - 1 ) ];
+    int32_t diff = (int32_t) ( __atomic_load_n( &slot->seq, __ATOMIC_ACQUIRE ) - pos );
+    if( 0 == diff ){
+      if( __atomic_compare_exchange_n( &trace->head, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+        break;
+    }
+    else if( 0 > diff ){
+      __atomic_fetch_add( &trace->dropped, 1, __ATOMIC_RELAXED );
+      return;
+    }
+    else
+      pos = __atomic_load_n( &trace->head, __ATOMIC_RELAXED );
+  }
+
+  slot->record.ts = (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+  slot->record.pid = (int32_t) trace_pid;
+  slot->record.event = (uint16_t) event;
+  slot->record.index = index;
+  slot->record.Pr = Pr;
+  slot->record.SNR = SNR;
+  slot->record.No = No;
+  slot->record.counter = counter;
+  __atomic_store_n( &slot->seq, pos + 1, __ATOMIC_RELEASE );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t
+e22900t22s_trace_drain( e22900t22s_trace_t * trace, FILE * stream ){
+  if( !trace || !stream )
+    return 0;
+
+  static uint32_t dropped = 0;
+  uint32_t n = 0;
+  uint32_t pos = trace->tail;
+
+  for( ;; ){
+    e22900t22s_trace_slot_t * slot = &trace->slot[ pos & ( E22900T22S_TRACE_SLOTS - 1 ) ];
+    if( 0 > (int32_t) ( __atomic_load_n( &slot->seq, __ATOMIC_ACQUIRE ) - ( pos + 1 ) ) )
+      break;
+
+    e22900t22s_trace_record_t record = slot->record;
+    __atomic_store_n( &slot->seq, pos + E22900T22S_TRACE_SLOTS, __ATOMIC_RELEASE );
+    pos ++;
+    n ++;
+
+    char tm[12];
+    struct tm info;
+    time_t sec = (time_t) ( record.ts / 1000000000ULL );
+    localtime_r( &sec, &info );
+    strftime( tm, sizeof(tm), "%H:%M:%S", &info );
+
+    switch( record.event ){
+      case E22900T22S_TRACE_SENT:
+        fprintf( stream, "[%d][%s] Sent: %u (#)\n", record.pid, tm, record.counter );
+        break;
+      case E22900T22S_TRACE_RECEIVED:
+        fprintf( stream, "[%d][%s] Received: %u (#)\n", record.pid, tm, record.counter );
+        break;
+      case E22900T22S_TRACE_SAMPLE:
+        fprintf( stream, "[%d][%s][sample: %u] Pr: %3.2f [dBm], No: %3.2f [dBm], SNR: %3.2f\n", record.pid, tm, record.index, (double) record.Pr,
+                 (double) record.No, (double) record.SNR );
+        break;
+      case E22900T22S_TRACE_NOISE:
+        if( !record.index )
+          fprintf( stream, "[%d][%s] Noise floor: %3.2f [dBm]\n", record.pid, tm, (double) record.No );
+        else
+          fprintf( stream, "[%d][%s] Noise floor: %3.2f [dBm], sample: %3.2f [dBm], network halted: %u [us], next in: %u [s]\n", record.pid, tm,
+                   (double) record.No, (double) record.Pr, record.counter, record.index );
+        break;
+      case E22900T22S_TRACE_ERRNO:
+        fprintf( stream, "[%d][%s] Error: %s\n", record.pid, tm, strerror( (int) record.counter ) );
+        break;
+      case E22900T22S_TRACE_STARTUP:
+        fprintf( stream, "[%d][%s] Startup: EEPROM %s in %u [us]\n", record.pid, tm, record.index ? "programmed" : "verified", record.counter );
+        break;
+      case E22900T22S_TRACE_ADAPT:
+        if( !record.counter )
+          fprintf( stream, "[%d][%s] Adapt: air rate: %s [bps], packet: %s [B], SNR: %3.2f\n", record.pid, tm,
+                   lut_airrate[ ( record.index >> 8 ) & ( E22900T22S_LUT_SIZE_AIRRATE - 1 ) ].text, lut_packetsize[ record.index & ( E22900T22S_LUT_SIZE_PACKET - 1 ) ].text,
+                   (double) record.SNR );
+        else
+          fprintf( stream, "[%d][%s] Adapt: sent %c, epoch: %u, air rate: %s [bps], packet: %s [B]\n", record.pid, tm, (char) ( record.counter >> 8 ), record.counter & 0xFF,
+                   lut_airrate[ ( record.index >> 8 ) & ( E22900T22S_LUT_SIZE_AIRRATE - 1 ) ].text, lut_packetsize[ record.index & ( E22900T22S_LUT_SIZE_PACKET - 1 ) ].text );
+        break;
+      case E22900T22S_TRACE_CODEC:
+        fprintf( stream, "[%d][%s] Codec: %s %u [B] to %.0f [B], ratio: %.2f, cpu: %u [ns]\n", record.pid, tm, record.SNR > 0 ? "coded" : "expanded", record.index,
+                 (double) record.Pr, record.index ? (double) record.Pr / record.index : 0.0, record.counter );
+        break;
+      case E22900T22S_TRACE_ARQ:
+        fprintf( stream, "[%d][%s] ARQ: sent again %u segments, timeout: %.1f [ms], given up: %u\n", record.pid, tm, record.index, (double) record.Pr, record.counter );
+        break;
+      case E22900T22S_TRACE_DUTY:{
+        const e22900t22s_subband_t * band = e22900t22s_subband_info( (uint8_t) record.index );
+        fprintf( stream, "[%d][%s] Duty cycle: sub-band %s, held: %u [us], air time: %.1f [ms]\n", record.pid, tm, band ? band->name : "?", record.counter,
+                 (double) record.Pr );
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  trace->tail = pos;
+
+  uint32_t lost = __atomic_load_n( &trace->dropped, __ATOMIC_RELAXED );
+  if( lost != dropped ){
+    fprintf( stream, "[%d] Trace ring full, %u records dropped so far\n", getpid( ), lost );
+    dropped = lost;
+  }
+  return n;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_trace_start( e22900t22s_trace_t * trace, FILE * stream ){
+  if( !trace || !stream ){
+    errno = EINVAL;
+    return -1;
+  }
+  if( E22900T22S_TRACE_OFF == trace->level )
+    return 1;
+
+  fflush( stream );
+  pid_t parent = getpid( );
+  pid_t pid = fork( );
+  if( -1 == pid )
+    return -1;
+
+  if( 0 == pid ){
+    trace_running = 1;
+    signal( SIGTERM, trace_stop );
+    prctl( PR_SET_PDEATHSIG, SIGTERM );
+    if( parent != getppid( ) )
+      _exit( 0 );
+
+    while( trace_running ){
+      if( !e22900t22s_trace_drain( trace, stream ) )
+        usleep( E22900T22S_TRACE_IDLE_US );
+      fflush( stream );
+    }
+    e22900t22s_trace_drain( trace, stream );
+    fflush( stream );
+    _exit( 0 );
+  }
+
+  trace->drain = pid;
+  trace_owner = parent;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+e22900t22s_trace_close( e22900t22s_trace_t * trace ){
+  if( !trace ){
+    errno = EINVAL;
+    return -1;
+  }
+
+  // Only the process that forked the drain can reap it, the others just drop their mapping
+  if( 0 < trace->drain && getpid( ) == trace_owner ){
+    kill( trace->drain, SIGTERM );
+    waitpid( trace->drain, NULL, 0 );
+    trace->drain = 0;
+  }
+
+  return (int8_t) munmap( trace, sizeof( e22900t22s_trace_t ) );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
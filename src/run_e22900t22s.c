@@ -4,30 +4,63 @@
 #include <string.h>
 #include <sys/mman.h>
 #include <errno.h>
+#include <math.h>
 
 #include <e22900t22s/core.h>
+#include <e22900t22s/adapt.h>
+#include <e22900t22s/airtime.h>
+#include <e22900t22s/config.h>
+#include <e22900t22s/crc.h>
+#include <e22900t22s/codec.h>
+#include <e22900t22s/rohc.h>
+#include <e22900t22s/fec.h>
+#include <e22900t22s/arq.h>
 #include <e22900t22s/metrics.h>
 #include <e22900t22s/mixip.h>
+#include <e22900t22s/pipeline.h>
+#include <e22900t22s/trace.h>
 
 e22900t22s_t      driver;
 e22900t22s_log_t  * logs; 
+e22900t22s_trace_t * trace;            // Binary records of the data path, formatted by the drain process
+e22900t22s_metrics_ring_t * metrics;   // Per packet history for external monitors, written only by the reader process
+e22900t22s_noise_t noise;              // Noise floor tracker, updated only by the loop process
+uint32_t noise_next;                   // When the loop process samples the noise again (s)
+e22900t22s_adapt_t * adapt;            // Rate controller shared by the reader and the loop processes, NULL if disabled
+uint32_t adapt_next;                   // When the loop process runs the rate controller again (s)
+uint32_t adapt_seen;                   // Last setting of the loop process this process took
+e22900t22s_arq_t * arq;                // Selective repeat shared by the writer, the reader and the loop processes, NULL if disabled
+e22900t22s_mixip_t translator;         // Translator connection, aligned again with the radio when it changes
+uint8_t transmitter;                   // The driver updates the translator
+e22900t22s_transmit_t * transmit;      // Duty cycle and module buffer shared by the writer and the loop processes, every write is charged
+
+e22900t22s_mixip_segments_t segments;  // Private to the reader process, the segments array is grown on its heap
+size_t open_length;                    // Bytes of the segment still open at the end of the previous buffer
+size_t pending_length;                 // Length of the segment whose RSSI byte is the first of the next buffer
+uint8_t pending_control;               // That segment is a control frame, its RSSI byte is taken out with it
+e22900t22s_crc_state_t crc;            // Segment checks, the writer process seals and the reader process checks
+uint8_t * sealed;                      // Segments with their CRC trailers, or the checked ones, grown on the heap of each process
+size_t sealed_size;
+e22900t22s_codec_t codec;              // Segment coder, each process keeps its own statistics
+uint8_t * coded;                       // Coded segments of the writer process, or expanded ones of the reader process
+size_t coded_size;
+e22900t22s_rohc_t rohc;                // IPv4/UDP header contexts, the writer process compresses and the reader process restores
+uint8_t * stripped;                    // Segments with their headers compressed, or restored, grown on the heap of each process
+size_t stripped_size;
+e22900t22s_fec_t fec;                  // Blocks of the writer process, and the ones the reader process gathers
+uint8_t * blocked;                     // Segments in their blocks with the repairs, or the sources handed over, grown on the heap of each process
+size_t blocked_size;
+uint8_t * sequenced;                   // Segments with their sequence numbers, or the ones handed in order, grown on the heap of each process
+size_t sequenced_size;
 
 /**************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 const char *
 gettime( void ){
-  time_t t;
-  struct tm * info;
-  time( &t );
-  info = localtime( &t );
-  
-  const uint8_t len = 12;
-  char * tm = malloc( len ); 
-  if( !tm ){
-    perror("malloc");
-    return NULL;
-  }
-
-  strftime( tm, len, "%H:%M:%S", info );
+  static char tm[12];
+  struct tm info;
+  time_t t = time( NULL );
+  localtime_r( &t, &info );
+  strftime( tm, sizeof(tm), "%H:%M:%S", &info );
   return tm;
 }
 
@@ -55,27 +88,24 @@ printPacket( const uint8_t * pk, const size_t len, const char * cover, int colum
 int 
 dsetup( serial_manager_t * serial, const char * name ){
   driver.serial = serial;
-  e22900t22s_eeprom_t eeprom;
-  e22900t22s_pinmode_t pinout;
-  e22900t22s_mixip_t translator;
+  e22900t22s_config_t config;
 
   printf("[%d] Setup on %s ...\n", getpid( ), getenv(name) );
 
-  int8_t ret = e22900t22s_load_config( getenv(name), &eeprom, &pinout );
+  int8_t ret = e22900t22s_load( getenv(name), &config );
   if( -1 == ret ){
     printf("[%d] ", getpid( ));
-    perror("Load XML configuration [e22900t22s_load_config]");
+    perror("Load XML configuration [e22900t22s_load]");
     return -1;
   }
-  
-  ret = e22900t22s_load_mixip_config( getenv(name), &translator );
-  if( -1 == ret ){
-    printf("[%d] ", getpid( ));
-    perror("Load XML configuration [e22900t22s_load_mixip_config]");
-    return -1;
+
+  // The rate controller steers by the SNR of every packet, without the RSSI byte it would see the next SOF as a -128 dBm packet
+  if( config.adapt && !config.eeprom.rssi ){
+    config.eeprom.rssi = 1;
+    printf("[%d] The rate controller needs the RSSI byte, it was switched on\n", getpid( ) );
   }
 
-  ret = e22900t22s_connect_mixip( name, &translator );
+  ret = e22900t22s_connect_mixip( name, &config.translator );
   if( -1 == ret ){
     printf("[%d] ", getpid( ));
     perror("Connect driver to the translator");
@@ -91,8 +121,9 @@ dsetup( serial_manager_t * serial, const char * name ){
 
   switch( ret ){
     case IS_TRANSMITTER:
-      // This driver is a transmitter
-      ret = e22900t22s_update_mixip_config( &translator );
+      // This driver is a transmitter, the translator segments follow the radio packets
+      transmitter = 1;
+      ret = e22900t22s_update_mixip_config( &config.translator, &config.eeprom );
       if( -1 == ret ){
         printf("[%d] ", getpid( ));
         perror("Update the translator from the driver");
@@ -106,33 +137,45 @@ dsetup( serial_manager_t * serial, const char * name ){
       break;      
   }
 
-  ret = e22900t22s_set_pinout( &pinout, &driver );
+  const char * level = getenv( E22900T22S_TRACE_ENV );
+  trace = e22900t22s_trace_init( level ? (e22900t22s_trace_level_t) atoi( level ) : E22900T22S_TRACE_DEBUG );
+  if( !trace ){
+    printf("[%d] ", getpid( ));
+    perror("Initializing trace");
+    return -1;  
+  }
+  if( -1 == e22900t22s_trace_start( trace, stdout ) ){
+    printf("[%d] ", getpid( ));
+    perror("Starting the trace drain");
+    return -1;  
+  }
+
+  ret = e22900t22s_set_pinout( &config.pinout, &driver );
   if( -1 == ret ){
     printf("[%d] ", getpid( ));
     perror("Set the pinout");
     return -1;
   }
     
-  ret = e22900t22s_set_config( &eeprom, 0, &driver );
+  ret = e22900t22s_set_config( &config.eeprom, 0, &driver );
   if( -1 == ret ){
     printf("[%d] ", getpid( ));
     perror("Set the EEPROM configuration");
     return -1;
   }
 
-  ret = e22900t22s_update_eeprom( &driver );
-  if( -1 == ret ){
-    printf("[%d] ", getpid( ));
-    perror("Updating the EEPROM");
-    return -1;
-  }
-
-  ret = e22900t22s_get_config( &driver );
+  // Restarts with the same settings only read the EEPROM, it is programmed on a mismatch
+  struct timespec start, end;
+  clock_gettime( CLOCK_MONOTONIC, &start );
+  ret = e22900t22s_verify_config( &driver );
   if( -1 == ret ){
     printf("[%d] ", getpid( ));
-    perror("Retriving the EEPROM");
+    perror("Updating and retriving the EEPROM");
     return -1;
   }
+  clock_gettime( CLOCK_MONOTONIC, &end );
+  int64_t elapsed = ( (int64_t) end.tv_sec - start.tv_sec ) * 1000000L + ( end.tv_nsec - start.tv_nsec ) / 1000L;
+  e22900t22s_trace( trace, E22900T22S_TRACE_INFO, E22900T22S_TRACE_STARTUP, (uint16_t) ret, 0, 0, 0, (uint32_t) elapsed );
 
   e22900t22s_print_config( 1, &driver );
   printf("[%d] Device configured...\n", getpid( ) );
@@ -145,6 +188,13 @@ dsetup( serial_manager_t * serial, const char * name ){
   }
   memset( logs, 0, sizeof( e22900t22s_log_t ) );
 
+  metrics = e22900t22s_metrics_open( name, 1 );
+  if( !metrics ){
+    printf("[%d] ", getpid( ));
+    perror("Initializing the metrics ring");
+    return -1;  
+  }
+
   if( 0 == (logs->No = e22900t22s_get_noise_rssi( &driver, 1 ) ) ){
     if( ECANCELED == errno ){
       printf("[%d] ", getpid( ));
@@ -152,69 +202,438 @@ dsetup( serial_manager_t * serial, const char * name ){
       return -1;        
     }
   }
-  printf("[%d][%s] Noise floor: %3.2f [dBm]\n", getpid( ), gettime( ), logs->No );    
+  translator = config.translator;
+  e22900t22s_codec_init( &codec );
+  e22900t22s_rohc_init( &rohc );
+  if( translator.fec_repairs && -1 == e22900t22s_fec_init( &fec, translator.fec_block, translator.fec_repairs ) ){
+    printf("[%d] ", getpid( ));
+    perror("e22900t22s_fec_init");
+    return -1;
+  }
+  e22900t22s_fec_tune( &fec, &driver.cfg );
+  if( translator.compress && translator.dictionary[0] && -1 == e22900t22s_codec_dictionary( &codec, translator.dictionary ) ){
+    printf("[%d] ", getpid( ));
+    perror("Loading the codec dictionary");
+    return -1;
+  }
+  transmit = (e22900t22s_transmit_t *) mmap( NULL, sizeof( e22900t22s_transmit_t ), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0 );
+  if( MAP_FAILED == transmit ){
+    transmit = NULL;
+    printf("[%d] ", getpid( ));
+    perror("Initializing the transmit state");
+    return -1;  
+  }
+  clock_gettime( CLOCK_MONOTONIC, &start );
+  if( -1 == e22900t22s_transmit_init( transmit, E22900T22S_MODULE_BUFFER, (uint64_t) start.tv_sec * 1000000000ULL + (uint64_t) start.tv_nsec ) ){
+    printf("[%d] ", getpid( ));
+    perror("e22900t22s_transmit_init");
+    return -1;  
+  }
+  e22900t22s_noise_init( &noise, logs->No );
+  e22900t22s_trace( trace, E22900T22S_TRACE_INFO, E22900T22S_TRACE_NOISE, 0, 0, 0, logs->No, 0 );
+
+  if( config.adapt ){
+    adapt = (e22900t22s_adapt_t *) mmap( NULL, sizeof( e22900t22s_adapt_t ), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0 );
+    if( MAP_FAILED == adapt ){
+      adapt = NULL;
+      printf("[%d] ", getpid( ));
+      perror("Initializing the rate controller");
+      return -1;  
+    }
+    if( -1 == e22900t22s_adapt_init( adapt, &driver.cfg ) ){
+      printf("[%d] ", getpid( ));
+      perror("e22900t22s_adapt_init");
+      return -1;  
+    }
+  }
+
+  if( translator.arq ){
+    arq = (e22900t22s_arq_t *) mmap( NULL, sizeof( e22900t22s_arq_t ), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0 );
+    if( MAP_FAILED == arq ){
+      arq = NULL;
+      printf("[%d] ", getpid( ));
+      perror("Initializing the ARQ");
+      return -1;  
+    }
+    if( -1 == e22900t22s_arq_init( arq, &driver.cfg, E22900T22S_MODULE_BUFFER ) ){
+      printf("[%d] ", getpid( ));
+      perror("e22900t22s_arq_init");
+      return -1;  
+    }
+  }
 
   return 0; 
 }
  
+/**************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+grow( uint8_t ** buffer, size_t * capacity, const size_t size ){
+  if( size <= *capacity )
+    return 0;
+  uint8_t * grown = (uint8_t *) realloc( *buffer, size );
+  if( !grown ){
+    perror("realloc");
+    return -1;
+  }
+  *buffer = grown;
+  *capacity = size;
+  return 0;
+}
+
+/**************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+hold( const uint64_t wait ){
+  struct timespec left = { .tv_sec = (time_t) ( wait / 1000000 ), .tv_nsec = (long) ( wait % 1000000 ) * 1000L };
+  while( -1 == nanosleep( &left, &left ) && EINTR == errno );
+}
+
+/**************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+loop_write( const uint8_t * out, const size_t length ){
+  // The writer process is halted, the loop process pays the same duty cycle and fills the same module buffer
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  uint64_t ns = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+  uint64_t airtime;
+  uint64_t wait = e22900t22s_transmit_reserve( transmit, &driver.cfg, length, ns, &airtime );
+  if( wait ){
+    e22900t22s_trace( trace, E22900T22S_TRACE_INFO, E22900T22S_TRACE_DUTY, e22900t22s_subband( driver.cfg.channel ), (float) airtime / 1000.0f, 0, 0,
+                      wait > UINT32_MAX ? UINT32_MAX : (uint32_t) wait );
+    hold( wait );
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    ns = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+  }
+  wait = e22900t22s_transmit_room( transmit, &driver.cfg, length, ns );
+  if( wait ){
+    hold( wait );
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    ns = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+  }
+  e22900t22s_transmit_push( transmit, &driver.cfg, length, 0, ns );
+
+  if( length != serial_write( &driver.serial->sr, out, length ) || -1 == serial_flush( &driver.serial->sr ) )
+    return -1;
+  return 0;
+}
+
+/**************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+track_noise( flow_t * flow ){
+  // The RSSI register is read over the data UART, so the network only stops for the read
+  struct timespec start, end;
+  clock_gettime( CLOCK_MONOTONIC, &start );
+  mixip_halt( flow );
+  float sample = e22900t22s_get_noise_rssi( &driver, 1 );
+  int error = errno;
+  mixip_continue( flow );
+  clock_gettime( CLOCK_MONOTONIC, &end );
+
+  if( 0 == sample && ECANCELED == error ){
+    e22900t22s_trace( trace, E22900T22S_TRACE_ERROR, E22900T22S_TRACE_ERRNO, 0, 0, 0, 0, (uint32_t) error );
+    return;
+  }
+
+  int64_t halted = ( (int64_t) end.tv_sec - start.tv_sec ) * 1000000L + ( end.tv_nsec - start.tv_nsec ) / 1000L;
+  float No = e22900t22s_noise_update( &noise, sample );
+  e22900t22s_noise_publish( logs, No );
+  e22900t22s_trace( trace, E22900T22S_TRACE_INFO, E22900T22S_TRACE_NOISE, noise.interval, sample, 0, No, (uint32_t) halted );
+}
+
+/**************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+adapt_rate( flow_t * flow, const uint32_t now ){
+  e22900t22s_adapt_msg_t msg;
+  uint8_t action = e22900t22s_adapt_step( adapt, now, &msg );
+  if( !action )
+    return;
+
+  mixip_halt( flow );
+  if( action & E22900T22S_ADAPT_SEND ){
+    uint8_t frame[ E22900T22S_ADAPT_FRAME ];
+    uint8_t marked[ E22900T22S_ADAPT_FRAME + E22900T22S_ROHC_HEADER ];
+    uint8_t packed[ E22900T22S_ADAPT_FRAME + E22900T22S_ROHC_HEADER + E22900T22S_CODEC_HEADER ];
+    uint8_t plain[ E22900T22S_ADAPT_FRAME + E22900T22S_ROHC_HEADER + E22900T22S_CODEC_HEADER + 2 ];
+    uint8_t trailed[ E22900T22S_ADAPT_FRAME + E22900T22S_ROHC_HEADER + E22900T22S_CODEC_HEADER + 2 + E22900T22S_CRC_TRAILER ];
+    e22900t22s_adapt_frame( &msg, frame );
+
+    // The peer restores, expands and checks every segment, the control frames too
+    const uint8_t * out = frame;
+    size_t length = sizeof(frame);
+    if( translator.rohc ){
+      length = e22900t22s_rohc_pack( &rohc, out, length, marked, sizeof(marked) );
+      out = marked;
+    }
+    if( translator.compress ){
+      length = e22900t22s_codec_pack( &codec, out, length, packed, sizeof(packed) );
+      out = packed;
+    }
+    // The blocks belong to the writer process, the frame goes outside them
+    if( translator.fec_repairs ){
+      length = e22900t22s_fec_plain( &fec, out, length, plain, sizeof(plain) );
+      out = plain;
+    }
+    if( translator.crc ){
+      length = e22900t22s_crc_seal( &crc, out, length, trailed, sizeof(trailed) );
+      out = trailed;
+    }
+
+    // The frame has to be on the air before the module is reconfigured
+    if( -1 == loop_write( out, length ) || -1 == e22900t22s_while_busy( 100, &driver ) )
+      e22900t22s_trace( trace, E22900T22S_TRACE_ERROR, E22900T22S_TRACE_ERRNO, 0, 0, 0, 0, (uint32_t) errno );
+    else
+      e22900t22s_trace( trace, E22900T22S_TRACE_INFO, E22900T22S_TRACE_ADAPT, (uint16_t) ( msg.airrate << 8 | msg.packet ), 0, 0, 0,
+                        (uint32_t) msg.type << 8 | msg.epoch );
+  }
+
+  if( action & E22900T22S_ADAPT_APPLY ){
+    // Only the volatile registers are written, a restart goes back to the configuration file
+    e22900t22s_set_airrate( lut_airrate[ adapt->airrate ].code, &driver );
+    e22900t22s_set_packet_size( lut_packetsize[ adapt->packet ].code, &driver );
+    if( -1 == e22900t22s_update_temporary( &driver ) || ( transmitter && -1 == e22900t22s_update_mixip_config( &translator, &driver.cfg ) ) )
+      e22900t22s_trace( trace, E22900T22S_TRACE_ERROR, E22900T22S_TRACE_ERRNO, 0, 0, 0, 0, (uint32_t) errno );
+    else{
+      float snr;
+      if( arq )
+        e22900t22s_arq_tune( arq, &driver.cfg );
+      e22900t22s_adapt_publish( adapt );
+      __atomic_load( &adapt->snr, &snr, __ATOMIC_ACQUIRE );
+      e22900t22s_trace( trace, E22900T22S_TRACE_INFO, E22900T22S_TRACE_ADAPT, (uint16_t) ( adapt->airrate << 8 | adapt->packet ), 0, snr, 0, 0 );
+    }
+  }
+  mixip_continue( flow );
+}
+
+/**************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+repeat( flow_t * flow, const uint64_t now ){
+  // Half the module buffer per tick, the writer keeps feeding it meanwhile
+  uint8_t polled[ E22900T22S_MODULE_BUFFER / 2 ];
+  uint8_t plain[ sizeof(polled) * 3 ];
+  uint8_t trailed[ sizeof(polled) * 3 ];
+
+  // A gap held too long is given up here, the reader hands the segments after it with its next buffer
+  e22900t22s_arq_expire( arq, driver.cfg.rssi, now );
+
+  // Nothing is taken while the duty cycle cannot pay for a full tick, the acknowledgement and the timeouts wait for a later one
+  if( e22900t22s_transmit_budget( transmit, &driver.cfg, now ) < e22900t22s_airtime( &driver.cfg, sizeof(trailed), NULL ) )
+    return;
+
+  uint32_t resent = arq->resent;
+  uint32_t abandoned;
+  size_t length = e22900t22s_arq_poll( arq, now, polled, sizeof(polled), &abandoned );
+  resent = arq->resent - resent;
+  logs->n_acked = arq->acked;
+  logs->n_resent = arq->resent;
+  logs->n_abandoned = arq->abandoned;
+  if( !length ){
+    if( abandoned )
+      e22900t22s_trace( trace, E22900T22S_TRACE_INFO, E22900T22S_TRACE_ARQ, 0, (float) arq->rto / 1e6f, 0, 0, abandoned );
+    return;
+  }
+
+  // The blocks belong to the writer process, the acknowledgement and the segments sent again go outside them
+  const uint8_t * out = polled;
+  if( translator.fec_repairs ){
+    length = e22900t22s_fec_plain( &fec, out, length, plain, sizeof(plain) );
+    out = plain;
+  }
+  if( translator.crc ){
+    length = e22900t22s_crc_seal( &crc, out, length, trailed, sizeof(trailed) );
+    out = trailed;
+  }
+
+  mixip_halt( flow );
+  if( -1 == loop_write( out, length ) )
+    e22900t22s_trace( trace, E22900T22S_TRACE_ERROR, E22900T22S_TRACE_ERRNO, 0, 0, 0, 0, (uint32_t) errno );
+  else if( resent || abandoned )
+    e22900t22s_trace( trace, E22900T22S_TRACE_INFO, E22900T22S_TRACE_ARQ, (uint16_t) resent, (float) arq->rto / 1e6f, 0, 0, abandoned );
+  mixip_continue( flow );
+}
+
 /**************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int 
 dloop( flow_t * flow ){
-  // Runs in loop, in a separeted process, consider limiting the CPU poll with a sleep...
-  // To stop the other process (read/write) use halt_network( flow ), and continue_network( flow )
-  
-  sleep( 10 );
- 
-  /*
-  mixip_halt( flow );  
-  printf("[%d][%s] Past: %3.2f [dBm], Current: %3.2f [dBm]\n", getpid( ), gettime( ), rssi.past, rssi.current );    
-  mixip_continue( flow );
-  */
+  // Runs in loop, in a separeted process, it tracks the noise floor used by dread for the SNR, runs the rate controller, and acknowledges and sends again for the ARQ
+  if( arq ){
+    struct timespec tick = { .tv_sec = 0, .tv_nsec = E22900T22S_ARQ_TICK * 1000000L };
+    while( -1 == nanosleep( &tick, &tick ) && EINTR == errno );
+  }
+  else
+    sleep( adapt ? E22900T22S_ADAPT_TICK : noise.interval );
+
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  if( (uint32_t) now.tv_sec >= noise_next ){
+    track_noise( flow );
+    noise_next = (uint32_t) now.tv_sec + noise.interval;
+  }
+
+  if( adapt && (uint32_t) now.tv_sec >= adapt_next ){
+    adapt_rate( flow, (uint32_t) now.tv_sec );
+    adapt_next = (uint32_t) now.tv_sec + E22900T22S_ADAPT_TICK;
+  }
+
+  if( arq )
+    repeat( flow, (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec );
   return 0; 
 }
  
 /**************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int 
 dread( buffer_t * buf ){
-  // Clear the previous samples
-  memset( logs->sample, 0, sizeof( e22900t22s_rx_metric_t ) * NSEG_MAX );
-  logs->n_samples = 0;
-  uint8_t extra_sample = 0;
+  // The loop process switches the module, the checks below run on the setting it applied
+  if( adapt && e22900t22s_adapt_refresh( adapt, &adapt_seen, &driver.cfg ) && translator.fec_repairs )
+    e22900t22s_fec_tune( &fec, &driver.cfg );
 
   // If first is set it means the previous buffer had the last byte being EOF, so now the first byte of buf->data is 100% the RSSI  
-  if( logs->tmp.first ){
-    logs->sample[0].Pr = e22900t22s_get_signal_rssi( buf->data[0] );
-    logs->sample[0].SNR = logs->sample[0].Pr - logs->No;
-    extra_sample = 1;
-    printf("[%d][%s] Pr: %3.2f [dBm], No: %3.2f [dBm], SNR: %3.2f\n", getpid( ), gettime( ), logs->sample[0].Pr, logs->No ,logs->sample[0].SNR  );          
-  }
-  
-  if( -1 == e22900t22s_identify_segments( buf->data, buf->len, &logs->tmp ) ){
+  uint8_t carried = segments.first;
+
+  // Corrupted segments are removed before anything else looks at them
+  if( translator.crc ){
+    if( -1 == grow( &sealed, &sealed_size, e22900t22s_crc_bound( &crc, buf->len ) ) )
+      return -1;
+    buf->len = e22900t22s_crc_verify( &crc, buf->data, buf->len, driver.cfg.rssi, sealed, sealed_size );
+    buf->data = sealed;
+    logs->n_dropped = crc.dropped;
+    // The ARQ may still have segments to hand over, let go by the loop process
+    if( !buf->len && !arq )
+      return 0;
+  }
+
+  // The lost segments are rebuilt before the codec, it only sees whole segments
+  if( translator.fec_repairs ){
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    if( -1 == grow( &blocked, &blocked_size, e22900t22s_fec_bound( &fec, buf->len ) ) )
+      return -1;
+    buf->len = e22900t22s_fec_unpack( &fec, buf->data, buf->len, driver.cfg.rssi, (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec,
+                                      blocked, blocked_size );
+    buf->data = blocked;
+    logs->n_recovered = fec.recovered;
+    if( !buf->len && !arq )
+      return 0;
+  }
+
+  // The segments go up in order, the acknowledgements of the peer stop here
+  if( arq ){
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    if( -1 == grow( &sequenced, &sequenced_size, e22900t22s_arq_bound( arq, buf->len ) ) )
+      return -1;
+    buf->len = e22900t22s_arq_unpack( arq, buf->data, buf->len, driver.cfg.rssi, (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec,
+                                      sequenced, sequenced_size );
+    buf->data = sequenced;
+    if( !buf->len )
+      return 0;
+  }
+
+  if( translator.compress ){
+    size_t size = e22900t22s_codec_bound( &codec, buf->len );
+    if( -1 == grow( &coded, &coded_size, size ) )
+      return -1;
+    uint64_t cpu = codec.cpu_ns;
+    size_t length = e22900t22s_codec_unpack( &codec, buf->data, buf->len, driver.cfg.rssi, coded, coded_size );
+    e22900t22s_trace( trace, E22900T22S_TRACE_DEBUG, E22900T22S_TRACE_CODEC, (uint16_t) ( buf->len > UINT16_MAX ? UINT16_MAX : buf->len ), (float) length, 0, 0,
+                      (uint32_t) ( codec.cpu_ns - cpu ) );
+    // The translator reads the expanded copy, it stays valid until the next read
+    buf->data = coded;
+    buf->len = length;
+    if( !buf->len )
+      return 0;
+  }
+
+  if( translator.rohc ){
+    if( -1 == grow( &stripped, &stripped_size, e22900t22s_rohc_bound( &rohc, buf->len ) ) )
+      return -1;
+    buf->len = e22900t22s_rohc_unpack( &rohc, buf->data, buf->len, driver.cfg.rssi, stripped, stripped_size );
+    buf->data = stripped;
+    if( !buf->len )
+      return 0;
+  }
+
+  if( -1 == e22900t22s_identify_segments( buf->data, buf->len, &segments ) ){
     printf("[%d] ", getpid( ));
     perror("e22900t22s_identify_segments");
     return -1;      
   }
 
-  logs->n_received += logs->tmp.length + extra_sample;
-  logs->n_samples = logs->tmp.length + extra_sample;
-  if( 0 < logs->n_samples ){
-    if( logs->tmp.first )
-      logs->n_samples --;
-  
-    for( uint8_t i = 0 ; i < logs->n_samples ; ++i ){
-      if( logs->tmp.segment[i].end + 1 < buf->len )
-        logs->sample[i].Pr = e22900t22s_get_signal_rssi( buf->data[ logs->tmp.segment[i].end + 1 ] );        
-      else
-        printf("[%d] sample indicates the RSSI outside the buffer's available space\n", getpid( ));
+  // Each segment is counted once, when its EOF arrives, the RSSI byte after it might only come in the next buffer
+  logs->n_received += (uint32_t) segments.length;
+
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+
+  e22900t22s_rx_metric_t sample;
+  sample.ts = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+  sample.No = e22900t22s_noise_current( logs );
+
+  uint16_t n_samples = 0;
+  size_t cursor = 0;
+  size_t kept = 0;
+  for( size_t i = 0 ; i < segments.length + carried ; ++i ){
+    size_t start = cursor;
+    uint8_t control = 0;
+    size_t rssi;
+    if( carried && !i ){
+      rssi = 0;
+      sample.length = (uint32_t) pending_length;
+      control = pending_control;
+      pending_control = 0;
+    }
+    else{
+      size_t end = segments.segment[ i - carried ].end;
+      sample.length = (uint32_t) ( open_length + end + 1 - cursor );
+
+      // Control frames of the rate controller are whole segments, they are handed to the loop process
+      e22900t22s_adapt_msg_t msg;
+      if( adapt && !open_length && 1 == e22900t22s_adapt_parse( &buf->data[ cursor ], end + 1 - cursor, &msg ) ){
+        e22900t22s_adapt_post( adapt, &msg );
+        control = 1;
+      }
+      open_length = 0;
+      rssi = end + 1;
+    }
+
+    if( !driver.cfg.rssi ){
+      cursor = rssi;                   // Without the RSSI byte the next segment starts right after the EOF, there is nothing to sample
+
+      // Monitors still see every packet, the power and the SNR are unknown rather than the -128 dBm a missing byte would read as
+      sample.Pr = NAN;
+      sample.SNR = NAN;
+      e22900t22s_metrics_push( metrics, &sample );
+    }
+    else if( rssi >= buf->len ){
+      pending_length = sample.length;  // The RSSI byte of the last segment arrives in the next buffer
+      pending_control = control;
+      cursor = buf->len;
     }
-  
-    for( uint8_t i = 0 ; i < logs->n_samples ; ++i )
-      logs->sample[i].SNR = logs->sample[i].Pr - logs->No;
-  
-    for( uint8_t i = 0 ; i < logs->n_samples ; ++i )
-      printf("[%d][%s][sample: %d] Pr: %3.2f [dBm], No: %3.2f [dBm], SNR: %3.2f\n", getpid( ), gettime( ), i, logs->sample[i].Pr, logs->No ,logs->sample[i].SNR  );          
-    printf("[%d][%s] Received: %d (#)\n", getpid( ), gettime( ), logs->n_received );        
+    else{
+      cursor = rssi + 1;
+
+      // A control frame is sampled too, it is how an end hears the peer on a new setting with the link idle
+      sample.Pr = e22900t22s_get_signal_rssi( buf->data[ rssi ] );
+      sample.SNR = sample.Pr - sample.No;
+      if( adapt )
+        e22900t22s_adapt_sample( adapt, sample.SNR );
+      e22900t22s_metrics_push( metrics, &sample );
+      e22900t22s_trace( trace, E22900T22S_TRACE_DEBUG, E22900T22S_TRACE_SAMPLE, n_samples ++, sample.Pr, sample.SNR, sample.No, 0 );
+    }
+
+    // The translator never sees a control frame, the segments after it move down over it, they were already read
+    if( !control ){
+      memmove( &buf->data[ kept ], &buf->data[ start ], cursor - start );
+      kept += cursor - start;
+    }
+  }
+  if( cursor < buf->len ){
+    open_length += buf->len - cursor;
+    memmove( &buf->data[ kept ], &buf->data[ cursor ], buf->len - cursor );
+    kept += buf->len - cursor;
   }
+  buf->len = kept;
+
+  if( 0 < n_samples )
+    e22900t22s_trace( trace, E22900T22S_TRACE_INFO, E22900T22S_TRACE_RECEIVED, 0, 0, 0, 0, logs->n_received );
 
   return 0; 
 }
@@ -222,22 +641,188 @@ dread( buffer_t * buf ){
 /**************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int 
 dwrite( buffer_t * buf ){
+  // The loop process switches the module, the air time, the pipeline and the FEC flush follow the setting it applied
+  if( adapt )
+    e22900t22s_adapt_refresh( adapt, &adapt_seen, &driver.cfg );
+
+  // Every segment takes at least its two limiters, so this is the most segments a buffer can hold
+  size_t segments_max = buf->len / 2 + 1;
+  // A stage holds the segment still open at the end of a write, it comes out whole with the next one
+  size_t held = E22900T22S_SEGMENT_BODY + 2;
+
+  // The headers go first, the codec then works on what is left of every datagram
+  if( translator.rohc ){
+    if( -1 == grow( &stripped, &stripped_size, buf->len + held + segments_max * E22900T22S_ROHC_HEADER ) )
+      return -1;
+    errno = 0;
+    size_t length = e22900t22s_rohc_pack( &rohc, buf->data, buf->len, stripped, stripped_size );
+    if( !length && errno ){
+      perror("e22900t22s_rohc_pack");
+      return -1;
+    }
+    buf->data = stripped;
+    buf->len = length;
+  }
+
+  if( translator.compress ){
+    if( -1 == grow( &coded, &coded_size, buf->len + held + segments_max * E22900T22S_CODEC_HEADER ) )
+      return -1;
+    uint64_t cpu = codec.cpu_ns;
+    errno = 0;
+    size_t length = e22900t22s_codec_pack( &codec, buf->data, buf->len, coded, coded_size );
+    if( !length && errno ){
+      perror("e22900t22s_codec_pack");
+      return -1;
+    }
+    e22900t22s_trace( trace, E22900T22S_TRACE_DEBUG, E22900T22S_TRACE_CODEC, (uint16_t) ( buf->len > UINT16_MAX ? UINT16_MAX : buf->len ), (float) length, 1, 0,
+                      (uint32_t) ( codec.cpu_ns - cpu ) );
+    buf->data = coded;
+    buf->len = length;
+  }
+
+  // A full window holds the writer until the peer acknowledges, or the loop process gives the oldest segments up
+  if( arq ){
+    uint64_t wait;
+    while( ( wait = e22900t22s_arq_wait( arq, buf->data, buf->len ) ) ){
+      struct timespec left = { .tv_sec = (time_t) ( wait / 1000000000ULL ), .tv_nsec = (long) ( wait % 1000000000ULL ) };
+      while( -1 == nanosleep( &left, &left ) && EINTR == errno );
+    }
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    if( -1 == grow( &sequenced, &sequenced_size, buf->len + held + segments_max * E22900T22S_ARQ_HEADER ) )
+      return -1;
+    errno = 0;
+    size_t length = e22900t22s_arq_pack( arq, buf->data, buf->len, (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec, sequenced, sequenced_size );
+    if( !length && errno ){
+      perror("e22900t22s_arq_pack");
+      return -1;
+    }
+    buf->data = sequenced;
+    buf->len = length;
+  }
+
+  // A block stays open across writes while the module has data queued, with the link idle it closes so its repairs go now
+  if( translator.fec_repairs ){
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    uint64_t ns = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+    uint8_t flush = 0 == e22900t22s_transmit_queued( transmit, &driver.cfg, ns );
+    if( -1 == grow( &blocked, &blocked_size, e22900t22s_fec_pack_bound( &fec, buf->len ) ) )
+      return -1;
+    errno = 0;
+    size_t length = e22900t22s_fec_pack( &fec, buf->data, buf->len, flush, blocked, blocked_size );
+    if( !length && errno ){
+      perror("e22900t22s_fec_pack");
+      return -1;
+    }
+    buf->data = blocked;
+    buf->len = length;
+  }
+
+  if( translator.crc ){
+    if( -1 == grow( &sealed, &sealed_size, e22900t22s_crc_bound( &crc, buf->len ) ) )
+      return -1;
+    errno = 0;
+    size_t length = e22900t22s_crc_seal( &crc, buf->data, buf->len, sealed, sealed_size );
+    if( !length && errno ){
+      perror("e22900t22s_crc_seal");
+      return -1;
+    }
+    // The translator writes the sealed copy, it stays valid until the next write
+    buf->data = sealed;
+    buf->len = length;
+  }
+
+  // Every segment is still open, nothing goes on the air until a later write closes one
+  if( !buf->len )
+    return 0;
+
   logs->n_sent++;
-  printf("[%d][%s] Sent: %d (#)\n", getpid( ), gettime( ), logs->n_sent );        
+  e22900t22s_trace( trace, E22900T22S_TRACE_INFO, E22900T22S_TRACE_SENT, 0, 0, 0, 0, logs->n_sent );
 
-  if( -1 == e22900t22s_while_busy( 100, &driver ) ){
-    perror("e22900t22s_while_busy");
-    return -1;
+  // The air time is charged to the sub-band, the next write waits until the bucket is paid back
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  uint64_t ns = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+  uint64_t airtime;
+  uint64_t wait = e22900t22s_transmit_reserve( transmit, &driver.cfg, buf->len, ns, &airtime );
+  if( wait ){
+    logs->n_held++;
+    logs->held_ms += (uint32_t) ( wait / 1000 );
+    e22900t22s_trace( trace, E22900T22S_TRACE_INFO, E22900T22S_TRACE_DUTY, e22900t22s_subband( driver.cfg.channel ), (float) airtime / 1000.0f, 0, 0,
+                      wait > UINT32_MAX ? UINT32_MAX : (uint32_t) wait );
+    hold( wait );
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    ns = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
   }
+
+  // The UART keeps feeding the module while it transmits, the writer only stops when the next write would not fit in its buffer
+  int8_t busy = e22900t22s_is_busy( &driver );
+  if( -1 == busy )
+    return -1;
+  e22900t22s_transmit_push( transmit, &driver.cfg, buf->len, !busy, ns );
+
+  // The next write is expected to be as long as this one
+  wait = e22900t22s_transmit_room( transmit, &driver.cfg, buf->len, ns );
+  if( wait )
+    hold( wait );
   return 0; 
 }
 
 /**************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
 int 
 dexit( void ){
+  printf("[%d] Mode switches: %u, elided: %u\n", getpid( ), driver.state.switches, driver.state.elided );
+  if( driver.aux.events && driver.aux.wakes )
+    printf("[%d] AUX wake latency, wakes: %u, last: %u [ns], average: %llu [ns], max: %u [ns]\n", getpid( ), driver.aux.wakes, driver.aux.last_ns,
+           (unsigned long long) ( driver.aux.total_ns / driver.aux.wakes ), driver.aux.max_ns );
+  const e22900t22s_duty_t * duty = transmit ? &transmit->duty : NULL;
+  const e22900t22s_pipeline_t * pipeline = transmit ? &transmit->pipeline : NULL;
+  if( duty && duty->airtime )
+    printf("[%d] Air time: %llu [ms], held by the duty cycle: %u times, %llu [ms]\n", getpid( ), (unsigned long long) ( duty->airtime / 1000 ), duty->held,
+           (unsigned long long) ( duty->delayed / 1000 ) );
+  if( pipeline && pipeline->bytes ){
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    float ratio;
+    float goodput = e22900t22s_pipeline_goodput( pipeline, &driver.cfg, (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec, &ratio );
+    printf("[%d] Goodput: %.0f [bps], %.1f %% of the air rate, stalls: %u, %llu [ms], AUX resyncs: %u\n", getpid( ), (double) goodput, (double) ( ratio * 100.0f ),
+           pipeline->stalls, (unsigned long long) ( pipeline->stalled / 1000 ), pipeline->resyncs );
+  }
+
   if( -1 == e22900t22s_gpio_close( &driver ) ){
     perror("e22900t22s_gpio_close");
     return -1;
   }
+  e22900t22s_free_segments( &segments );
+  free( sealed );
+  free( coded );
+  free( stripped );
+  free( blocked );
+  free( sequenced );
+  if( arq )
+    printf("[%d] ARQ sent: %u, sent again: %u, acknowledged: %u, given up: %u, delivered: %u, skipped: %u, duplicates: %u, acknowledgements: %u, timeout: %llu [ms]\n",
+           getpid( ), arq->sent, arq->resent, arq->acked, arq->abandoned, arq->delivered, arq->skipped, arq->duplicates, arq->acks,
+           (unsigned long long) ( arq->rto / 1000000ULL ) );
+  if( translator.fec_repairs )
+    printf("[%d] FEC sources: %u, repairs: %u, recovered: %u, lost: %u, errors: %u\n", getpid( ), fec.sources, fec.repaired, fec.recovered, fec.lost, fec.errors );
+  if( translator.rohc && rohc.datagrams )
+    printf("[%d] Header compression, datagrams: %u, full headers: %u, segments passed: %u, header: %.1f -> %.1f [B], errors: %u\n", getpid( ), rohc.datagrams,
+           rohc.refreshes, rohc.passed, (double) rohc.headers_in / rohc.datagrams, (double) rohc.headers_out / rohc.datagrams, rohc.errors );
+  if( translator.compress && codec.raw )
+    printf("[%d] Codec segments: %u, stored raw: %u, ratio: %.3f, cpu per segment: %llu [ns]\n", getpid( ), codec.segments, codec.stored,
+           (double) codec.coded / (double) codec.raw, (unsigned long long) ( codec.cpu_ns / codec.segments ) );
+  else if( translator.compress )
+    printf("[%d] Codec expand errors: %u, cpu: %llu [ns]\n", getpid( ), codec.errors, (unsigned long long) codec.cpu_ns );
+  if( translator.crc )
+    printf("[%d] CRC segments passed: %u, dropped: %u\n", getpid( ), crc.passed, crc.dropped );
+  if( metrics && -1 == e22900t22s_metrics_close( metrics, NULL ) ){
+    perror("e22900t22s_metrics_close");
+    return -1;
+  }
+  if( trace && -1 == e22900t22s_trace_close( trace ) ){
+    perror("e22900t22s_trace_close");
+    return -1;
+  }
   return 0;
 }
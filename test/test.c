@@ -0,0 +1,125 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      test.c
+ *
+ * @version   1.0
+ *
+ * @date      17-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *
+ * @author    Fábio D. Pacheco,
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ *
+ * @note      Manuals:
+ *
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include "test.h"
+#include <stdio.h>
+#include <string.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+uint32_t test_failures = 0;
+static uint32_t test_state = 0x2545F491;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t
+test_rand( void ){
+  test_state ^= test_state << 13;
+  test_state ^= test_state >> 17;
+  test_state ^= test_state << 5;
+  return test_state;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+test_stream( uint8_t * out, const size_t size, const uint32_t segments ){
+  size_t length = 0;
+  for( uint32_t k = 0 ; k < segments ; ++k ){
+    size_t len = 1 + test_rand( ) % 200;
+    uint32_t alphabet = k % 2 ? 4 : 255;
+    if( length + len + 2 > size )
+      break;
+
+    out[length++] = 0x00;
+    for( size_t i = 0 ; i < len ; ++i )
+      out[length++] = (uint8_t) ( 1 + test_rand( ) % alphabet );
+    out[length++] = 0x00;
+  }
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t
+test_match( const uint8_t * sent, const size_t sl, const uint8_t * got, const size_t gl, const uint8_t rssi, uint32_t * bad ){
+  uint32_t matched = 0;
+  size_t si = 0, gi = 0;
+  *bad = 0;
+
+  while( gi < gl ){
+    if( got[gi] ){
+      ++*bad;
+      ++gi;
+      continue;
+    }
+
+    size_t end = gi + 1;
+    while( end < gl && got[end] )
+      ++end;
+    if( end >= gl ){
+      ++*bad;
+      break;
+    }
+    if( rssi && ( end + 1 >= gl || TEST_RSSI != got[end + 1] ) )
+      ++*bad;
+
+    // Sent segments the air lost are passed over, the received one must be one of the next ones
+    size_t len = end - gi - 1;
+    uint8_t found = 0;
+    while( si < sl && !found ){
+      size_t stop = si + 1;
+      while( sent[stop] )
+        ++stop;
+      found = (uint8_t) ( stop - si - 1 == len && !memcmp( sent + si + 1, got + gi + 1, len ) );
+      si = stop + 1;
+    }
+    if( !found ){
+      ++*bad;
+      break;
+    }
+
+    ++matched;
+    gi = end + 1 + rssi;
+  }
+  return matched;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_report( const char * name, const char * label, const uint32_t sent, const uint32_t delivered, const uint32_t bad, const uint8_t passed ){
+  printf( "test=%s case=%s sent=%u delivered=%u bad=%u result=%s\n", name, label, sent, delivered, bad, passed ? "pass" : "fail" );
+  if( !passed )
+    ++test_failures;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
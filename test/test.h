@@ -0,0 +1,104 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      test.h
+ *
+ * @version   1.0
+ *
+ * @date      17-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *
+ * @author    Fábio D. Pacheco,
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ *
+ * @note      Manuals:
+ *
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_TEST_H
+#define E22900T22S_TEST_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define TEST_RSSI         0x55              // RSSI byte the simulated module appends after every EOF
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+extern uint32_t test_failures;              // Cases that failed, the program exits with an error when it is not 0
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Draws the next number of a fixed sequence, so every run sees the same splits, losses and corruption.
+ *
+ * @return A pseudo random number.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t test_rand( void );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Fills `out` with segments of 1 to 200 payload bytes, each closed by a pair of limiters. \n
+ *        Odd segments draw their bytes from a small alphabet, so the codec has repetitions to compress.
+ *
+ * @param[out] out The stream.
+ * @param[in] size The capacity of `out`.
+ * @param[in] segments The number of segments.
+ *
+ * @return The length of the stream.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t test_stream( uint8_t * out, const size_t size, const uint32_t segments );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Walks what was received against what was sent. Every received segment must equal the next sent segment still unmatched or a later one, \n
+ *        i.e., segments may be lost but never altered, duplicated or reordered. With `rssi` each one must be followed by TEST_RSSI.
+ *
+ * @param[in] sent The stream written, segments without RSSI.
+ * @param[in] sl The length of `sent`.
+ * @param[in] got The stream read.
+ * @param[in] gl The length of `got`.
+ * @param[in] rssi 1 if the read segments carry the RSSI byte.
+ * @param[out] bad The received segments that did not match, or bytes outside any segment.
+ *
+ * @return The number of segments matched.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint32_t test_match( const uint8_t * sent, const size_t sl, const uint8_t * got, const size_t gl, const uint8_t rssi, uint32_t * bad );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Prints one result as a single line of key=value pairs and counts it when it failed: \n
+ *        test=<name> case=<label> sent=<n> delivered=<n> bad=<n> result=<pass|fail>
+ *
+ * @param[in] name The stage tested.
+ * @param[in] label The case, e.g., the impairments on the air.
+ * @param[in] sent The segments written.
+ * @param[in] delivered The segments read back.
+ * @param[in] bad The segments read back altered, duplicated or out of order.
+ * @param[in] passed 1 if the case met its expectation.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void test_report( const char * name, const char * label, const uint32_t sent, const uint32_t delivered, const uint32_t bad, const uint8_t passed );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
@@ -0,0 +1,334 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      test_adapt.c
+ *
+ * @version   1.0
+ *
+ * @date      17-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *
+ * @author    Fábio D. Pacheco,
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ *
+ * @note      Manuals:
+ *
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include "test.h"
+#include <e22900t22s/core.h>
+#include <e22900t22s/adapt.h>
+#include <e22900t22s/crc.h>
+#include <e22900t22s/codec.h>
+#include <e22900t22s/rohc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define TEST_SECONDS      900               // Ticks of the loop process per case (s)
+#define TEST_FADE         450               // Time the SNR of the fading case drops (s)
+#define TEST_SETTLE       120               // Time the ends must have agreed on one setting at the end of a case (s)
+#define TEST_PACKETS      6                 // Data segments each end sends per second
+#define TEST_BODY         24                // Longest data segment body, under the smallest packet (B)
+#define TEST_AIR          65536             // Bytes on the air per direction and second
+#define TEST_BUFFER       ( 1 << 20 )       // Bytes of the control frames sent and received per direction
+#define TEST_READ         40                // Largest read, the air hands the bytes in random pieces below it
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Types
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef struct{
+  e22900t22s_adapt_t     adapt;             // Controller of the loop process
+  e22900t22s_eeprom_t    cfg;               // Configuration the reader process keeps, follows `adapt` through the refresh
+  uint32_t               seen;              // Last change the reader process took
+  uint16_t               setting;           // Setting the module runs, air rate and packet size
+  e22900t22s_crc_state_t crc;
+  e22900t22s_codec_t     codec;
+  e22900t22s_rohc_t      rohc;
+  size_t                 held_length;       // Restored bytes of a segment whose RSSI byte is still on the air
+  uint8_t                held[ TEST_AIR ];
+  size_t                 air_length;        // Bytes the peer sent this second, on the setting it ran
+  uint8_t                air[ TEST_AIR ];
+  size_t                 sent_length;       // Control frames sent, to match against the ones the peer parses
+  uint8_t                sent[ TEST_BUFFER ];
+  size_t                 got_length;        // Control frames parsed, sent by the peer
+  uint8_t                got[ TEST_BUFFER ];
+} test_end_t;
+
+typedef struct{
+  const char * label;
+  uint8_t  airrate;                         // Setting both ends start on, index of `lut_airrate`
+  uint8_t  packet;
+  float    snr;                             // SNR of the link (dB)
+  float    fade;                            // SNR after `TEST_FADE`, the same as `snr` when it does not fade (dB)
+  uint32_t loss;                            // Percentage of the segments lost on top of the ones the SNR takes
+  uint32_t flips;                           // One bit inverted every `flips` bytes on average, 0 for none
+  uint8_t  rssi;                            // The module appends the RSSI byte after every EOF, without it nothing is sampled
+} test_case_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+static test_end_t ends[2];
+
+static const test_case_t cases[] = {
+  { "up",      1, 3, 10.0f, 10.0f,  0,  0,  1 },
+  { "down",    5, 3, -9.0f, -9.0f,  0,  0,  1 },
+  { "fade",    1, 3, 10.0f, -12.0f, 0,  0,  1 },
+  { "drop-30", 1, 3, 10.0f, 10.0f,  30, 0,  1 },
+  { "corrupt", 1, 3, 10.0f, 10.0f,  0,  60, 1 },
+  { "no-rssi", 5, 3, 10.0f, 10.0f,  0,  0,  0 },
+};
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+void test_frames( void );
+float test_success( const uint16_t setting, const float snr );
+void test_transmit( test_end_t * from, test_end_t * to, const test_case_t * tc, const float snr, const uint8_t * segment, const size_t len );
+void test_control( test_end_t * from, test_end_t * to, const test_case_t * tc, const float snr, const e22900t22s_adapt_msg_t * msg );
+void test_receive( test_end_t * end, const test_case_t * tc, const float snr );
+void test_case( const test_case_t * tc );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_frames( void ){
+  uint32_t frames = 0, parsed = 0, bad = 0;
+  const uint8_t types[3] = { E22900T22S_ADAPT_PROPOSE, E22900T22S_ADAPT_ACCEPT, E22900T22S_ADAPT_ACK };
+
+  for( uint8_t t = 0 ; t < 3 ; ++t )
+    for( uint32_t epoch = 1 ; epoch < 256 ; ++epoch )
+      for( uint8_t a = 0 ; a < E22900T22S_LUT_SIZE_AIRRATE ; ++a )
+        for( uint8_t p = 0 ; p < E22900T22S_LUT_SIZE_PACKET ; ++p ){
+          e22900t22s_adapt_msg_t msg = { types[t], (uint8_t) epoch, a, p }, out;
+          uint8_t frame[ E22900T22S_ADAPT_FRAME ];
+          e22900t22s_adapt_frame( &msg, frame );
+          ++frames;
+
+          // The body never holds a limiter, and it reads back as it was built
+          if( memchr( &frame[1], 0x00, E22900T22S_ADAPT_FRAME - 2 ) )
+            ++bad;
+          if( 1 == e22900t22s_adapt_parse( frame, sizeof(frame), &out ) && !memcmp( &msg, &out, sizeof(msg) ) )
+            ++parsed;
+          if( e22900t22s_adapt_parse( frame, sizeof(frame) - 1, &out ) )
+            ++bad;
+
+          // Any bit inverted on the air is caught by the check byte
+          for( uint8_t i = 0 ; i < E22900T22S_ADAPT_FRAME * 8 ; ++i ){
+            frame[ i / 8 ] ^= (uint8_t) ( 1 << i % 8 );
+            if( e22900t22s_adapt_parse( frame, sizeof(frame), &out ) )
+              ++bad;
+            frame[ i / 8 ] ^= (uint8_t) ( 1 << i % 8 );
+          }
+        }
+
+  test_report( "adapt", "frames", frames, parsed, bad, (uint8_t) ( !bad && frames == parsed ) );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+float
+test_success( const uint16_t setting, const float snr ){
+  // Share of the packets received, the goodput over the one of a link without noise
+  uint8_t airrate = (uint8_t) ( setting >> 8 );
+  e22900t22s_packet_size_t packet = (e22900t22s_packet_size_t) ( setting & 0xFF );
+  return e22900t22s_adapt_goodput( airrate, packet, snr ) / e22900t22s_adapt_goodput( airrate, packet, 100.0f );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_transmit( test_end_t * from, test_end_t * to, const test_case_t * tc, const float snr, const uint8_t * segment, const size_t len ){
+  uint8_t rohc[ 512 ], packed[ 512 ], trailed[ 512 ];
+
+  // Same stages as the control frames of `adapt_rate`, rohc, codec and crc
+  size_t length = e22900t22s_rohc_pack( &from->rohc, segment, len, rohc, sizeof(rohc) );
+  length = e22900t22s_codec_pack( &from->codec, rohc, length, packed, sizeof(packed) );
+  length = e22900t22s_crc_seal( &from->crc, packed, length, trailed, sizeof(trailed) );
+
+  // The peer hears the packet only on the same setting, and not always
+  if( from->setting != to->setting || (float) ( test_rand( ) % 10000 ) >= 10000.0f * test_success( from->setting, snr ) || test_rand( ) % 100 < tc->loss )
+    return;
+  if( to->air_length + length + 1 > sizeof(to->air) )
+    return;
+
+  for( size_t i = 0 ; i < length ; ++i ){
+    uint8_t byte = trailed[i];
+    if( tc->flips && !( test_rand( ) % tc->flips ) )
+      byte ^= (uint8_t) ( 1 << test_rand( ) % 8 );
+    to->air[ to->air_length++ ] = byte;
+  }
+  if( tc->rssi )
+    to->air[ to->air_length++ ] = TEST_RSSI;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_control( test_end_t * from, test_end_t * to, const test_case_t * tc, const float snr, const e22900t22s_adapt_msg_t * msg ){
+  uint8_t frame[ E22900T22S_ADAPT_FRAME ];
+  e22900t22s_adapt_frame( msg, frame );
+  if( from->sent_length + sizeof(frame) <= sizeof(from->sent) ){
+    memcpy( from->sent + from->sent_length, frame, sizeof(frame) );
+    from->sent_length += sizeof(frame);
+  }
+  test_transmit( from, to, tc, snr, frame, sizeof(frame) );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_receive( test_end_t * end, const test_case_t * tc, const float snr ){
+  static uint8_t crc[ TEST_AIR ], codec[ TEST_AIR ], rohc[ TEST_AIR ];
+
+  for( size_t i = 0 ; i < end->air_length ; ){
+    size_t n = 1 + test_rand( ) % TEST_READ;
+    if( n > end->air_length - i )
+      n = end->air_length - i;
+
+    // Same order as `dread`, the segments come out whole and each one is followed by its RSSI byte when the module appends it
+    size_t length = e22900t22s_crc_verify( &end->crc, end->air + i, n, tc->rssi, crc, sizeof(crc) );
+    length = e22900t22s_codec_unpack( &end->codec, crc, length, tc->rssi, codec, sizeof(codec) );
+    length = e22900t22s_rohc_unpack( &end->rohc, codec, length, tc->rssi, rohc, sizeof(rohc) );
+    memcpy( end->held + end->held_length, rohc, length );
+    end->held_length += length;
+    i += n;
+
+    size_t start = 0;
+    while( start < end->held_length ){
+      size_t stop = start + 1;
+      while( stop < end->held_length && end->held[ stop ] )
+        ++stop;
+      if( stop + tc->rssi >= end->held_length )
+        break;
+
+      // Every segment with an RSSI byte is sampled, the control frames are posted to the loop process too
+      e22900t22s_adapt_msg_t msg;
+      if( tc->rssi )
+        e22900t22s_adapt_sample( &end->adapt, snr + (float) ( test_rand( ) % 21 ) / 10.0f - 1.0f );
+      if( 1 == e22900t22s_adapt_parse( &end->held[ start ], stop + 1 - start, &msg ) ){
+        e22900t22s_adapt_post( &end->adapt, &msg );
+        if( end->got_length + E22900T22S_ADAPT_FRAME <= sizeof(end->got) ){
+          e22900t22s_adapt_frame( &msg, end->got + end->got_length );
+          end->got_length += E22900T22S_ADAPT_FRAME;
+        }
+      }
+      start = stop + 1 + tc->rssi;
+    }
+    memmove( end->held, end->held + start, end->held_length - start );
+    end->held_length -= start;
+  }
+  end->air_length = 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_case( const test_case_t * tc ){
+  e22900t22s_eeprom_t cfg;
+  memset( &cfg, 0, sizeof(cfg) );
+  cfg.airrate = lut_airrate[ tc->airrate ].code;
+  cfg.packet_size = lut_packetsize[ tc->packet ].code;
+
+  memset( ends, 0, sizeof(ends) );
+  for( uint8_t e = 0 ; e < 2 ; ++e ){
+    if( -1 == e22900t22s_adapt_init( &ends[e].adapt, &cfg ) ){
+      perror("e22900t22s_adapt_init");
+      ++test_failures;
+      return;
+    }
+    ends[e].cfg = cfg;
+    ends[e].setting = (uint16_t) ( ends[e].adapt.airrate << 8 | ends[e].adapt.packet );
+    e22900t22s_codec_init( &ends[e].codec );
+    e22900t22s_rohc_init( &ends[e].rohc );
+  }
+
+  uint32_t apart = 0, longest = 0, agreed = 0, stale = 0;
+  float snr = tc->snr;
+  for( uint32_t now = 1 ; now <= TEST_SECONDS ; ++now ){
+    snr = now < TEST_FADE ? tc->snr : tc->fade;
+
+    // The loop processes, the control frame leaves on the setting the module ran before the switch
+    for( uint8_t e = 0 ; e < 2 ; ++e ){
+      e22900t22s_adapt_msg_t msg;
+      uint8_t action = e22900t22s_adapt_step( &ends[e].adapt, now, &msg );
+      if( action & E22900T22S_ADAPT_SEND )
+        test_control( &ends[e], &ends[!e], tc, snr, &msg );
+      if( action & E22900T22S_ADAPT_APPLY ){
+        ends[e].setting = (uint16_t) ( ends[e].adapt.airrate << 8 | ends[e].adapt.packet );
+        e22900t22s_adapt_publish( &ends[e].adapt );
+      }
+    }
+
+    // The writer processes, the data the translator hands down
+    for( uint8_t e = 0 ; e < 2 ; ++e )
+      for( uint32_t k = 0 ; k < TEST_PACKETS ; ++k ){
+        uint8_t segment[ TEST_BODY + 2 ];
+        size_t len = 1 + test_rand( ) % TEST_BODY;
+        segment[0] = segment[ len + 1 ] = 0x00;
+        for( size_t i = 1 ; i <= len ; ++i )
+          segment[i] = (uint8_t) ( 1 + test_rand( ) % 255 );
+        test_transmit( &ends[e], &ends[!e], tc, snr, segment, len + 2 );
+      }
+
+    // The reader processes, they follow the setting the loop process applied
+    for( uint8_t e = 0 ; e < 2 ; ++e ){
+      test_receive( &ends[e], tc, snr );
+      e22900t22s_adapt_refresh( &ends[e].adapt, &ends[e].seen, &ends[e].cfg );
+      if( lookup_table_airrate_2bin( ends[e].cfg.airrate ) != ends[e].setting >> 8 || (uint8_t) ends[e].cfg.packet_size != ( ends[e].setting & 0xFF ) )
+        ++stale;
+    }
+
+    apart = ends[0].setting == ends[1].setting ? 0 : apart + 1;
+    agreed = ends[0].setting == ends[1].setting ? agreed + 1 : 0;
+    longest = apart > longest ? apart : longest;
+  }
+
+  // Both ends settle on one setting, never run apart for longer than the silence takes to bring them back, and do better than where they started
+  // Without the RSSI byte there is no SNR to go by, both ends must stay where they started instead of backing off on made-up samples
+  uint16_t start = (uint16_t) ( tc->airrate << 8 | tc->packet );
+  uint8_t better = (uint8_t) ( e22900t22s_adapt_goodput( (uint8_t) ( ends[0].setting >> 8 ), (e22900t22s_packet_size_t) ( ends[0].setting & 0xFF ), snr ) >= e22900t22s_adapt_goodput( tc->airrate, (e22900t22s_packet_size_t) tc->packet, snr ) );
+  uint8_t moved = (uint8_t) ( ( ends[0].setting != start ) == tc->rssi );
+
+  uint32_t bad = 0, delivered = 0, frames = 0;
+  for( uint8_t e = 0 ; e < 2 ; ++e ){
+    uint32_t mismatched;
+    delivered += test_match( ends[e].sent, ends[e].sent_length, ends[!e].got, ends[!e].got_length, 0, &mismatched );
+    frames += (uint32_t) ( ends[e].sent_length / E22900T22S_ADAPT_FRAME );
+    bad += mismatched;
+  }
+
+  uint8_t passed = (uint8_t) ( !bad && !stale && moved && better && agreed >= TEST_SETTLE && longest <= E22900T22S_ADAPT_CONFIRM + 2 * E22900T22S_ADAPT_SILENCE );
+  test_report( "adapt", tc->label, frames, delivered, bad + stale, passed );
+  if( !passed )
+    printf( "  setting=%04x/%04x longest=%u agreed=%u stale=%u\n", ends[0].setting, ends[1].setting, longest, agreed, stale );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+main( void ){
+  test_frames( );
+  for( size_t i = 0 ; i < sizeof(cases) / sizeof(cases[0]) ; ++i )
+    test_case( &cases[i] );
+  return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
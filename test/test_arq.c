@@ -0,0 +1,254 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      test_arq.c
+ *
+ * @version   1.0
+ *
+ * @date      17-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *
+ * @author    Fábio D. Pacheco,
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ *
+ * @note      Manuals:
+ *
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include "test.h"
+#include <e22900t22s/core.h>
+#include <e22900t22s/arq.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define TEST_SEGMENTS     6000              // Segments written per case
+#define TEST_BUFFER       ( 1 << 21 )       // Bytes of the sent and received streams
+#define TEST_STAGE        65536             // Bytes out of the stage per call
+#define TEST_QUEUE        4096              // Packets on the air at once, per direction
+#define TEST_PACKET       300               // Longest packet, limiters and RSSI byte included (B)
+#define TEST_TICKS        80000             // Ticks of the loop process, the writes stop once every segment is sent
+#define TEST_TICK         20000000ULL       // Period of the loop process (ns)
+#define TEST_DELAY        200000000ULL      // Time on the air (ns)
+#define TEST_CAPACITY     1000              // Serial buffer of the module (B)
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Types
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef struct{
+  uint64_t at;                              // Arrival time (ns)
+  size_t   length;
+  uint8_t  data[ TEST_PACKET ];
+} test_packet_t;
+
+typedef struct{
+  size_t        count;
+  test_packet_t packet[ TEST_QUEUE ];
+} test_air_t;
+
+typedef struct{
+  const char * label;
+  uint32_t loss;                            // Percentage of the segments lost
+  uint32_t ackloss;                         // Percentage of the acknowledgements lost
+  uint32_t jitter;                          // Largest delay added to the time on the air, so the packets arrive out of order (ms)
+  uint8_t  rssi;                            // The module appends the RSSI byte after every EOF
+  uint8_t  whole;                           // Every segment written must be read back
+} test_case_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+static uint8_t sent[ TEST_BUFFER ];
+static uint8_t got[ TEST_BUFFER ];
+static uint8_t data[ TEST_BUFFER ];
+static test_air_t air[2];
+
+// A frame of the rate controller, it has no sequence number and goes up as it is
+static const uint8_t control[] = { 0x00, 0x45, 0x32, 0x00 };
+
+static const test_case_t cases[] = {
+  { "split",      0,  0,  0,   0, 1 },
+  { "split-rssi", 0,  0,  0,   1, 1 },
+  { "jitter",     0,  0,  300, 1, 0 },
+  { "loss-10",    10, 10, 0,   1, 0 },
+  { "loss-30",    30, 30, 50,  1, 0 },
+  { "ackloss-50", 0,  50, 0,   0, 1 },
+};
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+void test_transmit( test_air_t * queue, const test_case_t * tc, const uint32_t loss, const uint8_t * wire, const size_t len, const uint64_t now );
+size_t test_arrive( test_air_t * queue, const uint64_t now, uint8_t * out );
+size_t test_controls( uint8_t * stream, const size_t len, const uint8_t rssi, uint32_t * controls );
+void test_case( const test_case_t * tc );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_transmit( test_air_t * queue, const test_case_t * tc, const uint32_t loss, const uint8_t * wire, const size_t len, const uint64_t now ){
+  for( size_t i = 0 ; i < len ; ){
+    size_t end = i + 1;
+    while( wire[end] )
+      ++end;
+
+    size_t length = end - i + 1;
+    if( test_rand( ) % 100 >= loss && TEST_QUEUE > queue->count && TEST_PACKET > length ){
+      test_packet_t * packet = &queue->packet[ queue->count++ ];
+      packet->at = now + TEST_DELAY + ( tc->jitter ? test_rand( ) % tc->jitter : 0 ) * 1000000ULL;
+      memcpy( packet->data, wire + i, length );
+      packet->length = length;
+      if( tc->rssi )
+        packet->data[ packet->length++ ] = TEST_RSSI;
+    }
+    i = end + 1;
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+test_arrive( test_air_t * queue, const uint64_t now, uint8_t * out ){
+  size_t length = 0, kept = 0;
+  for( size_t i = 0 ; i < queue->count ; ++i ){
+    if( queue->packet[i].at > now ){
+      queue->packet[ kept++ ] = queue->packet[i];
+      continue;
+    }
+    memcpy( out + length, queue->packet[i].data, queue->packet[i].length );
+    length += queue->packet[i].length;
+  }
+  queue->count = kept;
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+test_controls( uint8_t * stream, const size_t len, const uint8_t rssi, uint32_t * controls ){
+  size_t length = 0;
+  *controls = 0;
+  for( size_t i = 0 ; i < len ; ){
+    size_t end = i + 1;
+    while( end < len && stream[end] )
+      ++end;
+    size_t stop = end + 1 + rssi < len ? end + 1 + rssi : len;
+    if( stop - i >= sizeof(control) && !memcmp( stream + i, control, sizeof(control) ) )
+      ++*controls;
+    else{
+      memmove( stream + length, stream + i, stop - i );
+      length += stop - i;
+    }
+    i = stop;
+  }
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_case( const test_case_t * tc ){
+  static e22900t22s_arq_t tx, rx;
+  static uint8_t wire[ TEST_STAGE ], in[ TEST_STAGE ], out[ TEST_STAGE ];
+  e22900t22s_eeprom_t cfg;
+  memset( &cfg, 0, sizeof(cfg) );
+  cfg.airrate = B9600;
+  cfg.packet_size = lut_packetsize[2].code;
+  memset( &tx, 0, sizeof(tx) );
+  memset( &rx, 0, sizeof(rx) );
+  memset( air, 0, sizeof(air) );
+  if( -1 == e22900t22s_arq_init( &tx, &cfg, TEST_CAPACITY ) || -1 == e22900t22s_arq_init( &rx, &cfg, TEST_CAPACITY ) ){
+    perror("e22900t22s_arq_init");
+    ++test_failures;
+    return;
+  }
+
+  size_t sl = test_stream( sent, sizeof(sent), TEST_SEGMENTS );
+  size_t written = 0, gl = 0;
+  uint32_t controls = 0, unpacked = 0;
+  uint64_t now = 0;
+
+  for( uint32_t tick = 0 ; tick < TEST_TICKS ; ++tick, now += TEST_TICK ){
+    // The writer sends one or two segments when the window has room for them, a control frame now and then
+    if( written < sl && !( test_rand( ) % 3 ) ){
+      size_t dl = 0;
+      for( uint32_t k = 1 + test_rand( ) % 2 ; k && written + dl < sl ; --k ){
+        size_t end = written + dl + 1;
+        while( sent[end] )
+          ++end;
+        dl = end + 1 - written;
+      }
+      memcpy( data, sent + written, dl );
+      uint8_t frame = (uint8_t) !( test_rand( ) % 5 );
+      if( frame )
+        memcpy( data + dl, control, sizeof(control) );
+      if( !e22900t22s_arq_wait( &tx, data, dl + ( frame ? sizeof(control) : 0 ) ) ){
+        size_t wl = e22900t22s_arq_pack( &tx, data, dl + ( frame ? sizeof(control) : 0 ), now, wire, sizeof(wire) );
+        test_transmit( &air[0], tc, tc->loss, wire, wl, now );
+        written += dl;
+        controls += frame;
+      }
+    }
+
+    // The loop processes of both sides send the acknowledgements and the retransmissions, and give up the expired gaps
+    uint32_t abandoned;
+    size_t pl = e22900t22s_arq_poll( &tx, now, wire, sizeof(wire), &abandoned );
+    test_transmit( &air[0], tc, tc->loss, wire, pl, now );
+    pl = e22900t22s_arq_poll( &rx, now, wire, sizeof(wire), &abandoned );
+    test_transmit( &air[1], tc, tc->ackloss, wire, pl, now );
+    e22900t22s_arq_expire( &rx, tc->rssi, now );
+
+    // The reader takes what arrived split in two, the segment open at the cut is finished by the second read
+    size_t il = test_arrive( &air[0], now, in );
+    if( il || rx.released_length ){
+      size_t cut = il ? test_rand( ) % il : 0;
+      size_t a = e22900t22s_arq_unpack( &rx, in, cut, tc->rssi, now, out, sizeof(out) );
+      size_t b = e22900t22s_arq_unpack( &rx, in + cut, il - cut, tc->rssi, now, out + a, sizeof(out) - a );
+      if( gl + a + b > sizeof(got) )
+        break;
+      memcpy( got + gl, out, a + b );
+      gl += a + b;
+    }
+
+    // The acknowledgements come up to the writer, nothing else does
+    il = test_arrive( &air[1], now, in );
+    if( il )
+      unpacked += (uint32_t) e22900t22s_arq_unpack( &tx, in, il, tc->rssi, now, out, sizeof(out) );
+  }
+
+  uint32_t received, bad;
+  gl = test_controls( got, gl, tc->rssi, &received );
+  uint32_t delivered = test_match( sent, sl, got, gl, tc->rssi, &bad );
+  bad += unpacked;
+  uint8_t passed = (uint8_t) ( !bad && written == sl && ( !tc->whole || ( TEST_SEGMENTS == delivered && controls == received ) ) );
+  test_report( "arq", tc->label, TEST_SEGMENTS, delivered, bad, passed );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+main( void ){
+  for( size_t i = 0 ; i < sizeof(cases) / sizeof(cases[0]) ; ++i )
+    test_case( &cases[i] );
+  return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
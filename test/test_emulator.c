@@ -0,0 +1,354 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      test_emulator.c
+ *
+ * @version   1.0
+ *
+ * @date      17-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *
+ * @author    Fábio D. Pacheco,
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ *
+ * @note      Manuals:
+ *
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include "test_emulator.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define TEST_LINES        3                 // AUX, M0 and M1, at the offsets of the emulator
+#define TEST_LINE_AUX     0
+#define TEST_LINE_M0      1
+#define TEST_LINE_M1      2
+#define TEST_CHIPS        4                 // Fake chips open at once, one per module driven
+#define TEST_WAIT         200               // Polls of 10 ms for the links of the emulator
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+// The libgpiod v1 handles are opaque to the driver, the fake ones keep the line levels and the modes they select
+struct gpiod_chip;
+
+struct gpiod_line{
+  struct gpiod_chip * chip;
+  unsigned int        offset;
+  int                 value;
+};
+
+struct gpiod_chip{
+  uint8_t           used;
+  char              name[ NAME_MAX ];       // Mode file of the module, written on every switch when it exists
+  struct gpiod_line line[ TEST_LINES ];
+  char              modes[ TEST_MODES + 1 ];  // One digit per switch, M1 high bit and M0 low bit
+  uint8_t           switches;
+};
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+static struct gpiod_chip chips[ TEST_CHIPS ];
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+test_emulator_start( test_emulator_t * emu, const char * path, const char * const * options ){
+  if( !emu || !path ){
+    errno = EINVAL;
+    return -1;
+  }
+  memset( emu, 0, sizeof(test_emulator_t) );
+  for( uint8_t i = 0 ; i < TEST_MODULES ; ++i )
+    emu->serial[i].sr.fd = -1;
+  snprintf( emu->dir, sizeof(emu->dir), "/tmp/e22900t22s-test-XXXXXX" );
+  if( !mkdtemp( emu->dir ) ){
+    perror("mkdtemp");
+    return -1;
+  }
+
+  for( uint8_t i = 0 ; i < TEST_MODULES ; ++i )
+    snprintf( emu->link[i], sizeof(emu->link[i]), "%s/%c", emu->dir, 'a' + i );
+  const char * argv[ 32 ] = { path, "-a", emu->link[0], "-b", emu->link[1] };
+  size_t argc = 5;
+  for( ; options && *options && argc < sizeof(argv) / sizeof(argv[0]) - 1 ; ++options )
+    argv[ argc++ ] = *options;
+
+  emu->pid = fork( );
+  if( -1 == emu->pid ){
+    perror("fork");
+    rmdir( emu->dir );
+    return -1;
+  }
+
+  // The counters the emulator prints on exit would mix with the results, only its errors are kept
+  if( !emu->pid ){
+    int null = open( "/dev/null", O_WRONLY );
+    if( -1 != null )
+      dup2( null, STDOUT_FILENO );
+    execv( path, (char * const *) argv );
+    perror("execv");
+    _exit( 127 );
+  }
+
+  const struct timespec poll = { 0, 10000000L };
+  for( uint32_t k = 0 ; k < TEST_WAIT && ( access( emu->link[0], F_OK ) || access( emu->link[1], F_OK ) ) ; ++k ){
+    if( emu->pid == waitpid( emu->pid, NULL, WNOHANG ) ){
+      emu->pid = 0;
+      rmdir( emu->dir );
+      errno = ECHILD;
+      return -1;
+    }
+    nanosleep( &poll, NULL );
+  }
+
+  for( uint8_t i = 0 ; i < TEST_MODULES ; ++i ){
+    struct termios tio;
+    int fd = open( emu->link[i], O_RDWR | O_NOCTTY );
+    if( -1 == fd || -1 == tcgetattr( fd, &tio ) ){
+      perror("open");
+      if( -1 != fd )
+        close( fd );
+      test_emulator_stop( emu );
+      return -1;
+    }
+    cfmakeraw( &tio );
+    cfsetspeed( &tio, B9600 );
+    tcsetattr( fd, TCSANOW, &tio );
+    emu->serial[i].sr.fd = fd;
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+test_emulator_stop( test_emulator_t * emu ){
+  if( !emu ){
+    errno = EINVAL;
+    return -1;
+  }
+  for( uint8_t i = 0 ; i < TEST_MODULES ; ++i ){
+    if( -1 != emu->serial[i].sr.fd )
+      close( emu->serial[i].sr.fd );
+    emu->serial[i].sr.fd = -1;
+  }
+
+  int status = 0;
+  if( emu->pid && ( -1 == kill( emu->pid, SIGTERM ) || -1 == waitpid( emu->pid, &status, 0 ) ) ){
+    perror("waitpid");
+    return -1;
+  }
+  emu->pid = 0;
+  rmdir( emu->dir );
+  if( !WIFEXITED( status ) || WEXITSTATUS( status ) ){
+    errno = ECHILD;
+    return -1;
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_emulator_pinout( const test_emulator_t * emu, const uint8_t index, e22900t22s_pinmode_t * pinout ){
+  memset( pinout, 0, sizeof(e22900t22s_pinmode_t) );
+  snprintf( pinout->chip.name, sizeof(pinout->chip.name), "%s.mode", emu->link[ index ] );
+  pinout->aux.offset = TEST_LINE_AUX;
+  pinout->m0.offset = TEST_LINE_M0;
+  pinout->m1.offset = TEST_LINE_M1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+const char *
+test_gpio_modes( const e22900t22s_t * dev ){
+  return dev->gpio.chip.ptr ? dev->gpio.chip.ptr->modes : "";
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_gpio_clear( e22900t22s_t * dev ){
+  if( !dev->gpio.chip.ptr )
+    return;
+  memset( dev->gpio.chip.ptr->modes, 0, sizeof(dev->gpio.chip.ptr->modes) );
+  dev->gpio.chip.ptr->switches = 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Fake libgpiod v1, the symbols of the library are taken by the test program
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+struct gpiod_chip *
+gpiod_chip_open_by_name( const char * name ){
+  for( uint8_t i = 0 ; i < TEST_CHIPS ; ++i ){
+    struct gpiod_chip * chip = &chips[i];
+    if( chip->used )
+      continue;
+    memset( chip, 0, sizeof(struct gpiod_chip) );
+    chip->used = 1;
+    snprintf( chip->name, sizeof(chip->name), "%s", name );
+    for( unsigned int l = 0 ; l < TEST_LINES ; ++l ){
+      chip->line[l].chip = chip;
+      chip->line[l].offset = l;
+    }
+
+    // The module is idle the whole test, the driver never waits on AUX
+    chip->line[ TEST_LINE_AUX ].value = 1;
+    return chip;
+  }
+  errno = EMFILE;
+  return NULL;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+gpiod_chip_close( struct gpiod_chip * chip ){
+  if( chip )
+    chip->used = 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+struct gpiod_line *
+gpiod_chip_get_line( struct gpiod_chip * chip, unsigned int offset ){
+  if( !chip || TEST_LINES <= offset ){
+    errno = EINVAL;
+    return NULL;
+  }
+  return &chip->line[ offset ];
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+gpiod_line_request_output( struct gpiod_line * line, const char * consumer, int default_val ){
+  (void) consumer;
+  line->value = default_val;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+gpiod_line_request_input_flags( struct gpiod_line * line, const char * consumer, int flags ){
+  (void) line;
+  (void) consumer;
+  (void) flags;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+gpiod_line_request_rising_edge_events_flags( struct gpiod_line * line, const char * consumer, int flags ){
+  // No edges, the driver polls AUX
+  (void) line;
+  (void) consumer;
+  (void) flags;
+  errno = ENOTSUP;
+  return -1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+gpiod_line_request_bulk_output( struct gpiod_line_bulk * bulk, const char * consumer, const int * default_vals ){
+  (void) consumer;
+  for( unsigned int i = 0 ; i < bulk->num_lines ; ++i )
+    bulk->lines[i]->value = default_vals[i];
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+gpiod_line_set_value( struct gpiod_line * line, int value ){
+  line->value = value;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+gpiod_line_set_value_bulk( struct gpiod_line_bulk * bulk, const int * values ){
+  for( unsigned int i = 0 ; i < bulk->num_lines ; ++i )
+    bulk->lines[i]->value = values[i];
+
+  // The driver switches modes with both lines at once, the switch is recorded as the mode it selects
+  struct gpiod_chip * chip = bulk->num_lines ? bulk->lines[0]->chip : NULL;
+  if( !chip )
+    return 0;
+  char mode = (char) ( '0' + ( chip->line[ TEST_LINE_M1 ].value << 1 | chip->line[ TEST_LINE_M0 ].value ) );
+  if( TEST_MODES > chip->switches )
+    chip->modes[ chip->switches++ ] = mode;
+
+  // Only an emulator started with -M created the file
+  int fd = open( chip->name, O_WRONLY );
+  if( -1 != fd ){
+    if( 1 != pwrite( fd, &mode, 1, 0 ) )
+      perror("pwrite");
+    close( fd );
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+gpiod_line_get_value( struct gpiod_line * line ){
+  return line->value;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+gpiod_line_event_wait( struct gpiod_line * line, const struct timespec * timeout ){
+  (void) line;
+  (void) timeout;
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+gpiod_line_event_read( struct gpiod_line * line, struct gpiod_line_event * event ){
+  (void) line;
+  (void) event;
+  errno = ENOTSUP;
+  return -1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+gpiod_line_event_get_fd( struct gpiod_line * line ){
+  (void) line;
+  errno = ENOTSUP;
+  return -1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+gpiod_line_release( struct gpiod_line * line ){
+  (void) line;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
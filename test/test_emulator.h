@@ -0,0 +1,113 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      test_emulator.h
+ *
+ * @version   1.0
+ *
+ * @date      17-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *
+ * @author    Fábio D. Pacheco,
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ *
+ * @note      Manuals:
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definition file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#ifndef E22900T22S_TEST_EMULATOR_H
+#define E22900T22S_TEST_EMULATOR_H
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include <e22900t22s/core.h>
+#include <sys/types.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define TEST_MODULES      2                 // Modules the emulator links over its channel
+#define TEST_MODES        32                // Mode switches recorded per module
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Data structures
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef struct{
+  pid_t            pid;
+  char             dir[ 64 ];               // Temporary directory holding the links
+  char             link[ TEST_MODULES ][ 96 ];
+  serial_manager_t serial[ TEST_MODULES ];  // The pty of each module, opened raw
+} test_emulator_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Starts the module emulator, waits for the links to its ptys and opens them. \n
+ *        Without -g the emulator has no gpio-sim lines, the driver is handed fake M0, M1 and AUX lines instead: AUX is always high and \n
+ *        the modes the driver switches to are recorded and written to <link>.mode. With -M the emulator follows that file, \n
+ *        otherwise it stays in the mode given with -m.
+ *
+ * @param[out] emu The running emulator.
+ * @param[in] path The emulator program, build/e22900t22s_emulator.
+ * @param[in] options Its options after -a and -b, NULL terminated, e.g., { "-m", "2", NULL }.
+ *
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t test_emulator_start( test_emulator_t * emu, const char * path, const char * const * options );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Closes the ptys and stops the emulator, it removes its links on the way out.
+ *
+ * @param[in,out] emu The running emulator.
+ *
+ * @return Upon success, it returns 0. \n
+ *         Otherwise, -1 is returned and `errno` is set to indicate the error, ECHILD if the emulator did not exit cleanly.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t test_emulator_stop( test_emulator_t * emu );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Fills the pinout of a module with the fake lines, AUX at offset 0, M0 at 1 and M1 at 2 as the emulator numbers them. \n
+ *        The chip is named after the mode file of the module.
+ *
+ * @param[in] emu The running emulator.
+ * @param[in] index The module, 0 for -a and 1 for -b.
+ * @param[out] pinout The pinout handed to `e22900t22s_set_pinout` or to the reactor.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void test_emulator_pinout( const test_emulator_t * emu, const uint8_t index, e22900t22s_pinmode_t * pinout );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief The modes the driver switched the module to since its lines were requested, or since `test_gpio_clear`, one digit per switch, e.g., "20".
+ *
+ * @param[in] dev The driver of the module.
+ *
+ * @return The switches, empty if the module lines are not the fake ones.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+const char * test_gpio_modes( const e22900t22s_t * dev );
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @brief Forgets the mode switches recorded for a module.
+ *
+ * @param[in,out] dev The driver of the module.
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void test_gpio_clear( e22900t22s_t * dev );
+
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
@@ -0,0 +1,217 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      test_protocol.c
+ *
+ * @version   1.0
+ *
+ * @date      17-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *
+ * @author    Fábio D. Pacheco,
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ *
+ * @note      Manuals:
+ *
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include "test.h"
+#include "test_emulator.h"
+#include <e22900t22s/metrics.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define TEST_NOISE        -100.0f           // Ambient noise of the emulated channel (dBm)
+#define TEST_NOISE_MARGIN 6.0f              // Its spread, a few deviations of the emulator (dB)
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+// The manufacturer defaults the emulator starts with, the key reads as 0
+static const uint8_t defaults[ E22900T22S_REG_BLOCK ] = { 0x00, 0x00, 0x00, 0x62, 0x00, 0x32, 0x03, 0x00, 0x00 };
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+void test_check( const char * label, const uint8_t passed );
+int8_t test_device( test_emulator_t * emu, e22900t22s_t * dev );
+void test_config( const char * path );
+void test_transaction( const char * path );
+void test_rssi( const char * path );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_check( const char * label, const uint8_t passed ){
+  test_report( "protocol", label, 1, passed, (uint32_t) !passed, passed );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+test_device( test_emulator_t * emu, e22900t22s_t * dev ){
+  // The first module of the emulator, at the defaults of the serial port
+  e22900t22s_pinmode_t pinout;
+  memset( dev, 0, sizeof(e22900t22s_t) );
+  dev->serial = &emu->serial[0];
+  dev->cfg.baudrate = B9600;
+  dev->cfg.parity = BPARITY_NONE;
+  test_emulator_pinout( emu, 0, &pinout );
+  return e22900t22s_set_pinout( &pinout, dev );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_config( const char * path ){
+  // The configuration mode is held by the emulator, every 0xC0, 0xC1 and 0xC2 goes to the registers
+  static test_emulator_t emu;
+  static e22900t22s_t dev;
+  const char * const options[] = { "-m", "2", NULL };
+  if( -1 == test_emulator_start( &emu, path, options ) || -1 == test_device( &emu, &dev ) ){
+    perror("Starting the emulator");
+    ++test_failures;
+    return;
+  }
+
+  // The whole block reads back as the defaults, every register but the key is then known
+  uint8_t reg[ E22900T22S_REG_BLOCK ];
+  const uint16_t readable = ( 1 << ( E22900T22S_MEM_REG3 + 1 ) ) - 1;
+  test_check( "c1-read", (uint8_t) ( E22900T22S_REG_BLOCK == e22900t22s_read_register( 0, E22900T22S_REG_BLOCK, reg, sizeof(reg), &dev ) &&
+                                     !memcmp( reg, defaults, sizeof(reg) ) && readable == dev.shadow.known ) );
+
+  // A persistent write is echoed with 0xC1 in front, the address is then read back from the module
+  const uint8_t address[2] = { 0x12, 0x34 };
+  uint8_t back[2] = { 0 };
+  test_check( "c0-write", (uint8_t) ( 2 == e22900t22s_write_register( E22900T22S_MEM_ADDH, 2, address, &dev ) &&
+                                      2 == e22900t22s_read_register( E22900T22S_MEM_ADDH, 2, back, sizeof(back), &dev ) &&
+                                      !memcmp( back, address, sizeof(back) ) && 0x12 == dev.shadow.reg[ E22900T22S_MEM_ADDH ] && !dev.shadow.dirty ) );
+
+  // A volatile write changes what the module runs, the shadow keeps the EEPROM channel apart
+  e22900t22s_transaction_t tr;
+  const uint8_t channel = 0x10;
+  uint8_t running = 0;
+  test_check( "c2-write", (uint8_t) ( !e22900t22s_transaction_begin( &tr, &dev ) &&
+                                      !e22900t22s_transaction_write_temporary( &tr, E22900T22S_MEM_REG2, 1, &channel ) &&
+                                      !e22900t22s_transaction_commit( &tr ) &&
+                                      1 == e22900t22s_read_register( E22900T22S_MEM_REG2, 1, &running, 1, &dev ) && channel == running &&
+                                      ( dev.shadow.temporary >> E22900T22S_MEM_REG2 & 1 ) && channel == dev.shadow.running[ E22900T22S_MEM_REG2 ] &&
+                                      defaults[ E22900T22S_MEM_REG2 ] == dev.shadow.reg[ E22900T22S_MEM_REG2 ] ) );
+
+  // The product information sits apart from the block
+  uint8_t pid[ E22900T22S_PID_SIZE ];
+  uint8_t matched = (uint8_t) ( E22900T22S_PID_SIZE == e22900t22s_read_register( E22900T22S_MEM_PID, E22900T22S_PID_SIZE, pid, sizeof(pid), &dev ) && dev.shadow.pid );
+  for( uint8_t i = 0 ; i < E22900T22S_PID_SIZE ; ++i )
+    matched = (uint8_t) ( matched && 0x10 + i == pid[i] );
+  test_check( "pid", matched );
+
+  e22900t22s_gpio_close( &dev );
+  if( -1 == test_emulator_stop( &emu ) ){
+    perror("Stopping the emulator");
+    ++test_failures;
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_transaction( const char * path ){
+  // Reads and writes queued together share one trip to the configuration mode and back, in the order they were queued
+  static test_emulator_t emu;
+  static e22900t22s_t dev;
+  const char * const options[] = { "-m", "2", NULL };
+  if( -1 == test_emulator_start( &emu, path, options ) || -1 == test_device( &emu, &dev ) ){
+    perror("Starting the emulator");
+    ++test_failures;
+    return;
+  }
+
+  e22900t22s_transaction_t tr;
+  const uint8_t netid = 0x07, channel = 0x20, power = 0x01;
+  uint8_t address[2] = { 0xFF, 0xFF }, back = 0, pid[ E22900T22S_PID_SIZE ] = { 0 };
+  uint32_t switches = dev.state.switches;
+  test_gpio_clear( &dev );
+  uint8_t passed = (uint8_t) ( !e22900t22s_transaction_begin( &tr, &dev ) &&
+                               !e22900t22s_transaction_read( &tr, E22900T22S_MEM_ADDH, 2, address, sizeof(address) ) &&
+                               !e22900t22s_transaction_write( &tr, E22900T22S_MEM_NETID, 1, &netid ) &&
+                               !e22900t22s_transaction_write_temporary( &tr, E22900T22S_MEM_REG2, 1, &channel ) &&
+                               !e22900t22s_transaction_read( &tr, E22900T22S_MEM_REG2, 1, &back, 1 ) &&
+                               !e22900t22s_transaction_write_temporary( &tr, E22900T22S_MEM_REG1, 1, &power ) &&
+                               !e22900t22s_transaction_read( &tr, E22900T22S_MEM_PID, E22900T22S_PID_SIZE, pid, sizeof(pid) ) &&
+                               !e22900t22s_transaction_commit( &tr ) );
+  passed = (uint8_t) ( passed && !address[0] && !address[1] && channel == back && 0x10 == pid[0] && netid == dev.shadow.reg[ E22900T22S_MEM_NETID ] );
+  test_check( "commit-once", (uint8_t) ( passed && !strcmp( test_gpio_modes( &dev ), "20" ) && 2 == dev.state.switches - switches ) );
+
+  // The same operations one by one, each goes to the configuration mode and back on its own
+  switches = dev.state.switches;
+  test_gpio_clear( &dev );
+  passed = (uint8_t) ( 2 == e22900t22s_read_register( E22900T22S_MEM_ADDH, 2, address, sizeof(address), &dev ) &&
+                       1 == e22900t22s_write_register( E22900T22S_MEM_NETID, 1, &netid, &dev ) &&
+                       1 == e22900t22s_read_register( E22900T22S_MEM_REG2, 1, &back, 1, &dev ) && channel == back );
+  test_check( "commit-each", (uint8_t) ( passed && !strcmp( test_gpio_modes( &dev ), "202020" ) && 6 == dev.state.switches - switches ) );
+
+  e22900t22s_gpio_close( &dev );
+  if( -1 == test_emulator_stop( &emu ) ){
+    perror("Stopping the emulator");
+    ++test_failures;
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_rssi( const char * path ){
+  // The normal mode with the ambient noise enabled, the RSSI command is answered among the data
+  static test_emulator_t emu;
+  static e22900t22s_t dev;
+  const char * const options[] = { "-m", "0", "-N", "-n", "-100", NULL };
+  if( -1 == test_emulator_start( &emu, path, options ) || -1 == test_device( &emu, &dev ) ){
+    perror("Starting the emulator");
+    ++test_failures;
+    return;
+  }
+
+  // Nothing was received yet, the RSSI of the last packet is 0
+  e22900t22s_rssi_t rssi;
+  test_check( "rssi-read", (uint8_t) ( !e22900t22s_get_rssi( &rssi, &dev ) &&
+                                       TEST_NOISE - TEST_NOISE_MARGIN < rssi.current && TEST_NOISE + TEST_NOISE_MARGIN > rssi.current && 0.0f == rssi.past ) );
+
+  e22900t22s_gpio_close( &dev );
+  if( -1 == test_emulator_stop( &emu ) ){
+    perror("Stopping the emulator");
+    ++test_failures;
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+main( int argc, char ** argv ){
+  if( 2 > argc ){
+    fprintf( stderr, "Usage: %s <emulator>\n", argv[0] );
+    return EXIT_FAILURE;
+  }
+  test_config( argv[1] );
+  test_transaction( argv[1] );
+  test_rssi( argv[1] );
+  return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
@@ -0,0 +1,204 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      test_reactor.c
+ *
+ * @version   1.0
+ *
+ * @date      17-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *
+ * @author    Fábio D. Pacheco,
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ *
+ * @note      Manuals:
+ *
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include "test.h"
+#include "test_emulator.h"
+#include <e22900t22s/reactor.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define TEST_SEGMENTS     80                // Segments written by the first module
+#define TEST_SPARSE       10                // The second one writes this many times fewer, so its own writes seldom hold back its RSSI command
+#define TEST_BUFFER       32768             // Bytes of the sent and received streams, per module
+#define TEST_PACE         40000000ULL       // Time between the writes of the first module, its stream outlasts the first noise sample (ns)
+#define TEST_TIMEOUT      10000000000ULL    // Longest run of the reactor (ns)
+#define TEST_WAIT         5                 // Longest wait of one reactor run (ms)
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Types
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef struct{
+  uint32_t segments;
+  uint64_t pace;                            // Time between two writes (ns)
+  uint8_t  sent[ TEST_BUFFER ];
+  size_t   sl;
+  size_t   written;                         // Bytes of `sent` queued in the reactor
+  uint64_t next;                            // When the next segment is queued (ns)
+  uint8_t  got[ TEST_BUFFER ];
+  size_t   gl;
+  uint8_t  replied;                         // The reply to the RSSI command was taken out of the received bytes
+  size_t   before;                          // Bytes received before that reply
+} test_side_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+static test_side_t side[ TEST_MODULES ];
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+uint64_t test_now( void );
+void test_receive( e22900t22s_device_t * device, const uint8_t * data, const size_t length, void * user );
+uint8_t test_write( e22900t22s_reactor_t * reactor, const uint8_t index, const uint64_t now );
+void test_link( const char * path );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint64_t
+test_now( void ){
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_receive( e22900t22s_device_t * device, const uint8_t * data, const size_t length, void * user ){
+  // The noise starts with the sample taken when the module was added, a second one came from the reactor
+  test_side_t * s = (test_side_t *) user;
+  if( !s->replied && 1 < device->noise.count ){
+    s->replied = 1;
+    s->before = s->gl;
+  }
+  if( s->gl + length > sizeof(s->got) )
+    return;
+  memcpy( s->got + s->gl, data, length );
+  s->gl += length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t
+test_write( e22900t22s_reactor_t * reactor, const uint8_t index, const uint64_t now ){
+  // One segment at a time, a full queue is tried again on the next turn
+  test_side_t * s = &side[ index ];
+  if( s->written >= s->sl || now < s->next )
+    return 1;
+  size_t end = s->written + 1;
+  while( s->sent[ end ] )
+    ++end;
+  if( -1 == e22900t22s_reactor_send( reactor, index, s->sent + s->written, end + 1 - s->written ) )
+    return EAGAIN == errno;
+  s->written = end + 1;
+  s->next = now + s->pace;
+  return 1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_link( const char * path ){
+  // Both modules configured by the reactor, the emulator follows the modes the driver switches to
+  static test_emulator_t emu;
+  static e22900t22s_reactor_t reactor;
+  static e22900t22s_config_t config[ TEST_MODULES ];
+  const char * const options[] = { "-M", NULL };
+  if( -1 == test_emulator_start( &emu, path, options ) || -1 == e22900t22s_reactor_init( &reactor ) ){
+    perror("Starting the emulator");
+    ++test_failures;
+    return;
+  }
+
+  for( uint8_t i = 0 ; i < TEST_MODULES ; ++i ){
+    memset( &config[i], 0, sizeof(e22900t22s_config_t) );
+    config[i].eeprom.baudrate = B115200;
+    config[i].eeprom.parity = BPARITY_NONE;
+    config[i].eeprom.airrate = B62500;
+    config[i].eeprom.packet_size = E22900T22S_PACKET_240;
+    config[i].eeprom.transmit_power = E22900T22S_DBM_22;
+    config[i].eeprom.channel = 0x32;
+    test_emulator_pinout( &emu, i, &config[i].pinout );
+    memset( &side[i], 0, sizeof(test_side_t) );
+    side[i].segments = i ? TEST_SEGMENTS / TEST_SPARSE : TEST_SEGMENTS;
+    side[i].pace = i ? TEST_PACE * TEST_SPARSE : TEST_PACE;
+    side[i].sl = test_stream( side[i].sent, sizeof(side[i].sent), side[i].segments );
+    if( i != e22900t22s_reactor_add( &reactor, &emu.serial[i], &config[i], test_receive, &side[i] ) ){
+      perror("e22900t22s_reactor_add");
+      ++test_failures;
+      e22900t22s_reactor_close( &reactor );
+      test_emulator_stop( &emu );
+      return;
+    }
+  }
+
+  // Both modules write and read at once, the RSSI command of the second one is answered among the packets of the first
+  uint8_t failed = 0;
+  for( uint64_t start = test_now( ), now = start ; now - start < TEST_TIMEOUT ; now = test_now( ) ){
+    for( uint8_t i = 0 ; i < TEST_MODULES ; ++i )
+      failed |= (uint8_t) !test_write( &reactor, i, now );
+    if( failed || -1 == e22900t22s_reactor_run( &reactor, TEST_WAIT ) )
+      break;
+    if( side[0].gl >= side[1].sl && side[1].gl >= side[0].sl && side[1].replied )
+      break;
+  }
+
+  for( uint8_t i = 0 ; i < TEST_MODULES ; ++i ){
+    const e22900t22s_device_t * device = &reactor.device[i];
+    const test_side_t * peer = &side[ 1 - i ];
+    uint32_t bad;
+    uint32_t delivered = test_match( peer->sent, peer->sl, side[i].got, side[i].gl, 0, &bad );
+    uint8_t passed = (uint8_t) ( !failed && peer->segments == delivered && !bad && peer->segments == device->logs.n_received &&
+                                 peer->segments == reactor.device[ 1 - i ].logs.n_sent );
+
+    // The reply came with data on both sides of it, the bytes it was taken out of are all in `got`
+    if( i )
+      passed = (uint8_t) ( passed && side[i].replied && side[i].before && side[i].before < side[i].gl );
+    test_report( "reactor", i ? "a-to-b" : "b-to-a", peer->segments, delivered, bad, passed );
+  }
+
+  if( -1 == e22900t22s_reactor_close( &reactor ) || -1 == test_emulator_stop( &emu ) ){
+    perror("Stopping the emulator");
+    ++test_failures;
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+main( int argc, char ** argv ){
+  if( 2 > argc ){
+    fprintf( stderr, "Usage: %s <emulator>\n", argv[0] );
+    return EXIT_FAILURE;
+  }
+  test_link( argv[1] );
+  return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
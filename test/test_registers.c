@@ -0,0 +1,222 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      test_registers.c
+ *
+ * @version   1.0
+ *
+ * @date      17-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *
+ * @author    Fábio D. Pacheco,
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ *
+ * @note      Manuals:
+ *
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include "test.h"
+#include <e22900t22s/core.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define TEST_CONFIGS      5000              // Random configurations packed and unpacked
+#define TEST_ALL          ( ( 1 << E22900T22S_REG_BLOCK ) - 1 )
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+// Internal to e22900t22s.c, they only touch the device struct so no module is needed
+void pack_registers( const e22900t22s_eeprom_t * cfg, uint8_t * reg );
+void unpack_registers( const uint8_t * reg, e22900t22s_eeprom_t * cfg );
+int8_t dirty_range( e22900t22s_t * dev, uint8_t * image, uint8_t * first, uint8_t * length );
+int8_t temporary_range( e22900t22s_t * dev, uint8_t * image, uint8_t * first, uint8_t * length );
+
+void test_random_config( e22900t22s_eeprom_t * cfg );
+void test_confirm( e22900t22s_t * dev, const uint16_t bits );
+uint8_t test_range( int8_t ( * range )( e22900t22s_t *, uint8_t *, uint8_t *, uint8_t * ), e22900t22s_t * dev, const uint8_t first, const uint8_t length );
+void test_pack( void );
+void test_dirty( void );
+void test_temporary( void );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_random_config( e22900t22s_eeprom_t * cfg ){
+  memset( cfg, 0, sizeof(e22900t22s_eeprom_t) );
+  cfg->address = (uint16_t) test_rand( );
+  cfg->netid = (uint8_t) test_rand( );
+  cfg->baudrate = lut_baudrate[ test_rand( ) % E22900T22S_LUT_SIZE_UART ].code;
+  cfg->parity = lut_parity[ test_rand( ) % E22900T22S_LUT_SIZE_PARITY ].code;
+  cfg->airrate = lut_airrate[ test_rand( ) % E22900T22S_LUT_SIZE_AIRRATE ].code;
+  cfg->packet_size = lut_packetsize[ test_rand( ) % E22900T22S_LUT_SIZE_PACKET ].code;
+  cfg->transmit_power = lut_power[ test_rand( ) % E22900T22S_LUT_SIZE_POWER ].code;
+  cfg->ambient_noise = (uint8_t) ( test_rand( ) & 1 );
+  cfg->rssi = (uint8_t) ( test_rand( ) & 1 );
+  cfg->fixed = (uint8_t) ( test_rand( ) & 1 );
+  cfg->repeater = (uint8_t) ( test_rand( ) & 1 );
+  cfg->lbt = (uint8_t) ( test_rand( ) & 1 );
+  cfg->wor = (uint8_t) ( test_rand( ) & 1 );
+  cfg->wor_cycle = lut_worcycle[ test_rand( ) % E22900T22S_LUT_SIZE_WORCYCLE ].code;
+  cfg->channel = (uint8_t) test_rand( );
+  cfg->encryption = (uint16_t) test_rand( );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_confirm( e22900t22s_t * dev, const uint16_t bits ){
+  // What the echo of a persistent write leaves in the shadow, the registers hold the values just written
+  uint8_t image[ E22900T22S_REG_BLOCK ];
+  pack_registers( &dev->cfg, image );
+  for( uint8_t i = 0 ; i < E22900T22S_REG_BLOCK ; ++i ){
+    if( !( bits >> i & 1 ) )
+      continue;
+    dev->shadow.reg[i] = image[i];
+    dev->shadow.known |= (uint16_t) ( 1 << i );
+    dev->shadow.dirty &= (uint16_t) ~( 1 << i );
+    dev->shadow.temporary &= (uint16_t) ~( 1 << i );
+  }
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t
+test_range( int8_t ( * range )( e22900t22s_t *, uint8_t *, uint8_t *, uint8_t * ), e22900t22s_t * dev, const uint8_t first, const uint8_t length ){
+  uint8_t image[ E22900T22S_REG_BLOCK ], at = 0xFF, len = 0xFF;
+  int8_t ret = range( dev, image, &at, &len );
+  if( !length )
+    return (uint8_t) ( !ret && !len );
+  return (uint8_t) ( 1 == ret && first == at && length == len );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_pack( void ){
+  // Every field survives the registers, the key is write only and never comes back
+  uint32_t matched = 0;
+  for( uint32_t k = 0 ; k < TEST_CONFIGS ; ++k ){
+    e22900t22s_eeprom_t cfg, back;
+    uint8_t reg[ E22900T22S_REG_BLOCK ], again[ E22900T22S_REG_BLOCK ];
+    test_random_config( &cfg );
+    pack_registers( &cfg, reg );
+    memset( &back, 0, sizeof(back) );
+    unpack_registers( reg, &back );
+    back.encryption = cfg.encryption;
+    pack_registers( &back, again );
+    matched += !memcmp( &cfg, &back, sizeof(cfg) ) && !memcmp( reg, again, sizeof(reg) ) &&
+               reg[ E22900T22S_MEM_CRYPTH ] == cfg.encryption >> 8 && reg[ E22900T22S_MEM_CRYPTL ] == ( cfg.encryption & 0xFF );
+  }
+  test_report( "registers", "pack", TEST_CONFIGS, matched, TEST_CONFIGS - matched, (uint8_t) ( TEST_CONFIGS == matched ) );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_dirty( void ){
+  static e22900t22s_t dev;
+  uint32_t checks = 0, passed = 0;
+  memset( &dev, 0, sizeof(dev) );
+  test_random_config( &dev.cfg );
+
+  // Nothing was ever confirmed by the module, the whole block is written
+  passed += test_range( dirty_range, &dev, 0, E22900T22S_REG_BLOCK ), ++checks;
+  test_confirm( &dev, TEST_ALL );
+  passed += test_range( dirty_range, &dev, 0, 0 ), ++checks;
+
+  // A single field only writes the register it is packed into
+  e22900t22s_set_channel( (uint8_t) ( dev.cfg.channel + 1 ), &dev );
+  passed += test_range( dirty_range, &dev, E22900T22S_MEM_REG2, 1 ), ++checks;
+  test_confirm( &dev, 1 << E22900T22S_MEM_REG2 );
+
+  // A setter storing the value the module already holds marks the register, and the comparison with the shadow drops it
+  e22900t22s_set_channel( dev.cfg.channel, &dev );
+  e22900t22s_set_network_identification( dev.cfg.netid, &dev );
+  passed += test_range( dirty_range, &dev, 0, 0 ), ++checks;
+  passed += !dev.shadow.dirty, ++checks;
+
+  // The address and the RSSI byte are apart, the write covers everything in between in one frame
+  e22900t22s_set_address_identification( (uint16_t) ( dev.cfg.address ^ 0x0101 ), &dev );
+  e22900t22s_set_rssi( (uint8_t) !dev.cfg.rssi, &dev );
+  passed += test_range( dirty_range, &dev, E22900T22S_MEM_ADDH, E22900T22S_MEM_REG3 - E22900T22S_MEM_ADDH + 1 ), ++checks;
+
+  // Only the low address byte changes, the range starts there
+  test_confirm( &dev, TEST_ALL );
+  e22900t22s_set_address_identification( (uint16_t) ( dev.cfg.address ^ 0x0001 ), &dev );
+  passed += test_range( dirty_range, &dev, E22900T22S_MEM_ADDL, 1 ), ++checks;
+
+  // The echo of the write confirms the registers, the next update writes nothing and reads nothing back
+  test_confirm( &dev, 1 << E22900T22S_MEM_ADDL );
+  passed += test_range( dirty_range, &dev, 0, 0 ), ++checks;
+
+  // A register the module never confirmed is written even if no setter touched it
+  dev.shadow.known &= (uint16_t) ~( 1 << E22900T22S_MEM_CRYPTL );
+  passed += test_range( dirty_range, &dev, E22900T22S_MEM_CRYPTL, 1 ), ++checks;
+
+  test_report( "registers", "dirty", checks, passed, checks - passed, (uint8_t) ( checks == passed ) );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_temporary( void ){
+  static e22900t22s_t dev;
+  uint32_t checks = 0, passed = 0;
+  memset( &dev, 0, sizeof(dev) );
+  test_random_config( &dev.cfg );
+  test_confirm( &dev, TEST_ALL );
+
+  // The key cannot be read back, a volatile write leaves it out
+  passed += test_range( temporary_range, &dev, 0, 0 ), ++checks;
+  e22900t22s_set_encryption_key( (uint16_t) ( dev.cfg.encryption + 1 ), &dev );
+  passed += test_range( temporary_range, &dev, 0, 0 ), ++checks;
+
+  // A new air rate is only REG0
+  baudRate_t eeprom = dev.cfg.airrate, airrate = eeprom;
+  for( uint8_t i = 0 ; i < E22900T22S_LUT_SIZE_AIRRATE && airrate == dev.cfg.airrate ; ++i )
+    airrate = lut_airrate[i].code;
+  e22900t22s_set_airrate( airrate, &dev );
+  passed += test_range( temporary_range, &dev, E22900T22S_MEM_REG0, 1 ), ++checks;
+
+  // The echo of the volatile write, the module runs the new value and the EEPROM keeps the old one
+  uint8_t image[ E22900T22S_REG_BLOCK ];
+  pack_registers( &dev.cfg, image );
+  dev.shadow.running[ E22900T22S_MEM_REG0 ] = image[ E22900T22S_MEM_REG0 ];
+  dev.shadow.temporary |= 1 << E22900T22S_MEM_REG0;
+  passed += test_range( temporary_range, &dev, 0, 0 ), ++checks;
+
+  // Going back to the EEPROM value differs from what runs, and a second register widens the range over the ones between
+  e22900t22s_set_airrate( eeprom, &dev );
+  e22900t22s_set_rssi( (uint8_t) !dev.cfg.rssi, &dev );
+  passed += test_range( temporary_range, &dev, E22900T22S_MEM_REG0, E22900T22S_MEM_REG3 - E22900T22S_MEM_REG0 + 1 ), ++checks;
+
+  test_report( "registers", "temporary", checks, passed, checks - passed, (uint8_t) ( checks == passed ) );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+main( void ){
+  test_pack( );
+  test_dirty( );
+  test_temporary( );
+  return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
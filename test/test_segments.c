@@ -0,0 +1,225 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      test_segments.c
+ *
+ * @version   1.0
+ *
+ * @date      17-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *
+ * @author    Fábio D. Pacheco,
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ *
+ * @note      Manuals:
+ *
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include "test.h"
+#include <e22900t22s/mixip.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define TEST_CALLS        20000             // Buffers scanned per random case
+#define TEST_BUFFER       4096              // Longest buffer scanned at once (B)
+
+// The limiters are searched by the vector path the driver is built for, the same test runs on every target
+#if defined(__AVX2__)
+#define TEST_PATH         "avx2"
+#elif defined(__SSE2__)
+#define TEST_PATH         "sse2"
+#elif defined(__ARM_NEON)
+#define TEST_PATH         "neon"
+#else
+#define TEST_PATH         "scalar"
+#endif
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Types
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef struct{
+  size_t  end[ TEST_BUFFER ];
+  size_t  length;
+  uint8_t count;
+  uint8_t first;
+} test_reference_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+static uint8_t data[ TEST_BUFFER ];
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+void test_reference( test_reference_t * ref, const uint8_t * buf, const size_t len );
+uint8_t test_compare( e22900t22s_mixip_segments_t * st, test_reference_t * ref, const uint8_t * buf, const size_t len );
+void test_random( const char * label, const uint32_t zeros, const size_t longest );
+void test_boundaries( void );
+void test_first( void );
+void test_growth( void );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_reference( test_reference_t * ref, const uint8_t * buf, const size_t len ){
+  // One byte at a time, every second limiter closes a segment, the one left unpaired is carried to the next buffer
+  ref->length = 0;
+  for( size_t i = 0 ; i < len ; ++i ){
+    if( buf[i] )
+      continue;
+    if( 1 == ref->count ){
+      ref->end[ ref->length++ ] = i;
+      ref->count = 0;
+    }
+    else
+      ++ref->count;
+  }
+  ref->first = (uint8_t) ( ref->length && ref->end[ ref->length - 1 ] + 1 == len );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+uint8_t
+test_compare( e22900t22s_mixip_segments_t * st, test_reference_t * ref, const uint8_t * buf, const size_t len ){
+  test_reference( ref, buf, len );
+  if( -1 == e22900t22s_identify_segments( buf, len, st ) ){
+    perror("e22900t22s_identify_segments");
+    return 0;
+  }
+  if( st->length != ref->length || st->count != ref->count || st->first != ref->first || st->length > st->capacity )
+    return 0;
+  for( size_t k = 0 ; k < ref->length ; ++k )
+    if( st->segment[k].end != ref->end[k] )
+      return 0;
+  return 1;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_random( const char * label, const uint32_t zeros, const size_t longest ){
+  // One zero every `zeros` bytes on average, the limiter left open by a buffer is paired in the next one
+  static test_reference_t ref;
+  e22900t22s_mixip_segments_t st;
+  memset( &st, 0, sizeof(st) );
+  memset( &ref, 0, sizeof(ref) );
+
+  uint32_t matched = 0;
+  for( uint32_t k = 0 ; k < TEST_CALLS ; ++k ){
+    size_t len = test_rand( ) % ( longest + 1 );
+    for( size_t i = 0 ; i < len ; ++i )
+      data[i] = test_rand( ) % zeros ? (uint8_t) ( 1 + test_rand( ) % 255 ) : 0x00;
+    matched += test_compare( &st, &ref, data + k % 32, len > k % 32 ? len - k % 32 : 0 );
+  }
+  e22900t22s_free_segments( &st );
+
+  char name[64];
+  snprintf( name, sizeof(name), "%s-%s", TEST_PATH, label );
+  test_report( "segments", name, TEST_CALLS, matched, TEST_CALLS - matched, (uint8_t) ( TEST_CALLS == matched ) );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_boundaries( void ){
+  // A pair of limiters around every 16 and 32 byte lane, the buffer cut before, between and after them, then buffers made only of limiters
+  static test_reference_t ref;
+  e22900t22s_mixip_segments_t st;
+  memset( &st, 0, sizeof(st) );
+  memset( &ref, 0, sizeof(ref) );
+
+  uint32_t calls = 0, matched = 0;
+  for( size_t lane = 16 ; lane <= 128 ; lane += 16 ){
+    for( size_t len = lane - 1 ; len <= lane + 1 ; ++len ){
+      memset( data, 0x41, len + 2 );
+      data[ lane - 1 ] = data[ lane ] = 0x00;
+      data[ 0 ] = 0x00;
+      matched += test_compare( &st, &ref, data, len );
+      ++calls;
+    }
+  }
+
+  memset( data, 0x00, 96 );
+  for( size_t len = 0 ; len <= 96 ; ++len, ++calls )
+    matched += test_compare( &st, &ref, data, len );
+  e22900t22s_free_segments( &st );
+  test_report( "segments", TEST_PATH "-boundaries", calls, matched, calls - matched, (uint8_t) ( calls == matched ) );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_first( void ){
+  // The EOF as the last byte raises `first`, one byte after it does not, and the SOF left open is paired by the next buffer
+  e22900t22s_mixip_segments_t st;
+  memset( &st, 0, sizeof(st) );
+  const uint8_t closed[] = { 0x00, 0x41, 0x42, 0x00 };
+  const uint8_t rssi[] = { 0x00, 0x41, 0x42, 0x00, 0x55 };
+  const uint8_t opened[] = { 0x55, 0x00, 0x41 };
+  const uint8_t closing[] = { 0x42, 0x43, 0x00 };
+
+  uint8_t passed = 1;
+  passed &= (uint8_t) ( !e22900t22s_identify_segments( closed, sizeof(closed), &st ) && 1 == st.length && 3 == st.segment[0].end && st.first && !st.count );
+  passed &= (uint8_t) ( !e22900t22s_identify_segments( rssi, sizeof(rssi), &st ) && 1 == st.length && !st.first && !st.count );
+  passed &= (uint8_t) ( !e22900t22s_identify_segments( opened, sizeof(opened), &st ) && !st.length && !st.first && 1 == st.count );
+  passed &= (uint8_t) ( !e22900t22s_identify_segments( closing, sizeof(closing), &st ) && 1 == st.length && 2 == st.segment[0].end && st.first && !st.count );
+  e22900t22s_free_segments( &st );
+  test_report( "segments", TEST_PATH "-first", 4, passed ? 4 : 0, passed ? 0 : 1, passed );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_growth( void ){
+  // From a zero initialized struct the array starts at NSEG_MAX entries and doubles, every segment of a buffer must fit at once
+  static test_reference_t ref;
+  e22900t22s_mixip_segments_t st;
+  memset( &st, 0, sizeof(st) );
+  memset( &ref, 0, sizeof(ref) );
+  memset( data, 0x00, sizeof(data) );
+
+  uint32_t calls = 0, matched = 0;
+  size_t capacity = 0;
+  uint8_t grew = 1;
+  for( size_t len = 1 ; len <= TEST_BUFFER ; len *= 2, ++calls ){
+    matched += test_compare( &st, &ref, data, len );
+    grew = (uint8_t) ( grew && st.capacity >= capacity && ( !st.capacity || !( st.capacity % NSEG_MAX ) ) );
+    capacity = st.capacity;
+  }
+  uint8_t passed = (uint8_t) ( calls == matched && grew && capacity > NSEG_MAX );
+  e22900t22s_free_segments( &st );
+  test_report( "segments", TEST_PATH "-growth", calls, matched, calls - matched, passed );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+main( void ){
+  test_random( "sparse", 40, 300 );
+  test_random( "dense", 3, 300 );
+  test_random( "long", 20, TEST_BUFFER - 32 );
+  test_boundaries( );
+  test_first( );
+  test_growth( );
+  return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
@@ -0,0 +1,371 @@
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Introduction
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/**********************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************//**
+ * @file      test_stages.c
+ *
+ * @version   1.0
+ *
+ * @date      17-10-2026
+ *
+ * @brief     LoRa E-Byte E22-900T2SS transceiver driver
+ *
+ * @author    Fábio D. Pacheco,
+ * @email     fabio.d.pacheco@inesctec.pt or pacheco.castro.fabio@gmail.com
+ *
+ * @copyright Copyright (c) [2025] [Fábio D. Pacheco]
+ *
+ * @note      Manuals:
+ *
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Imported libraries
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#include "test.h"
+#include <e22900t22s/core.h>
+#include <e22900t22s/crc.h>
+#include <e22900t22s/codec.h>
+#include <e22900t22s/rohc.h>
+#include <e22900t22s/fec.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Definitions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+#define TEST_SEGMENTS     3000              // Segments written per case
+#define TEST_BUFFER       ( 1 << 21 )       // Bytes of the sent, received and air streams
+#define TEST_STAGE        65536             // Bytes out of each stage per call
+#define TEST_WRITE        700               // Largest write, the writes are split at random below it
+#define TEST_READ         300               // Largest read, the air hands the bytes in random pieces below it
+#define TEST_TICK         1000000ULL        // Time between two reads (ns)
+#define TEST_BLOCK        8                 // FEC sources per block
+#define TEST_REPAIRS      2                 // FEC repairs per block
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Types
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+typedef enum{
+  TEST_CRC   = 1,
+  TEST_CODEC = 2,
+  TEST_ROHC  = 4,
+  TEST_FEC   = 8,
+  TEST_CHAIN = TEST_CRC | TEST_CODEC | TEST_ROHC | TEST_FEC,
+} test_stages_t;
+
+typedef struct{
+  e22900t22s_crc_state_t crc;
+  e22900t22s_codec_t     codec;
+  e22900t22s_rohc_t      rohc;
+  e22900t22s_fec_t       fec;
+} test_link_t;
+
+typedef struct{
+  const char * name;
+  const char * label;
+  uint8_t  stages;                                  // Stages the segments go through, see test_stages_t
+  uint8_t  rssi;                                    // The module appends the RSSI byte after every EOF
+  uint32_t flips;                                   // One bit inverted every `flips` bytes on average, 0 for none
+  uint32_t zeros;                                   // One limiter made up every `zeros` bytes on average, 0 for none
+  uint32_t drop;                                    // Every `drop`-th segment is lost on the air, 0 for none
+  uint8_t  whole;                                   // Every segment written must be read back
+} test_case_t;
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Global variables
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+static uint8_t sent[ TEST_BUFFER ];
+static uint8_t air[ TEST_BUFFER ];
+static uint8_t got[ TEST_BUFFER ];
+
+static const test_case_t cases[] = {
+  { "crc",   "split",        TEST_CRC,   0, 0,    0,    0,  1 },
+  { "crc",   "split-rssi",   TEST_CRC,   1, 0,    0,    0,  1 },
+  { "crc",   "corrupt",      TEST_CRC,   1, 2000, 8000, 0,  0 },
+  { "crc",   "drop",         TEST_CRC,   1, 0,    0,    7,  0 },
+  { "codec", "split",        TEST_CODEC, 0, 0,    0,    0,  1 },
+  { "codec", "split-rssi",   TEST_CODEC, 1, 0,    0,    0,  1 },
+  { "rohc",  "split",        TEST_ROHC,  0, 0,    0,    0,  1 },
+  { "rohc",  "split-rssi",   TEST_ROHC,  1, 0,    0,    0,  1 },
+  { "fec",   "split",        TEST_FEC,   0, 0,    0,    0,  1 },
+  { "fec",   "split-rssi",   TEST_FEC,   1, 0,    0,    0,  1 },
+  { "fec",   "drop",         TEST_FEC,   1, 0,    0,    10, 1 },
+  { "chain", "split",        TEST_CHAIN, 0, 0,    0,    0,  1 },
+  { "chain", "split-rssi",   TEST_CHAIN, 1, 0,    0,    0,  1 },
+  { "chain", "drop",         TEST_CHAIN, 1, 0,    0,    10, 1 },
+  { "chain", "corrupt",      TEST_CHAIN, 0, 2000, 8000, 0,  0 },
+  { "chain", "corrupt-rssi", TEST_CHAIN, 1, 2000, 8000, 0,  0 },
+};
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Prototypes
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+int8_t test_link_init( test_link_t * link, const uint8_t stages );
+size_t test_send( test_link_t * link, const uint8_t stages, const uint8_t * data, const size_t len, const uint8_t flush, uint8_t * out );
+size_t test_receive( test_link_t * link, const uint8_t stages, const uint8_t * data, const size_t len, const uint8_t rssi, const uint64_t now, uint8_t * out );
+void test_case( const test_case_t * tc );
+void test_fec_deadline( void );
+void test_crc32c( void );
+void test_fec_gf256( void );
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * Functions
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int8_t
+test_link_init( test_link_t * link, const uint8_t stages ){
+  e22900t22s_eeprom_t cfg;
+  memset( link, 0, sizeof(test_link_t) );
+  memset( &cfg, 0, sizeof(cfg) );
+  cfg.airrate = B9600;
+
+  e22900t22s_codec_init( &link->codec );
+  e22900t22s_rohc_init( &link->rohc );
+  if( stages & TEST_FEC ){
+    if( -1 == e22900t22s_fec_init( &link->fec, TEST_BLOCK, TEST_REPAIRS ) )
+      return -1;
+    e22900t22s_fec_tune( &link->fec, &cfg );
+  }
+  return 0;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+test_send( test_link_t * link, const uint8_t stages, const uint8_t * data, const size_t len, const uint8_t flush, uint8_t * out ){
+  static uint8_t a[ TEST_STAGE ], b[ TEST_STAGE ];
+  size_t length = len;
+
+  // Same order as `dwrite`: rohc, codec, fec, crc
+  memcpy( a, data, len );
+  if( stages & TEST_ROHC ){
+    length = e22900t22s_rohc_pack( &link->rohc, a, length, b, TEST_STAGE );
+    memcpy( a, b, length );
+  }
+  if( stages & TEST_CODEC ){
+    length = e22900t22s_codec_pack( &link->codec, a, length, b, TEST_STAGE );
+    memcpy( a, b, length );
+  }
+  if( stages & TEST_FEC ){
+    length = e22900t22s_fec_pack( &link->fec, a, length, flush, b, TEST_STAGE );
+    memcpy( a, b, length );
+  }
+  if( stages & TEST_CRC ){
+    length = e22900t22s_crc_seal( &link->crc, a, length, b, TEST_STAGE );
+    memcpy( a, b, length );
+  }
+
+  memcpy( out, a, length );
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+size_t
+test_receive( test_link_t * link, const uint8_t stages, const uint8_t * data, const size_t len, const uint8_t rssi, const uint64_t now, uint8_t * out ){
+  static uint8_t a[ TEST_STAGE ], b[ TEST_STAGE ];
+  size_t length = len;
+
+  // Same order as `dread`: crc, fec, codec, rohc
+  memcpy( a, data, len );
+  if( stages & TEST_CRC ){
+    length = e22900t22s_crc_verify( &link->crc, a, length, rssi, b, TEST_STAGE );
+    memcpy( a, b, length );
+  }
+  if( stages & TEST_FEC ){
+    length = e22900t22s_fec_unpack( &link->fec, a, length, rssi, now, b, TEST_STAGE );
+    memcpy( a, b, length );
+  }
+  if( stages & TEST_CODEC ){
+    length = e22900t22s_codec_unpack( &link->codec, a, length, rssi, b, TEST_STAGE );
+    memcpy( a, b, length );
+  }
+  if( stages & TEST_ROHC ){
+    length = e22900t22s_rohc_unpack( &link->rohc, a, length, rssi, b, TEST_STAGE );
+    memcpy( a, b, length );
+  }
+
+  memcpy( out, a, length );
+  return length;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_case( const test_case_t * tc ){
+  static test_link_t tx, rx;
+  static uint8_t wire[ TEST_STAGE ];
+  if( -1 == test_link_init( &tx, tc->stages ) || -1 == test_link_init( &rx, tc->stages ) ){
+    perror("test_link_init");
+    ++test_failures;
+    return;
+  }
+
+  size_t sl = test_stream( sent, sizeof(sent), TEST_SEGMENTS );
+
+  // The writes are split at random, the module appends the RSSI byte after every EOF and the air damages what it carries
+  size_t al = 0, start = 0;
+  uint8_t inside = 0;
+  uint32_t count = 0;
+  for( size_t i = 0 ; i < sl ; ){
+    size_t n = 1 + test_rand( ) % TEST_WRITE;
+    if( n > sl - i )
+      n = sl - i;
+
+    size_t wl = test_send( &tx, tc->stages, sent + i, n, (uint8_t) ( i + n == sl ), wire );
+    for( size_t j = 0 ; j < wl ; ++j ){
+      if( !inside && 0x00 == wire[j] )
+        start = al;
+      if( tc->zeros && !( test_rand( ) % tc->zeros ) )
+        air[al++] = 0x00;
+      air[al++] = tc->flips && !( test_rand( ) % tc->flips ) ? (uint8_t) ( wire[j] ^ ( 1 << test_rand( ) % 8 ) ) : wire[j];
+      if( 0x00 != wire[j] )
+        continue;
+
+      inside = (uint8_t) !inside;
+      if( inside )
+        continue;
+      if( tc->rssi )
+        air[al++] = TEST_RSSI;
+      if( tc->drop && !( ++count % tc->drop ) )
+        al = start;
+    }
+    i += n;
+  }
+
+  // The reads take the air in random pieces, a final one past every deadline hands what is still held
+  size_t gl = 0;
+  uint64_t now = 1;
+  for( size_t i = 0 ; i < al ; ){
+    size_t n = 1 + test_rand( ) % TEST_READ;
+    if( n > al - i )
+      n = al - i;
+    gl += test_receive( &rx, tc->stages, air + i, n, tc->rssi, now, got + gl );
+    now += TEST_TICK;
+    i += n;
+  }
+  gl += test_receive( &rx, tc->stages, air, 0, tc->rssi, now + rx.fec.hold + 1, got + gl );
+
+  uint32_t bad;
+  uint32_t delivered = test_match( sent, sl, got, gl, tc->rssi, &bad );
+  uint8_t passed = (uint8_t) ( !bad && ( !tc->whole || TEST_SEGMENTS == delivered ) );
+  test_report( tc->name, tc->label, TEST_SEGMENTS, delivered, bad, passed );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_fec_deadline( void ){
+  static test_link_t tx, rx;
+  static uint8_t wire[ TEST_STAGE ], kept[ TEST_STAGE ];
+  uint8_t data[64];
+  size_t dl = 0;
+  if( -1 == test_link_init( &tx, TEST_FEC ) || -1 == test_link_init( &rx, TEST_FEC ) ){
+    perror("test_link_init");
+    ++test_failures;
+    return;
+  }
+
+  for( uint8_t k = 0 ; k < 4 ; ++k ){
+    data[dl++] = 0x00;
+    memset( data + dl, 0x10 + k, 5 );
+    dl += 5;
+    data[dl++] = 0x00;
+  }
+
+  // The first source and every repair are lost, the block cannot be recovered and the later sources wait behind the gap
+  size_t wl = test_send( &tx, TEST_FEC, data, dl, 1, wire ), kl = 0;
+  uint32_t index = 0;
+  for( size_t i = 0 ; i < wl ; ++index ){
+    size_t end = i + 1;
+    while( wire[end] )
+      ++end;
+    if( index && !( wire[i + 2] & 0x80 ) ){
+      memcpy( kept + kl, wire + i, end - i + 1 );
+      kl += end - i + 1;
+    }
+    i = end + 1;
+  }
+
+  size_t before = test_receive( &rx, TEST_FEC, kept, kl, 0, 1000, got );
+  size_t held = test_receive( &rx, TEST_FEC, kept, 0, 0, 1000 + rx.fec.hold / 2, got );
+  size_t gl = test_receive( &rx, TEST_FEC, kept, 0, 0, 1000 + rx.fec.hold + 1, got );
+
+  uint32_t bad;
+  uint32_t delivered = test_match( data, dl, got, gl, 0, &bad );
+  uint8_t passed = (uint8_t) ( !before && !held && !bad && 3 == delivered && 1 == rx.fec.lost );
+  test_report( "fec", "deadline", 4, delivered, bad, passed );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_crc32c( void ){
+  // Whichever instructions the CPU has, they must agree with the tables on every length and alignment
+  uint32_t checked = 0, bad = 0;
+  for( uint32_t k = 0 ; k < 20000 ; ++k ){
+    size_t offset = test_rand( ) % 8;
+    size_t len = k < 64 ? k : test_rand( ) % 4096;
+    for( size_t i = 0 ; i < len ; ++i )
+      sent[ offset + i ] = (uint8_t) test_rand( );
+    bad += e22900t22s_crc32c( sent + offset, len ) != e22900t22s_crc32c_sliced( sent + offset, len );
+    ++checked;
+  }
+
+  const uint8_t check[] = "123456789";
+  bad += 0xE3069283U != e22900t22s_crc32c( check, 9 ) || 0xE3069283U != e22900t22s_crc32c_sliced( check, 9 );
+  test_report( "crc", "crc32c", checked, checked - bad, bad, (uint8_t) !bad );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+void
+test_fec_gf256( void ){
+  // Every constant times every byte, from an offset so the vector loads are unaligned and the last bytes take the scalar loop
+  uint8_t src[ 256 + 32 ], wide[ 256 + 32 ], narrow[ 256 + 32 ];
+  uint32_t bad = 0;
+  for( uint16_t c = 0 ; c < 256 ; ++c ){
+    size_t offset = c % 16, len = 256 + c % 17;
+    for( size_t i = 0 ; i < len ; ++i ){
+      src[ offset + i ] = (uint8_t) ( i + c );
+      wide[ offset + i ] = narrow[ offset + i ] = (uint8_t) test_rand( );
+    }
+    e22900t22s_fec_mul_add( wide + offset, src + offset, (uint8_t) c, len );
+    e22900t22s_fec_mul_add_narrow( narrow + offset, src + offset, (uint8_t) c, len );
+    uint8_t agreed = (uint8_t) !memcmp( wide + offset, narrow + offset, len );
+
+    // The nibble tables against the product done bit by bit, modulo x^8 + x^4 + x^3 + x^2 + 1
+    for( uint16_t x = 0 ; x < 256 ; ++x ){
+      uint8_t a = (uint8_t) c, b = (uint8_t) x, product = 0, byte = (uint8_t) x, sum = 0;
+      for( uint8_t bit = 0 ; bit < 8 ; ++bit ){
+        if( b & 1 )
+          product ^= a;
+        b >>= 1;
+        a = (uint8_t) ( a & 0x80 ? ( a << 1 ) ^ 0x1D : a << 1 );
+      }
+      e22900t22s_fec_mul_add_narrow( &sum, &byte, (uint8_t) c, 1 );
+      agreed = (uint8_t) ( agreed && sum == product );
+    }
+    bad += !agreed;
+  }
+  test_report( "fec", "gf256", 256, 256 - bad, bad, (uint8_t) !bad );
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/
+int
+main( void ){
+  for( size_t i = 0 ; i < sizeof(cases) / sizeof(cases[0]) ; ++i )
+    test_case( &cases[i] );
+  test_fec_deadline( );
+  test_crc32c( );
+  test_fec_gf256( );
+  return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/***************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************
+ * End file
+ **************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************************/